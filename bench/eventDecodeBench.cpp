@@ -0,0 +1,223 @@
+/*********************************************************************
+ *
+ * File: eventDecodeBench.cpp
+ *
+ * Description:  Per event cost of the interface state & route events
+ *               by the number of attributes the handler reads. Each
+ *               event is posted from the raw message the event loop
+ *               gets to the handler callback, the handler reading the
+ *               first 0, 1, 2, 4 (or) all of the attributes of the
+ *               event. The cost of an interface event reading them all
+ *               through NxIntf::snapshot() is measured for comparison.
+ *
+ *               Usage: eventDecodeBench [eventCount]
+ *
+ *               Built against the stub library sources, run with
+ *               "make bench".
+ *
+ * Copyright (c) 2018 by cisco Systems, Inc.
+ * All rights reserved.
+ *
+ *********************************************************************
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <time.h>
+#include "nx_intf_mgr_impl.h"
+#include "nx_rib_mgr_impl.h"
+
+using namespace nxos;
+
+#define INTF_COUNT      4096
+#define ROUTE_COUNT     16384
+#define ALL_FIELDS      100
+
+static const char *intfNames[] = { "Ethernet1/1", "Ethernet1/2",
+                                   "Ethernet1/3", "Ethernet1/4",
+                                   "Ethernet1/5", "Ethernet1/6",
+                                   "Ethernet1/7", "Ethernet1/8" };
+
+static inline uint64_t nowNs()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + ts.tv_nsec;
+}
+
+/* Reads the first fields attributes of each event, sums their sizes so
+ * the reads are not optimized out. */
+class ReadIntfHandler : public NxIntfMgrHandler {
+public:
+    unsigned int fields;
+    bool         snap;
+    size_t       sum;
+
+    ReadIntfHandler() : fields(0), snap(false), sum(0) {}
+    bool postIntfStateCb(NxIntf *intf) {
+        NxIntfSnapshot s;
+        unsigned int   n = fields;
+
+        if (snap) {
+            sum += intf->snapshot(&s) + s.operState;
+            return true;
+        }
+        if (n > 0) sum += intf->getName().size();
+        if (n > 1) sum += intf->getOperState();
+        if (n > 2) sum += intf->getAdminState();
+        if (n > 3) sum += intf->getVrf().size();
+        if (n > 4) sum += intf->getLayer().size();
+        if (n > 5) sum += intf->getDescription().size();
+        if (n > 6) sum += intf->getL3PrAddr(AF_IPV4).size();
+        if (n > 7) sum += intf->getL2Address().size();
+        if (n > 8) sum += intf->getMtu() + intf->getSpeed();
+        if (n > 9) sum += intf->getMemberCount();
+        return true;
+    }
+};
+
+class ReadRibHandler : public NxRibMgrHandler {
+public:
+    unsigned int fields;
+    size_t       sum;
+
+    ReadRibHandler() : fields(0), sum(0) {}
+    bool postL3RouteCb(NxL3Route *route) {
+        NxL3NextHop  *nh;
+        unsigned int  n = fields;
+
+        if (n > 0) sum += route->getPrefix().maskLen;
+        if (n > 1) sum += route->getEvent();
+        if (n > 2) sum += route->getL3NextHopCount();
+        if (n > 3) sum += route->getVrfName().size();
+        if (n <= 4) return true;
+        sum += route->getAddress().size();
+        for (nh = route->getL3NextHop(true); nh;
+             nh = route->getL3NextHop()) {
+            sum += nh->getAddress().size() + nh->getOutInterface().size() +
+                   nh->getVrfName().size() + nh->getOwner().size() +
+                   nh->getPreference() + nh->getMetric();
+        }
+        return true;
+    }
+};
+
+static void runIntf(unsigned int count, unsigned int fields, bool snap)
+{
+    NxIntfMgrImpl             intfMgr;
+    ReadIntfHandler           handler;
+    std::vector<uint32_t>     ifindexes(INTF_COUNT);
+    char                      name[64];
+    uint64_t                  start, ns;
+
+    for (unsigned int i = 0; i < INTF_COUNT; i++) {
+        NxIntf *intf;
+
+        snprintf(name, sizeof(name), "Ethernet%u/%u", (i / 64) + 1,
+                 (i % 64) + 1);
+        intf = intfMgr.addIntf(name);
+        intf->setLayer("Layer3");
+        intf->setVrf("tenant-1");
+        intf->setDescription("to server rack");
+        intf->setL2Address("0011.2233.4455");
+        intf->setL3Address("10.1.1.1/31", AF_IPV4, true);
+        intf->setMtu(9216);
+        ifindexes[i] = intf->getIfindex();
+    }
+    handler.fields = fields;
+    handler.snap   = snap;
+    intfMgr.setIntfHandler(&handler);
+
+    start = nowNs();
+    for (unsigned int i = 0; i < count; i++) {
+        intfMgr.postIntfStateMsg(ifindexes[i % INTF_COUNT],
+                                 ((i / INTF_COUNT) & 1) ? UP : DOWN, 1);
+    }
+    ns = nowNs() - start;
+
+    if (snap) {
+        printf("intf state   snapshot    ns/event %8.1f\n",
+               (double)ns / count);
+    } else if (fields == ALL_FIELDS) {
+        printf("intf state   all fields  ns/event %8.1f\n",
+               (double)ns / count);
+    } else {
+        printf("intf state   %2u fields   ns/event %8.1f\n", fields,
+               (double)ns / count);
+    }
+}
+
+/* ROUTE_COUNT /24 BGP routes with 2 of 8 next-hops, updated with a new
+ * metric every pass over them. */
+static void runRoute(unsigned int count, unsigned int fields)
+{
+    NxRibMgrImpl                 ribMgr;
+    ReadRibHandler               handler;
+    std::vector<NxL3RouteMsgNh>  nhs(2);
+    NxL3RouteMsg                 msg;
+    uint64_t                     start, ns;
+
+    memset(&msg, 0, sizeof(msg));
+    memset(&nhs[0], 0, 2 * sizeof(NxL3RouteMsgNh));
+    msg.prefix.ip.af   = AF_IPV4;
+    msg.prefix.maskLen = 24;
+    msg.vrfName        = "default";
+    msg.protocol       = "bgp";
+    msg.tag            = "100";
+    msg.nextHops       = &nhs[0];
+    msg.nhCount        = 2;
+
+    handler.fields = fields;
+    ribMgr.setRibMgrHandler(&handler);
+    ribMgr.watchL3Route("bgp", "100", "default", AF_IPV4);
+
+    start = nowNs();
+    for (unsigned int i = 0; i < count; i++) {
+        unsigned int r = i % ROUTE_COUNT;
+
+        msg.prefix.ip.addr[0] = 10 + (r >> 16);
+        msg.prefix.ip.addr[1] = (r >> 8) & 0xff;
+        msg.prefix.ip.addr[2] = r & 0xff;
+        msg.event             = (i < ROUTE_COUNT) ? ADD : UPDATE;
+        for (int n = 0; n < 2; n++) {
+            nhs[n].ip.af      = AF_IPV4;
+            nhs[n].ip.addr[0] = 192;
+            nhs[n].ip.addr[3] = 1 + ((r + n) % 8);
+            nhs[n].intfName   = intfNames[(r + n) % 8];
+            nhs[n].preference = 20;
+            nhs[n].metric     = (i / ROUTE_COUNT) % 4;
+            nhs[n].type       = NxL3NextHop::ATTACHED;
+        }
+        ribMgr.postL3RouteMsg(msg);
+    }
+    ns = nowNs() - start;
+
+    if (fields == ALL_FIELDS) {
+        printf("l3 route     all fields  ns/event %8.1f\n",
+               (double)ns / count);
+    } else {
+        printf("l3 route     %2u fields   ns/event %8.1f\n", fields,
+               (double)ns / count);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    unsigned int count = (argc > 1) ? atoi(argv[1]) : 1000000;
+    unsigned int fields[] = { 0, 1, 2, 4, ALL_FIELDS };
+
+    if (!count) return 0;
+
+    for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+        runIntf(count, fields[i], false);
+    }
+    runIntf(count, 0, true);
+    for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+        runRoute(count, fields[i]);
+    }
+    return 0;
+}
@@ -0,0 +1,219 @@
+/*********************************************************************
+ *
+ * File: intfStoreBench.cpp
+ *
+ * Description:  Memory footprint of NxIntfMgr with a breakout heavy
+ *               chassis, 64k interfaces by default: breakout Ethernet
+ *               ports, subinterfaces, SVIs & port-channels, each with a
+ *               layer, VRF, description, MAC & primary address. Reports
+ *               the bytes per interface of the interface table & of the
+ *               process (RSS), the share of the Low priority cgroup
+ *               memory (768M) it takes & the add/getIntf latency. The
+ *               same state held as one object of std::string members
+ *               per interface is measured for comparison.
+ *
+ *               Usage: intfStoreBench [intfCount]
+ *               Exits with 1 if the interface table takes more than
+ *               10% of the Low priority cgroup memory.
+ *
+ *               Built against the stub library sources, run with
+ *               "make bench".
+ *
+ * Copyright (c) 2018 by cisco Systems, Inc.
+ * All rights reserved.
+ *
+ *********************************************************************
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "nx_intf_mgr_impl.h"
+
+using namespace nxos;
+
+#define LOW_PRIO_MEM    (768UL << 20)
+#define VRF_COUNT       16
+
+static inline uint64_t nowNs()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + ts.tv_nsec;
+}
+
+static long rssBytes()
+{
+    long  pages = 0, rss = 0;
+    FILE *f = fopen("/proc/self/statm", "r");
+
+    if (f) {
+        if (fscanf(f, "%ld %ld", &pages, &rss) != 2) rss = 0;
+        fclose(f);
+    }
+    return rss * sysconf(_SC_PAGESIZE);
+}
+
+/* i-th interface: 1/4 SVIs (port-channel subinterfaces past 4094),
+ * 1/16 port-channels, the rest breakout Ethernet ports & their
+ * subinterfaces. */
+static void makeIntf(unsigned int i, char *name, size_t len, char *desc,
+                     char *addr, char *mac)
+{
+    unsigned int n = i / 4;
+
+    if ((i % 4) == 0) {
+        if (n < 4094) {
+            snprintf(name, len, "Vlan%u", n + 1);
+        } else {
+            snprintf(name, len, "port-channel%u.%u", (n % 512) + 1, n);
+        }
+        snprintf(desc, len, "SVI tenant-%u", n % 64);
+    } else if ((i % 16) == 1) {
+        snprintf(name, len, "port-channel%u", n + 1);
+        snprintf(desc, len, "vPC to leaf-%u", n % 32);
+    } else if ((i % 4) == 2) {
+        snprintf(name, len, "Ethernet%u/%u/%u", (n / 256) + 1,
+                 ((n / 4) % 64) + 1, (n % 4) + 1);
+        snprintf(desc, len, "breakout to server rack %u", n % 48);
+    } else {
+        snprintf(name, len, "Ethernet%u/%u/%u.%u", (n / 256) + 1,
+                 ((n / 4) % 64) + 1, (n % 4) + 1, i);
+        snprintf(desc, len, "breakout to server rack %u", n % 48);
+    }
+    snprintf(addr, len, "10.%u.%u.%u/31", (i >> 15) & 0xff, (i >> 7) & 0xff,
+             (i << 1) & 0xff);
+    snprintf(mac, len, "00%02x.%04x.%04x", (i >> 24) & 0xff,
+             (i >> 12) & 0xfff, i & 0xfff);
+}
+
+/* The interface state as one object of strings per interface. */
+struct ObjIntf {
+    std::string               name;
+    std::string               layer;
+    std::string               vrf;
+    std::string               desc;
+    std::string               l2Addr;
+    std::string               l2AddrHw;
+    std::string               prAddr[MAX_AF];
+    std::vector<std::string>  scAddrs[MAX_AF];
+    std::vector<std::string>  members;
+    uint32_t                  mtu;
+    uint32_t                  speed;
+    uint16_t                  vlan;
+    uint8_t                   type;
+    int8_t                    adminState;
+    int8_t                    operState;
+};
+
+static int runStore(unsigned int count)
+{
+    NxIntfMgrImpl            *intfMgr;
+    NxIntf                   *intf;
+    std::vector<std::string>  names(count);
+    char                      name[64], desc[64], addr[64], mac[64], vrf[16];
+    uint64_t                  start, addNs, getNs;
+    long                      rss0, rss1;
+    size_t                    tblBytes;
+    unsigned int              hits = 0;
+
+    rss0    = rssBytes();
+    start   = nowNs();
+    intfMgr = new NxIntfMgrImpl();
+    for (unsigned int i = 0; i < count; i++) {
+        makeIntf(i, name, sizeof(name), desc, addr, mac);
+        snprintf(vrf, sizeof(vrf), "tenant-%u", i % VRF_COUNT);
+        intf = intfMgr->addIntf(name);
+        intf->setLayer((i % 4) == 2 ? "Layer2" : "Layer3");
+        intf->setVrf(vrf);
+        intf->setDescription(desc);
+        intf->setL2Address(mac);
+        intf->setMtu(9216);
+        intf->setSpeed(25000000);
+        intf->setAdminState(UP);
+        if ((i % 4) != 2) intf->setL3Address(addr, AF_IPV4, true);
+    }
+    addNs    = nowNs() - start;
+    rss1     = rssBytes();
+    tblBytes = intfMgr->memUsage();
+
+    for (unsigned int i = 0; i < count; i++) {
+        makeIntf((i * 7919) % count, name, sizeof(name), desc, addr, mac);
+        names[i] = name;
+    }
+    start = nowNs();
+    for (unsigned int i = 0; i < count; i++) {
+        hits += (intfMgr->getIntf(names[i]) != NULL);
+    }
+    getNs = nowNs() - start;
+
+    printf("interfaces             %10u (%u found)\n", count, hits);
+    printf("table bytes/intf       %10.1f  total %.1f MB\n",
+           (double)tblBytes / count, tblBytes / 1048576.0);
+    printf("table RSS bytes/intf   %10.1f  total %.1f MB\n",
+           (double)(rss1 - rss0) / count, (rss1 - rss0) / 1048576.0);
+    printf("low prio cgroup share  %9.2f%%\n", tblBytes * 100.0 / LOW_PRIO_MEM);
+    printf("add+set ns/intf        %10.1f\n", (double)addNs / count);
+    printf("getIntf ns/intf        %10.1f\n", (double)getNs / count);
+    fflush(stdout);
+    delete intfMgr;
+
+    return (tblBytes * 10 > LOW_PRIO_MEM) ? 1 : 0;
+}
+
+/* Same state as one object per interface. */
+static int runObjects(unsigned int count)
+{
+    std::vector<ObjIntf *> objs(count);
+    char                   name[64], desc[64], addr[64], mac[64], vrf[16];
+    long                   rss0, rss1;
+
+    rss0 = rssBytes();
+    for (unsigned int i = 0; i < count; i++) {
+        ObjIntf *obj = new ObjIntf();
+
+        makeIntf(i, name, sizeof(name), desc, addr, mac);
+        snprintf(vrf, sizeof(vrf), "tenant-%u", i % VRF_COUNT);
+        obj->name   = name;
+        obj->layer  = (i % 4) == 2 ? "Layer2" : "Layer3";
+        obj->vrf    = vrf;
+        obj->desc   = desc;
+        obj->l2Addr = mac;
+        obj->mtu    = 9216;
+        obj->speed  = 25000000;
+        if ((i % 4) != 2) obj->prAddr[AF_IPV4] = addr;
+        objs[i] = obj;
+    }
+    rss1 = rssBytes();
+    printf("object RSS bytes/intf  %10.1f  total %.1f MB\n",
+           (double)(rss1 - rss0) / count, (rss1 - rss0) / 1048576.0);
+    fflush(stdout);
+    for (unsigned int i = 0; i < count; i++) delete objs[i];
+    return 0;
+}
+
+/* Run in a child so the RSS of each layout starts from the same heap. */
+static int runChild(int (*run)(unsigned int), unsigned int count)
+{
+    pid_t pid = fork();
+    int   status;
+
+    if (pid == 0) _exit(run(count));
+    if ((pid < 0) || (waitpid(pid, &status, 0) != pid)) return 1;
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned int count = (argc > 1) ? atoi(argv[1]) : 65536;
+
+    if (!count) return 0;
+
+    runChild(runObjects, count);
+    return runChild(runStore, count);
+}
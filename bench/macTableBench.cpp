@@ -0,0 +1,219 @@
+/*********************************************************************
+ *
+ * File: macTableBench.cpp
+ *
+ * Description:  Memory footprint & lookup cost of the NxMacMgr MAC
+ *               table, 1M MACs by default spread over 1000 VLANs on
+ *               48 interfaces, loaded as the event loop does. Reports
+ *               the bytes per MAC of the table & of the process (RSS),
+ *               the add latency & the getMac latency by NxMacKey & by
+ *               MAC address string. The same MACs held in a std::map
+ *               keyed by the address string & VLAN, one object of
+ *               std::string members per MAC, are measured for
+ *               comparison.
+ *
+ *               Usage: macTableBench [macCount]
+ *               Exits with 1 if a MAC loaded is not found.
+ *
+ *               Built against the stub library sources, run with
+ *               "make bench".
+ *
+ * Copyright (c) 2018 by cisco Systems, Inc.
+ * All rights reserved.
+ *
+ *********************************************************************
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "nx_mac_mgr_impl.h"
+#include "nx_intf_dict.h"
+
+using namespace nxos;
+
+#define VLAN_COUNT      1000
+#define INTF_COUNT      48
+
+static inline uint64_t nowNs()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + ts.tv_nsec;
+}
+
+static long rssBytes()
+{
+    long  pages = 0, rss = 0;
+    FILE *f = fopen("/proc/self/statm", "r");
+
+    if (f) {
+        if (fscanf(f, "%ld %ld", &pages, &rss) != 2) rss = 0;
+        fclose(f);
+    }
+    return rss * sysconf(_SC_PAGESIZE);
+}
+
+/* i-th MAC: a VMware OUI address in one of VLAN_COUNT VLANs. */
+static inline NxMacKey makeMac(unsigned int i)
+{
+    return NxMacKey(0x005056000000ULL + i, 1 + (i % VLAN_COUNT));
+}
+
+static void makeIntf(unsigned int i, char *name, size_t len)
+{
+    snprintf(name, len, "Ethernet1/%u", (i % INTF_COUNT) + 1);
+}
+
+/* A MAC as one object of strings. */
+struct ObjMac {
+    std::string   macAddr;
+    std::string   intfName;
+    unsigned int  vlan;
+    type_e        type;
+    event_type_e  event;
+};
+
+typedef std::map<std::pair<std::string, unsigned int>, ObjMac *> ObjMacMap;
+
+static int runTable(unsigned int count)
+{
+    NxMacMgrImpl             *macMgr;
+    NxMac                    *mac;
+    std::vector<NxMacKey>     keys(count);
+    std::vector<std::string>  addrs(count);
+    std::vector<uint32_t>     ifindexes(INTF_COUNT);
+    char                      name[64];
+    uint64_t                  start, addNs, keyNs, strNs;
+    long                      rss0, rss1;
+    size_t                    tblBytes;
+    unsigned int              keyHits = 0, strHits = 0;
+
+    for (unsigned int i = 0; i < INTF_COUNT; i++) {
+        makeIntf(i, name, sizeof(name));
+        ifindexes[i] = NxIntfDict::get().ifindex(name, true);
+    }
+
+    rss0   = rssBytes();
+    start  = nowNs();
+    macMgr = new NxMacMgrImpl();
+    for (unsigned int i = 0; i < count; i++) {
+        macMgr->postMacMsg(makeMac(i), ifindexes[i % INTF_COUNT],
+                           TYPE_DYNAMIC, ADD);
+    }
+    addNs    = nowNs() - start;
+    rss1     = rssBytes();
+    tblBytes = macMgr->memUsage();
+
+    for (unsigned int i = 0; i < count; i++) {
+        keys[i]  = makeMac((i * 7919) % count);
+        addrs[i] = keys[i].toString();
+    }
+    start = nowNs();
+    for (unsigned int i = 0; i < count; i++) {
+        if ((mac = macMgr->getMac(keys[i])) != NULL) {
+            keyHits++;
+            delete mac;
+        }
+    }
+    keyNs = nowNs() - start;
+    start = nowNs();
+    for (unsigned int i = 0; i < count; i++) {
+        if ((mac = macMgr->getMac(addrs[i], keys[i].vlan())) != NULL) {
+            strHits++;
+            delete mac;
+        }
+    }
+    strNs = nowNs() - start;
+
+    printf("macs                   %10u (%u/%u found)\n", count, keyHits,
+           strHits);
+    printf("table bytes/mac        %10.1f  total %.1f MB\n",
+           (double)tblBytes / count, tblBytes / 1048576.0);
+    printf("table RSS bytes/mac    %10.1f  total %.1f MB\n",
+           (double)(rss1 - rss0) / count, (rss1 - rss0) / 1048576.0);
+    printf("add ns/mac             %10.1f\n", (double)addNs / count);
+    printf("getMac(key) ns/mac     %10.1f\n", (double)keyNs / count);
+    printf("getMac(string) ns/mac  %10.1f\n", (double)strNs / count);
+    fflush(stdout);
+    delete macMgr;
+
+    return ((keyHits == count) && (strHits == count)) ? 0 : 1;
+}
+
+/* Same MACs in a map of objects keyed by address string & VLAN. */
+static int runObjects(unsigned int count)
+{
+    ObjMacMap                                         objs;
+    std::vector<std::pair<std::string, unsigned int> > keys(count);
+    char                                              name[64];
+    uint64_t                                          start, addNs, getNs;
+    long                                              rss0, rss1;
+    unsigned int                                      hits = 0;
+
+    rss0  = rssBytes();
+    start = nowNs();
+    for (unsigned int i = 0; i < count; i++) {
+        ObjMac   *obj = new ObjMac();
+        NxMacKey  key = makeMac(i);
+
+        makeIntf(i, name, sizeof(name));
+        obj->macAddr  = key.toString();
+        obj->intfName = name;
+        obj->vlan     = key.vlan();
+        obj->type     = TYPE_DYNAMIC;
+        obj->event    = ADD;
+        objs[std::make_pair(obj->macAddr, obj->vlan)] = obj;
+    }
+    addNs = nowNs() - start;
+    rss1  = rssBytes();
+
+    for (unsigned int i = 0; i < count; i++) {
+        NxMacKey key = makeMac((i * 7919) % count);
+
+        keys[i] = std::make_pair(key.toString(), key.vlan());
+    }
+    start = nowNs();
+    for (unsigned int i = 0; i < count; i++) {
+        hits += (objs.find(keys[i]) != objs.end());
+    }
+    getNs = nowNs() - start;
+
+    printf("object RSS bytes/mac   %10.1f  total %.1f MB\n",
+           (double)(rss1 - rss0) / count, (rss1 - rss0) / 1048576.0);
+    printf("object add ns/mac      %10.1f\n", (double)addNs / count);
+    printf("object find ns/mac     %10.1f (%u found)\n",
+           (double)getNs / count, hits);
+    fflush(stdout);
+    for (ObjMacMap::iterator it = objs.begin(); it != objs.end(); ++it) {
+        delete it->second;
+    }
+    return 0;
+}
+
+/* Run in a child so the RSS of each layout starts from the same heap. */
+static int runChild(int (*run)(unsigned int), unsigned int count)
+{
+    pid_t pid = fork();
+    int   status;
+
+    if (pid == 0) _exit(run(count));
+    if ((pid < 0) || (waitpid(pid, &status, 0) != pid)) return 1;
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned int count = (argc > 1) ? atoi(argv[1]) : 1000000;
+
+    if (!count) return 0;
+
+    runChild(runObjects, count);
+    return runChild(runTable, count);
+}
@@ -0,0 +1,194 @@
+/*********************************************************************
+ *
+ * File: ribAllocBench.cpp
+ *
+ * Description:  Counts the heap allocations of a route add & of a
+ *               route update, from the raw RIB message to the return
+ *               of NxRibMgrHandler::postL3RouteCb(). The route is read
+ *               in the callback once through the string accessors and
+ *               once through the binary NxPrefix/NxIpAddr accessors,
+ *               the allocations of the callback are reported apart
+ *               from the ones of the SDK.
+ *
+ *               Usage: ribAllocBench [routeCount]
+ *               Exits with 1 if a route update allocates in the SDK.
+ *
+ *               Built against the stub library sources, run with
+ *               "make bench".
+ *
+ * Copyright (c) 2018 by cisco Systems, Inc.
+ * All rights reserved.
+ *
+ *********************************************************************
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <sys/time.h>
+#include "nx_rib_mgr_impl.h"
+
+using namespace nxos;
+
+static unsigned long allocCount = 0;
+
+void *operator new(size_t size)
+{
+    void *ptr = malloc(size ? size : 1);
+
+    if (!ptr) throw std::bad_alloc();
+    allocCount++;
+    return ptr;
+}
+
+void operator delete(void *ptr) throw()
+{
+    free(ptr);
+}
+
+void operator delete(void *ptr, size_t size) throw()
+{
+    free(ptr);
+}
+
+static double nowUs()
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return (tv.tv_sec * 1e6) + tv.tv_usec;
+}
+
+class BenchRibHandler : public NxRibMgrHandler {
+public:
+    unsigned long sum;
+    unsigned long allocs;
+
+    BenchRibHandler() : sum(0), allocs(0) {}
+    bool postL3RouteCb(NxL3Route *route) {
+        unsigned long start = allocCount;
+
+        readRoute(route);
+        allocs += allocCount - start;
+        return true;
+    }
+    virtual void readRoute(NxL3Route *route) = 0;
+};
+
+class StrRibHandler : public BenchRibHandler {
+public:
+    void readRoute(NxL3Route *route) {
+        NxL3NextHop *nh;
+
+        sum += route->getAddress().size() + route->getMaskLen();
+        for (nh = route->getL3NextHop(true); nh; nh = route->getL3NextHop()) {
+            sum += nh->getAddress().size();
+        }
+    }
+};
+
+class BinRibHandler : public BenchRibHandler {
+public:
+    void readRoute(NxL3Route *route) {
+        NxL3NextHop *nh;
+        NxPrefix     prefix = route->getPrefix();
+
+        sum += prefix.ip.addr[0] + prefix.maskLen;
+        for (nh = route->getL3NextHop(true); nh; nh = route->getL3NextHop()) {
+            sum += nh->getIpAddr().addr[3];
+        }
+    }
+};
+
+/* i-th route of af. */
+static void makePrefix(NxPrefix *prefix, af_e af, unsigned int i)
+{
+    memset(prefix, 0, sizeof(*prefix));
+    prefix->ip.af   = af;
+    prefix->maskLen = (af == AF_IPV4) ? 24 : 64;
+    prefix->ip.addr[0] = (af == AF_IPV4) ? 10 : 0x20;
+    prefix->ip.addr[1] = (i >> 16) & 0xff;
+    prefix->ip.addr[2] = (i >> 8) & 0xff;
+    prefix->ip.addr[(af == AF_IPV4) ? 3 : 7] = i & 0xff;
+}
+
+/*
+ * Post count routes of af with 2 next-hops each from the raw RIB
+ * messages, then an update of each moving it to the other of 2 next-hop
+ * sets, and print the allocations per event in the callback & in the
+ * SDK. Short strings may fit the std::string inline buffer & not
+ * allocate. Returns the SDK allocations of the updates.
+ */
+static unsigned long runBench(const char *name, BenchRibHandler *handler,
+                              af_e af, unsigned int count)
+{
+    NxRibMgrImpl    ribMgr;
+    NxL3RouteMsg    msg;
+    NxL3RouteMsgNh  nhs[2];
+    unsigned long   allocs[2], cbAllocs[2];
+    double          start, elapsed[2];
+
+    memset(&msg, 0, sizeof(msg));
+    memset(nhs, 0, sizeof(nhs));
+    msg.vrfName  = "default";
+    msg.protocol = "bgp";
+    msg.tag      = "100";
+    msg.nextHops = nhs;
+    msg.nhCount  = 2;
+    for (int n = 0; n < 2; n++) {
+        nhs[n].ip.af      = af;
+        nhs[n].ip.addr[0] = (af == AF_IPV4) ? 10 : 0x20;
+        nhs[n].ip.addr[3] = 1 + n;
+        nhs[n].intfName   = n ? "Ethernet1/2" : "Ethernet1/1";
+        nhs[n].preference = 1;
+        nhs[n].type       = NxL3NextHop::ATTACHED;
+    }
+
+    ribMgr.setRibMgrHandler(handler);
+    ribMgr.watchL3Route("bgp", "100", "default", af);
+    for (int pass = 0; pass < 2; pass++) {
+        cbAllocs[pass] = handler->allocs;
+        allocs[pass]   = allocCount;
+        start = nowUs();
+        for (unsigned int i = 0; i < count; i++) {
+            makePrefix(&msg.prefix, af, i);
+            msg.event     = pass ? UPDATE : ADD;
+            nhs[1].metric = (i + pass) & 1;
+            ribMgr.postL3RouteMsg(msg);
+        }
+        elapsed[pass]  = nowUs() - start;
+        cbAllocs[pass] = handler->allocs - cbAllocs[pass];
+        allocs[pass]   = allocCount - allocs[pass] - cbAllocs[pass];
+    }
+
+    for (int pass = 0; pass < 2; pass++) {
+        printf("%-8s %s %-6s %8u  callback allocs/event %5.2f  "
+               "sdk allocs/event %5.2f  ns/event %8.1f\n",
+               name, (af == AF_IPV4) ? "ipv4" : "ipv6",
+               pass ? "update" : "add", count,
+               (double)cbAllocs[pass] / count, (double)allocs[pass] / count,
+               (elapsed[pass] * 1000) / count);
+    }
+    return allocs[1];
+}
+
+int main(int argc, char **argv)
+{
+    unsigned int  count = (argc > 1) ? atoi(argv[1]) : 100000;
+    unsigned long allocs = 0;
+    StrRibHandler strHandler;
+    BinRibHandler binHandler;
+
+    if (count < 2) return 0;
+
+    allocs += runBench("string", &strHandler, AF_IPV4, count);
+    allocs += runBench("binary", &binHandler, AF_IPV4, count);
+    allocs += runBench("string", &strHandler, AF_IPV6, count);
+    allocs += runBench("binary", &binHandler, AF_IPV6, count);
+    if (allocs) {
+        printf("route updates made %lu allocations in the SDK\n", allocs);
+        return 1;
+    }
+    return (strHandler.sum + binHandler.sum) ? 0 : 1;
+}
@@ -0,0 +1,439 @@
+/*********************************************************************
+ *
+ * File: ribScaleBench.cpp
+ *
+ * Description:  Drives NxRibMgr at production scale, 1M IPv4 /24 and
+ *               500k IPv6 /64 prefixes by default, through the
+ *               scenarios below & reports per scenario the throughput,
+ *               p50/p99/p999 latency of one operation, the peak RSS
+ *               of the process during the scenario & the RSS it grew
+ *               by as JSON, to track regressions between SDK releases.
+ *               The peak is reset at the start of each scenario & each
+ *               address family runs in a child of its own.
+ *
+ *               add       App addL3Route() + next-hop, then the commit
+ *                         of sendMyL3RoutesToRib() timed apart.
+ *               delete    App delL3Route() of all of them, then commit.
+ *               bulk_add  Same routes by addL3Routes() in batches of
+ *                         nx_l3_route_rec, each batch committed by the
+ *                         call, vs add + its commit_ms.
+ *               bulk_delete  delL3Routes() of them in batches, vs
+ *                         delete + its commit_ms.
+ *               download  Watched route download from RIB delivered to
+ *                         postL3RouteCb(), ended by DOWNLOAD_DONE.
+ *               lookup    Host address lookupL3Route() in the route
+ *                         cache of the downloaded routes.
+ *               churn     Random ADD/UPDATE/DELETE of watched routes.
+ *
+ *               Usage: ribScaleBench [v4Count [v6Count [jsonFile]]]
+ *               The JSON goes to stdout unless jsonFile is given.
+ *
+ *               Built against the stub library sources, run with
+ *               "make bench".
+ *
+ * Copyright (c) 2018 by cisco Systems, Inc.
+ * All rights reserved.
+ *
+ *********************************************************************
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "nx_rib_mgr_impl.h"
+
+using namespace nxos;
+
+static const char *intfNames[] = { "Ethernet1/1", "Ethernet1/2",
+                                   "Ethernet1/3", "Ethernet1/4" };
+
+static inline uint64_t nowNs()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + ts.tv_nsec;
+}
+
+/* xorshift64, fixed seed so runs are comparable. */
+static uint64_t randState = 88172645463325252ULL;
+
+static inline uint64_t nextRand()
+{
+    randState ^= randState << 13;
+    randState ^= randState >> 7;
+    randState ^= randState << 17;
+    return randState;
+}
+
+/* Field of /proc/self/status in kB, VmRSS (or) VmHWM the peak RSS. */
+static long statusKb(const char *field)
+{
+    char  line[128];
+    long  kb = 0;
+    FILE *f = fopen("/proc/self/status", "r");
+
+    if (!f) return 0;
+    while (fgets(line, sizeof(line), f)) {
+        if (!strncmp(line, field, strlen(field))) {
+            kb = atol(line + strlen(field));
+            break;
+        }
+    }
+    fclose(f);
+    return kb;
+}
+
+/* Reset VmHWM to the current RSS. */
+static void resetPeakRss()
+{
+    FILE *f = fopen("/proc/self/clear_refs", "w");
+
+    if (f) {
+        fputs("5", f);
+        fclose(f);
+    }
+}
+
+class CountRibHandler : public NxRibMgrHandler {
+public:
+    unsigned long routes;
+    unsigned long myRoutes;
+
+    CountRibHandler() : routes(0), myRoutes(0) {}
+    bool postL3RouteCb(NxL3Route *route) {
+        routes++;
+        return true;
+    }
+    bool postMyL3RouteCb(NxL3Route *route) {
+        myRoutes++;
+        return true;
+    }
+};
+
+/* Latencies of one scenario, in ns. */
+class Scenario {
+public:
+    Scenario(FILE *out, const char *af, const char *name, size_t ops)
+        : m_out(out), m_af(af), m_name(name) {
+        resetPeakRss();
+        m_rssKb = statusKb("VmRSS:");
+        m_start = nowNs();
+        m_lat.reserve(ops);
+    }
+
+    void add(uint64_t ns) {
+        m_lat.push_back((ns > 0xffffffffULL) ? 0xffffffffU : (uint32_t)ns);
+    }
+
+    /* Print the JSON object of the scenario, extra ends with a ',' */
+    void report(const char *extra = "", bool last = false) {
+        double secs = (nowNs() - m_start) / 1e9;
+
+        std::sort(m_lat.begin(), m_lat.end());
+        fprintf(m_out, "    { \"af\": \"%s\", \"scenario\": \"%s\", %s"
+                "\"ops\": %lu, \"ops_per_sec\": %.0f, \"p50_ns\": %u, "
+                "\"p99_ns\": %u, \"p999_ns\": %u, \"peak_rss_kb\": %ld, "
+                "\"rss_growth_kb\": %ld }%s\n",
+                m_af, m_name, extra, (unsigned long)m_lat.size(),
+                secs ? m_lat.size() / secs : 0.0, pct(0.5), pct(0.99),
+                pct(0.999), statusKb("VmHWM:"), statusKb("VmRSS:") - m_rssKb,
+                last ? "" : ",");
+        fflush(m_out);
+    }
+
+private:
+    uint32_t pct(double p) const {
+        return m_lat.empty() ? 0 : m_lat[(size_t)(p * (m_lat.size() - 1))];
+    }
+
+    FILE                  *m_out;
+    const char            *m_af;
+    const char            *m_name;
+    long                   m_rssKb;  // at the start
+    uint64_t               m_start;
+    std::vector<uint32_t>  m_lat;
+};
+
+/* i-th prefix of af: 10.0.0.0/24 up (or) 2001:db8::/64 up. */
+static void makePrefix(af_e af, uint32_t i, NxPrefix *prefix)
+{
+    memset(prefix, 0, sizeof(*prefix));
+    prefix->ip.af = af;
+    if (af == AF_IPV4) {
+        prefix->ip.addr[0] = 10 + (i >> 16);
+        prefix->ip.addr[1] = (i >> 8) & 0xff;
+        prefix->ip.addr[2] = i & 0xff;
+        prefix->maskLen    = 24;
+    } else {
+        prefix->ip.addr[0] = 0x20;
+        prefix->ip.addr[1] = 0x01;
+        prefix->ip.addr[2] = 0x0d;
+        prefix->ip.addr[3] = 0xb8;
+        prefix->ip.addr[4] = i >> 24;
+        prefix->ip.addr[5] = (i >> 16) & 0xff;
+        prefix->ip.addr[6] = (i >> 8) & 0xff;
+        prefix->ip.addr[7] = i & 0xff;
+        prefix->maskLen    = 64;
+    }
+}
+
+/* Records per addL3Routes()/delL3Routes() call. */
+static const uint32_t bulkBatch = 1000;
+
+/* Record of the i-th prefix, same next-hop as the add scenario. */
+static void makeRec(af_e af, uint32_t i, const NxIpAddr &nhAddr,
+                    nx_l3_route_rec *rec)
+{
+    NxPrefix prefix;
+
+    memset(rec, 0, sizeof(*rec));
+    makePrefix(af, i, &prefix);
+    prefix.ip.toString(rec->address, sizeof(rec->address));
+    rec->maskLen = prefix.maskLen;
+    nhAddr.toString(rec->nextHopAddr, sizeof(rec->nextHopAddr));
+    strncpy(rec->intfName, intfNames[i % 4], sizeof(rec->intfName) - 1);
+    rec->preference = 1;
+}
+
+/* 2 next-hops over 4 interfaces, metric bumped by gen on each UPDATE. */
+static void makeMsg(af_e af, const NxPrefix &prefix, uint32_t i, uint32_t gen,
+                    event_type_e event, NxL3RouteMsg *msg, NxL3RouteMsgNh *nh)
+{
+    memset(nh, 0, 2 * sizeof(NxL3RouteMsgNh));
+    msg->prefix   = prefix;
+    msg->vrfName  = "default";
+    msg->protocol = "bgp";
+    msg->tag      = "100";
+    msg->event    = event;
+    msg->nextHops = nh;
+    msg->nhCount  = 2;
+    for (int n = 0; n < 2; n++) {
+        nh[n].ip.af = af;
+        if (af == AF_IPV4) {
+            nh[n].ip.addr[0] = 192;
+            nh[n].ip.addr[3] = 1 + n;
+        } else {
+            nh[n].ip.addr[0]  = 0xfe;
+            nh[n].ip.addr[1]  = 0x80;
+            nh[n].ip.addr[15] = 1 + n;
+        }
+        nh[n].intfName   = intfNames[(i + n) % 4];
+        nh[n].preference = 20;
+        nh[n].metric     = gen;
+        nh[n].type       = NxL3NextHop::ATTACHED;
+    }
+}
+
+static void runAf(FILE *out, af_e af, uint32_t count, bool last)
+{
+    const char             *afName = (af == AF_IPV4) ? "ipv4" : "ipv6";
+    NxRibMgrImpl            ribMgr;
+    CountRibHandler         handler;
+    std::vector<uint32_t>   order(count);
+    std::vector<uint32_t>   gens(count, 0);  // 0: not in the table
+    NxL3RouteMsg            msg;
+    NxL3RouteMsgNh          nh[2];
+    std::vector<nx_l3_route_rec> recs;    // one batch
+    NxPrefix                prefix;
+    NxIpAddr                addr;
+    char                    extra[64];
+    uint64_t                start;
+    unsigned long           hits = 0;
+
+    ribMgr.setRibMgrHandler(&handler);
+    for (uint32_t i = 0; i < count; i++) order[i] = i;
+    for (uint32_t i = count; i > 1; i--) {
+        std::swap(order[i - 1], order[nextRand() % i]);
+    }
+
+    // add
+    {
+        Scenario s(out, afName, "add", count);
+
+        makePrefix(af, 0, &prefix);
+        makeMsg(af, prefix, 0, 1, ADD, &msg, nh);
+        for (uint32_t i = 0; i < count; i++) {
+            makePrefix(af, order[i], &prefix);
+            start = nowNs();
+            NxL3Route *route = ribMgr.addL3Route(prefix);
+            route->addL3DirectNextHop(nh[order[i] % 2].ip,
+                                      intfNames[order[i] % 4], 1);
+            s.add(nowNs() - start);
+        }
+        start = nowNs();
+        ribMgr.sendMyL3RoutesToRib(af);
+        snprintf(extra, sizeof(extra), "\"commit_ms\": %.1f, ",
+                 (nowNs() - start) / 1e6);
+        s.report(extra);
+    }
+
+    // delete
+    {
+        Scenario s(out, afName, "delete", count);
+
+        for (uint32_t i = 0; i < count; i++) {
+            makePrefix(af, order[i], &prefix);
+            start = nowNs();
+            ribMgr.delL3Route(prefix);
+            s.add(nowNs() - start);
+        }
+        start = nowNs();
+        ribMgr.sendMyL3RoutesToRib(af);
+        snprintf(extra, sizeof(extra), "\"commit_ms\": %.1f, ",
+                 (nowNs() - start) / 1e6);
+        s.report(extra);
+    }
+
+    // bulk_add, a latency is one batch.
+    {
+        Scenario s(out, afName, "bulk_add", (count / bulkBatch) + 1);
+        uint64_t routesNs = 0, ns;
+
+        for (uint32_t b = 0; b < count; b += bulkBatch) {
+            recs.resize(std::min(bulkBatch, count - b));
+            for (uint32_t i = 0; i < recs.size(); i++) {
+                makeRec(af, order[b + i], nh[order[b + i] % 2].ip, &recs[i]);
+            }
+            start = nowNs();
+            ribMgr.addL3Routes(recs, "default", af);
+            ns = nowNs() - start;
+            routesNs += ns;
+            s.add(ns);
+        }
+        snprintf(extra, sizeof(extra),
+                 "\"batch\": %u, \"routes_per_sec\": %.0f, ", bulkBatch, routesNs ? count / (routesNs / 1e9) : 0.0);
+        s.report(extra);
+    }
+
+    // bulk_delete
+    {
+        Scenario s(out, afName, "bulk_delete", (count / bulkBatch) + 1);
+        uint64_t routesNs = 0, ns;
+
+        for (uint32_t b = 0; b < count; b += bulkBatch) {
+            recs.resize(std::min(bulkBatch, count - b));
+            for (uint32_t i = 0; i < recs.size(); i++) {
+                makeRec(af, order[b + i], nh[order[b + i] % 2].ip, &recs[i]);
+            }
+            start = nowNs();
+            ribMgr.delL3Routes(recs, "default", af);
+            ns = nowNs() - start;
+            routesNs += ns;
+            s.add(ns);
+        }
+        snprintf(extra, sizeof(extra),
+                 "\"batch\": %u, \"routes_per_sec\": %.0f, ", bulkBatch, routesNs ? count / (routesNs / 1e9) : 0.0);
+        s.report(extra);
+        std::vector<nx_l3_route_rec>().swap(recs);
+    }
+
+    // download, into the route cache used by lookup.
+    {
+        Scenario s(out, afName, "download", count);
+
+        ribMgr.enableL3RouteCache(af);
+        ribMgr.watchL3Route("bgp", "100", "default", af);
+        handler.routes = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            makePrefix(af, order[i], &prefix);
+            makeMsg(af, prefix, order[i], 1, DOWNLOAD, &msg, nh);
+            start = nowNs();
+            ribMgr.postL3RouteMsg(msg);
+            s.add(nowNs() - start);
+            gens[order[i]] = 1;
+        }
+        start = nowNs();
+        ribMgr.postL3RouteDownloadDone(af, "default");
+        snprintf(extra, sizeof(extra), "\"delivered\": %lu, \"done_ms\": %.1f, ",
+                 handler.routes, (nowNs() - start) / 1e6);
+        s.report(extra);
+    }
+
+    // lookup
+    {
+        Scenario s(out, afName, "lookup", count);
+
+        for (uint32_t i = 0; i < count; i++) {
+            makePrefix(af, nextRand() % count, &prefix);
+            addr = prefix.ip;
+            addr.addr[(af == AF_IPV4) ? 3 : 15] = nextRand() & 0xff;
+            start = nowNs();
+            hits += (ribMgr.lookupL3Route(addr) != NULL);
+            s.add(nowNs() - start);
+        }
+        snprintf(extra, sizeof(extra), "\"hits\": %lu, ", hits);
+        s.report(extra);
+    }
+
+    // churn: a route in the table is updated 2 times out of 3, else
+    // deleted. A deleted one is added back.
+    {
+        Scenario s(out, afName, "churn", count);
+
+        handler.routes = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t     r = nextRand() % count;
+            event_type_e event;
+
+            if (!gens[r]) {
+                event   = ADD;
+                gens[r] = 1;
+            } else if (nextRand() % 3) {
+                event = UPDATE;
+                gens[r]++;
+            } else {
+                event   = DELETE;
+                gens[r] = 0;
+            }
+            makePrefix(af, r, &prefix);
+            makeMsg(af, prefix, r, gens[r], event, &msg, nh);
+            start = nowNs();
+            ribMgr.postL3RouteMsg(msg);
+            s.add(nowNs() - start);
+        }
+        snprintf(extra, sizeof(extra), "\"delivered\": %lu, ", handler.routes);
+        s.report(extra, last);
+    }
+}
+
+/* Run an address family in a child so its RSS starts from the same heap. */
+static void runAfChild(FILE *out, af_e af, uint32_t count, bool last)
+{
+    pid_t pid;
+    int   status;
+
+    fflush(out);
+    if ((pid = fork()) == 0) {
+        runAf(out, af, count, last);
+        fflush(out);
+        _exit(0);
+    }
+    if (pid > 0) waitpid(pid, &status, 0);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t  v4Count = (argc > 1) ? atoi(argv[1]) : 1000000;
+    uint32_t  v6Count = (argc > 2) ? atoi(argv[2]) : 500000;
+    FILE     *out = stdout;
+
+    if ((argc > 3) && !(out = fopen(argv[3], "w"))) {
+        perror(argv[3]);
+        return 1;
+    }
+
+    fprintf(out, "{\n  \"bench\": \"ribScaleBench\",\n"
+            "  \"ipv4_routes\": %u,\n  \"ipv6_routes\": %u,\n"
+            "  \"results\": [\n", v4Count, v6Count);
+    if (v4Count) runAfChild(out, AF_IPV4, v4Count, !v6Count);
+    if (v6Count) runAfChild(out, AF_IPV6, v6Count, true);
+    fprintf(out, "  ]\n}\n");
+
+    if (out != stdout) fclose(out);
+    return 0;
+}
@@ -0,0 +1,239 @@
+/*********************************************************************
+ *
+ * File: spanIterBench.cpp
+ *
+ * Description:  Compares the stateful fromFirst cursors with the span
+ *               accessors: ns per element to walk the next-hops of a
+ *               route, the interfaces & members of the interface
+ *               manager and the properties of a DME object. The span
+ *               accessors are also read from several threads at once
+ *               over the same route, which the cursors do not allow.
+ *
+ *               Built against the stub library sources, run with
+ *               "make bench".
+ *
+ * Copyright (c) 2018 by cisco Systems, Inc.
+ * All rights reserved.
+ *
+ *********************************************************************
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <pthread.h>
+#include <sys/time.h>
+#include "nx_rib_mgr_impl.h"
+#include "nx_intf_mgr_impl.h"
+#include "nx_dme_impl.h"
+
+using namespace nxos;
+
+#define NH_COUNT      16
+#define INTF_COUNT    4096
+#define MEMBER_COUNT  8
+#define PROP_COUNT    32
+#define THREAD_COUNT  4
+
+static double nowUs()
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return (tv.tv_sec * 1e6) + tv.tv_usec;
+}
+
+static void report(const char *name, double us, unsigned long elems,
+                   unsigned long sum)
+{
+    printf("%-24s elements %10lu  ns/element %6.2f  (%lu)\n",
+           name, elems, (us * 1000) / elems, sum);
+}
+
+struct SpanThread {
+    pthread_t     tid;
+    NxL3Route    *route;
+    unsigned int  loops;
+    unsigned long sum;
+};
+
+static void *spanThread(void *arg)
+{
+    SpanThread  *t = (SpanThread *)arg;
+    NxL3NextHop *nhs[NH_COUNT];
+
+    for (unsigned int l = 0; l < t->loops; l++) {
+        unsigned int count = t->route->getL3NextHops(nhs, NH_COUNT);
+
+        for (unsigned int i = 0; i < count; i++) {
+            t->sum += nhs[i]->getPreference();
+        }
+    }
+    return NULL;
+}
+
+static void benchNextHops(unsigned int loops)
+{
+    NxRibMgrImpl   ribMgr;
+    NxL3Route     *route;
+    NxPrefix       prefix;
+    NxIpAddr       addr;
+    NxL3NextHop   *nhs[NH_COUNT], *next;
+    SpanThread     threads[THREAD_COUNT];
+    unsigned long  sum = 0;
+    double         start;
+
+    prefix.fromString("10.0.0.0/24");
+    route = ribMgr.addL3Route(prefix);
+    for (int n = 0; n < NH_COUNT; n++) {
+        addr.fromString("192.0.0.0");
+        addr.addr[3] = 1 + n;
+        route->addL3DirectNextHop(addr, "Ethernet1/1", n);
+    }
+
+    start = nowUs();
+    for (unsigned int l = 0; l < loops; l++) {
+        for (next = route->getL3NextHop(true); next;
+             next = route->getL3NextHop()) {
+            sum += next->getPreference();
+        }
+    }
+    report("next-hop cursor", nowUs() - start, (unsigned long)loops * NH_COUNT,
+           sum);
+
+    sum   = 0;
+    start = nowUs();
+    for (unsigned int l = 0; l < loops; l++) {
+        unsigned int count = route->getL3NextHops(nhs, NH_COUNT);
+
+        for (unsigned int i = 0; i < count; i++) {
+            sum += nhs[i]->getPreference();
+        }
+    }
+    report("next-hop span", nowUs() - start, (unsigned long)loops * NH_COUNT,
+           sum);
+
+    sum   = 0;
+    start = nowUs();
+    for (int t = 0; t < THREAD_COUNT; t++) {
+        threads[t].route = route;
+        threads[t].loops = loops;
+        threads[t].sum   = 0;
+        pthread_create(&threads[t].tid, NULL, spanThread, &threads[t]);
+    }
+    for (int t = 0; t < THREAD_COUNT; t++) {
+        pthread_join(threads[t].tid, NULL);
+        sum += threads[t].sum;
+    }
+    report("next-hop span 4 threads", nowUs() - start,
+           (unsigned long)loops * NH_COUNT * THREAD_COUNT, sum);
+}
+
+static void benchIntfs(unsigned int loops)
+{
+    NxIntfMgrImpl             intfMgr;
+    std::vector<NxIntf *>     intfs(INTF_COUNT);
+    std::vector<std::string>  members;
+    NxIntf                   *intf;
+    unsigned long             sum = 0;
+    char                      name[32];
+    double                    start;
+
+    for (unsigned int i = 0; i < INTF_COUNT; i++) {
+        snprintf(name, sizeof(name), "port-channel%u", i + 1);
+        intf = intfMgr.addIntf(name);
+        for (unsigned int m = 0; m < MEMBER_COUNT; m++) {
+            snprintf(name, sizeof(name), "Ethernet%u/%u", (i / 64) + 1,
+                     m + 1);
+            intf->addMember(name);
+        }
+    }
+
+    start = nowUs();
+    for (unsigned int l = 0; l < loops; l++) {
+        for (intf = intfMgr.iterateIntf(true); intf;
+             intf = intfMgr.iterateIntf()) {
+            sum++;
+        }
+    }
+    report("interface cursor", nowUs() - start,
+           (unsigned long)loops * INTF_COUNT, sum);
+
+    sum   = 0;
+    start = nowUs();
+    for (unsigned int l = 0; l < loops; l++) {
+        sum += intfMgr.getIntfs(&intfs[0], INTF_COUNT);
+    }
+    report("interface span", nowUs() - start,
+           (unsigned long)loops * INTF_COUNT, sum);
+
+    sum   = 0;
+    start = nowUs();
+    for (unsigned int i = 0; i < INTF_COUNT; i++) {
+        std::string member;
+
+        for (member = intfs[i]->getMembers(true); !member.empty();
+             member = intfs[i]->getMembers()) {
+            sum += member.size();
+        }
+    }
+    report("member cursor", nowUs() - start,
+           (unsigned long)INTF_COUNT * MEMBER_COUNT, sum);
+
+    sum   = 0;
+    start = nowUs();
+    for (unsigned int i = 0; i < INTF_COUNT; i++) {
+        intfs[i]->getMemberNames(&members);
+        for (size_t m = 0; m < members.size(); m++) {
+            sum += members[m].size();
+        }
+    }
+    report("member span", nowUs() - start,
+           (unsigned long)INTF_COUNT * MEMBER_COUNT, sum);
+}
+
+static void benchDme(unsigned int loops)
+{
+    NxDmeImpl                 dme;
+    std::vector<std::string>  names;
+    std::string               name;
+    unsigned long             sum = 0;
+    char                      buf[32];
+    int                       err;
+    double                    start;
+
+    for (unsigned int p = 0; p < PROP_COUNT; p++) {
+        snprintf(buf, sizeof(buf), "property%u", p);
+        dme.setProperty(buf, "value", &err);
+    }
+
+    start = nowUs();
+    for (unsigned int l = 0; l < loops; l++) {
+        for (name = dme.iterateProperties(true); !name.empty();
+             name = dme.iterateProperties()) {
+            sum += name.size();
+        }
+    }
+    report("dme property cursor", nowUs() - start,
+           (unsigned long)loops * PROP_COUNT, sum);
+
+    sum   = 0;
+    start = nowUs();
+    for (unsigned int l = 0; l < loops; l++) {
+        dme.getPropertyNames(&names);
+        for (size_t p = 0; p < names.size(); p++) {
+            sum += names[p].size();
+        }
+    }
+    report("dme property span", nowUs() - start,
+           (unsigned long)loops * PROP_COUNT, sum);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned int loops = (argc > 1) ? atoi(argv[1]) : 200000;
+
+    benchNextHops(loops);
+    benchIntfs(loops / 1000 + 1);
+    benchDme(loops / 10 + 1);
+    return 0;
+}
@@ -205,82 +205,51 @@ myIntfHandler::postIntfIpv6AddrCb (NxIntf *intf)
 void
 query_interface (NxIntf* objp)
 {
-    af_e  af = AF_IPV4;
-    std::string intf_name;
-    std::string l3_addrv4;
-    std::string l3_addrv6;
-    std::string l3_sec_addr;
-    std::string l2_addr;
-    std::string l2_addrHW;
-    std::string adminSt;
-    std::string operSt;
-    std::string layer;
-    nxos::intf_type_e  type;
-    std::string vrf;
-    std::string vlan;
-    std::string descr;
-    uint32_t  mtu;
-    uint32_t  speed;
-    std::string  lastmod;
-
-    if (!objp)  return;
-    
-    intf_name = objp->getName();
-    type      = objp->getType();
-    adminSt   = objp->getAdminState() == UP ? "up" : "down";
-    operSt    = objp->getOperState() == UP ? "up" : "down";  
-    layer    =  objp->getLayer();
-    l3_addrv4  =  objp->getL3PrAddr(AF_IPV4);
-    l3_addrv6  =  objp->getL3PrAddr(AF_IPV6);
-    l2_addr  =  objp->getL2Address();
-    l2_addrHW  =  objp->getL2AddressHW();
-    vrf      =  objp->getVrf();
-    vlan     =  objp->getVlan();
-    descr    =  objp->getDescription();
-    mtu      =  objp->getMtu();
-    speed    =  objp->getSpeed();
-    lastmod  =  objp->getLastMod();
+    nxos::NxIntfSnapshot      snap;
+    std::vector<std::string>  list;
+
+    // All the attributes in one call, in place of a getter each.
+    if (!objp || !objp->snapshot(&snap))  return;
 
     traceP->syslog(NxTrace::NOTICE,"======================");
-    traceP->syslog(NxTrace::NOTICE,"Interface : %s", intf_name.c_str());
-    traceP->syslog(NxTrace::NOTICE,"\ttype     : %s", intf_str[type]);
-    traceP->syslog(NxTrace::NOTICE,"\tdescr    : %s", descr.c_str());
-    traceP->syslog(NxTrace::NOTICE,"\tmtu      : %d", mtu);
-    traceP->syslog(NxTrace::NOTICE,"\tspeed    : %s", speed_str(speed));
-    traceP->syslog(NxTrace::NOTICE,"\tadminSt  : %s", adminSt.c_str());
-    traceP->syslog(NxTrace::NOTICE,"\toperSt   : %s", operSt.c_str());
-    traceP->syslog(NxTrace::NOTICE,"\tlayer    : %s", layer.c_str());
-    traceP->syslog(NxTrace::NOTICE,"\tL3addrv4 : %s", l3_addrv4.c_str());
+    traceP->syslog(NxTrace::NOTICE,"Interface : %s", snap.name);
+    traceP->syslog(NxTrace::NOTICE,"\ttype     : %s", intf_str[snap.type]);
+    traceP->syslog(NxTrace::NOTICE,"\tdescr    : %s", snap.description);
+    traceP->syslog(NxTrace::NOTICE,"\tmtu      : %d", snap.mtu);
+    traceP->syslog(NxTrace::NOTICE,"\tspeed    : %s", speed_str(snap.speed));
+    traceP->syslog(NxTrace::NOTICE,"\tadminSt  : %s", snap.adminState == UP ? "up" : "down");
+    traceP->syslog(NxTrace::NOTICE,"\toperSt   : %s", snap.operState == UP ? "up" : "down");
+    traceP->syslog(NxTrace::NOTICE,"\tlayer    : %s", snap.layer);
+    traceP->syslog(NxTrace::NOTICE,"\tL3addrv4 : %s", snap.l3PrAddr[AF_IPV4]);
     traceP->syslog(NxTrace::NOTICE,"\tL3sec    : ");
-    l3_sec_addr = objp->getL3ScAddr(AF_IPV4, true);
-    while (!l3_sec_addr.empty()) {
-        traceP->syslog(NxTrace::NOTICE,"%s ", l3_sec_addr.c_str());
-        l3_sec_addr = objp->getL3ScAddr(AF_IPV4);
+    if (snap.l3ScAddrCount[AF_IPV4]) {
+        objp->getL3ScAddrs(AF_IPV4, &list);
+        for (size_t i = 0; i < list.size(); i++) {
+            traceP->syslog(NxTrace::NOTICE,"%s ", list[i].c_str());
+        }
     }
 
-    traceP->syslog(NxTrace::NOTICE,"\tL3addrv6 : %s", l3_addrv6.c_str());
+    traceP->syslog(NxTrace::NOTICE,"\tL3addrv6 : %s", snap.l3PrAddr[AF_IPV6]);
     traceP->syslog(NxTrace::NOTICE,"\tL3sec    : ");
-    l3_sec_addr = objp->getL3ScAddr(AF_IPV6, true);
-    while (!l3_sec_addr.empty()) {
-        traceP->syslog(NxTrace::NOTICE,"%s ", l3_sec_addr.c_str());
-        l3_sec_addr = objp->getL3ScAddr(AF_IPV6);
+    if (snap.l3ScAddrCount[AF_IPV6]) {
+        objp->getL3ScAddrs(AF_IPV6, &list);
+        for (size_t i = 0; i < list.size(); i++) {
+            traceP->syslog(NxTrace::NOTICE,"%s ", list[i].c_str());
+        }
     }
 
-    traceP->syslog(NxTrace::NOTICE,"\tL2addr   : %s", l2_addr.c_str());
-    traceP->syslog(NxTrace::NOTICE,"\tL2addrHW : %s", l2_addrHW.c_str());
-    traceP->syslog(NxTrace::NOTICE,"\tvrf      : %s", vrf.c_str());
-    traceP->syslog(NxTrace::NOTICE,"\tvlan     : %s", vlan.c_str());
-    traceP->syslog(NxTrace::NOTICE,"\tlastmod  : %s", lastmod.c_str());
+    traceP->syslog(NxTrace::NOTICE,"\tL2addr   : %s", snap.l2Address);
+    traceP->syslog(NxTrace::NOTICE,"\tL2addrHW : %s", snap.l2AddressHW);
+    traceP->syslog(NxTrace::NOTICE,"\tvrf      : %s", snap.vrf);
+    traceP->syslog(NxTrace::NOTICE,"\tvlan     : %u", snap.vlan);
+    traceP->syslog(NxTrace::NOTICE,"\tlastmod  : %s", snap.lastMod);
     
-    if (type == NX_TYPE_ETH_PC)  {
-        std::string mbr;
-        
-        traceP->syslog(NxTrace::NOTICE,"\t\tMember count: %d", objp->getMemberCount());
+    if (snap.type == NX_TYPE_ETH_PC)  {
+        traceP->syslog(NxTrace::NOTICE,"\t\tMember count: %d", snap.memberCount);
 
-        mbr = objp->getMembers(true);
-        while (!mbr.empty()) {
-            traceP->syslog(NxTrace::NOTICE,"\t\t *<%s>", mbr.c_str());
-            mbr = objp->getMembers();
+        objp->getMemberNames(&list);
+        for (size_t i = 0; i < list.size(); i++) {
+            traceP->syslog(NxTrace::NOTICE,"\t\t *<%s>", list[i].c_str());
         }
     }
 }
@@ -255,6 +255,37 @@ public:
      *
      **/
     virtual bool equal(NxAdj const &adj_obj) const = 0;
+
+    /**
+     * Get the ifindex of the Layer3 Interface of the adjacency, refer to
+     * NxIntfMgr::getIfindex().
+     *
+     * @returns ifindex (uint32_t), 0 if none.
+     *
+     *  @code
+     *  C++:
+     *       NxIntf *intf = intfMgr->getIntf(adj->getIfindex());
+     *
+     *  Python:
+     *       intf = intfMgr.getIntf(adj.getIfindex())
+     *  @endcode
+     **/
+    virtual uint32_t getIfindex() = 0;
+
+    /**
+     * Get the ifindex of the Layer2 physical Interface of the adjacency,
+     * refer to NxIntfMgr::getIfindex().
+     *
+     * @returns ifindex (uint32_t), 0 if none.
+     *
+     *  @code
+     *  C++:
+     *       if (adj->getPhyIfindex() == mac->getIfindex()) {
+     *           // host behind the same port
+     *       }
+     *  @endcode
+     **/
+    virtual uint32_t getPhyIfindex() = 0;
 };
 
 /**
@@ -266,6 +297,17 @@ class NxAdjMgrHandler
 public:
     virtual ~NxAdjMgrHandler(){};
 
+    /**
+     * Events of the handler, one bit per callback. OR them into the
+     * mask of NxAdjMgr::setAdjMgrHandler() to be called only for those, the
+     * others are dropped before they are built.
+     **/
+    typedef enum {
+        EVENT_ADJ               = 0x001,  /// postAdjCb()
+        EVENT_ADJ_DOWNLOAD_DONE = 0x002,  /// postAdjIPv4DownloadDone() & IPv6
+        EVENT_ALL               = 0xffffffff
+    } event_mask_e;
+
     /**
      * User to overload the postAdjCb callback method
      * to receive any registered Adjacency updates based
@@ -640,6 +682,81 @@ public:
      *          setAdjMgrHandler (or) NULL.
      **/
     virtual NxAdjMgrHandler *getAdjMgrHandler() = 0;
+
+    /**
+     * Get an adjacency by interface ifindex, as getAdj(intfName, ipAddr).
+     * @param[in] ifindex  Refer to NxIntfMgr::getIfindex().
+     * @param[in] ipAddr   IP address in string.
+     * @returns NxAdj object (or) NULL if not found.
+     *
+     *  @throws
+     *  ERR_INVALID if ifindex or ipAddr is invalid.
+     **/
+    virtual NxAdj *getAdj(uint32_t          ifindex,
+                          const std::string &ipAddr) = 0;
+
+    /**
+     * Watch the adjacencies of an interface by ifindex, as
+     * watchAdj(intfName, addr_family, download, ipAddr).
+     * @param[in] ifindex  Refer to NxIntfMgr::getIfindex().
+     *
+     *  @code
+     *  C++:
+     *       adjMgr->watchAdj(intf->getIfindex(), AF_IPV4);
+     *  @endcode
+     *
+     *  @throws
+     *  ERR_INVALID if ifindex or addr_family or ipAddr is invalid.
+     **/
+    virtual bool watchAdj(uint32_t          ifindex,
+                          nxos::af_e        addr_family = AF_IPV4,
+                          bool              download = true,
+                          const std::string &ipAddr = "") = 0;
+
+    /**
+     * Unwatch the adjacencies of an interface by ifindex, as
+     * unwatchAdj(intfName, addr_family, ipAddr).
+     * @param[in] ifindex  Refer to NxIntfMgr::getIfindex().
+     *
+     *  @throws
+     *  ERR_INVALID if ifindex or addr_family or ipAddr is invalid.
+     **/
+    virtual bool unwatchAdj(uint32_t          ifindex,
+                            nxos::af_e        addr_family = AF_IPV4,
+                            const std::string &ipAddr = "") = 0;
+
+    /**
+     * Register your handler object for only some of its events,
+     * setAdjMgrHandler(handler) registers it for all of them. The events out
+     * of eventMask are dropped before any object is built (or) any data is
+     * read for them & are counted, refer to getSkippedEventCount().
+     * @param[in] handler    NxAdjMgrHandler object with user overloaded
+     *                       functions to handle events.
+     * @param[in] eventMask  NxAdjMgrHandler::event_mask_e values OR-ed.
+     *
+     *  @code
+     *  C++:
+     *       adjMgr->setAdjMgrHandler(myadjcb, NxAdjMgrHandler::EVENT_ADJ);
+     *
+     *  Python:
+     *       adjMgr.setAdjMgrHandler(myadjcb, nx_sdk_py.NxAdjMgrHandler.EVENT_ADJ)
+     *  @endcode
+     **/
+    virtual void setAdjMgrHandler(NxAdjMgrHandler *handler, uint32_t eventMask) = 0;
+
+    /**
+     * Get the count of events dropped as out of the event mask of the
+     * handler, refer to setAdjMgrHandler(handler, eventMask).
+     * @param[in] events  [Optional] NxAdjMgrHandler::event_mask_e values
+     *                    OR-ed, a single one for the count of that event.
+     * @returns Count of events skipped, of all the events by default.
+     *
+     *  @code
+     *  C++:
+     *       cout << adjMgr->getSkippedEventCount() << " events skipped";
+     *  @endcode
+     **/
+    virtual uint64_t getSkippedEventCount(uint32_t events = 0xffffffff) = 0;
 };
 } // namespace nxos
 
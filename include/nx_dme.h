@@ -19,6 +19,7 @@
 #include <string>
 #include <cstring>
 #include <stdexcept>
+#include <vector>
 #include "types/nx_common.h"
 #include "nx_exception.h"
 
@@ -491,6 +492,26 @@ public:
      **/
     virtual std::string getEventPropertyValue(const std::string& sInPropName,
                                               int *err) = 0;
+
+    /**
+     *  Get all the property names of the object in one call, in place
+     *  of looping over iterateProperties(fromFirst). No cursor is kept in
+     *  the object, so several threads can read it at once.
+     *  @param[out] names  Filled with the property names. Reuse the
+     *                     vector across calls to reuse its storage.
+     *  @returns
+     *      Count of properties.
+     *  @code
+     *   C++:
+     *      std::vector<std::string> names;
+     *
+     *      dme->getPropertyNames(&names);
+     *  @endcode
+     *
+     *  @throws
+     *      None.
+     **/
+    virtual unsigned int getPropertyNames(std::vector<std::string> *names) = 0;
 };
 
 
@@ -514,6 +535,18 @@ class NxDmeMgrHandler
 {
 public:
     virtual ~NxDmeMgrHandler() {}
+
+    /**
+     * Events of the handler, one bit per callback. OR them into the
+     * mask of NxDmeMgr::setDmeHandler() to be called only for those, the
+     * others are dropped before they are built.
+     **/
+    typedef enum {
+        EVENT_DME               = 0x001,  /// postDmeHandlerCb()
+        EVENT_DME_DOWNLOAD_DONE = 0x002,  /// postDmeHandlerDownloadDoneCb()
+        EVENT_ALL               = 0xffffffff
+    } event_mask_e;
+
     /**
      *  Application callback for receiving DME events.  The object
      *  passed contains the object data which the event occurred.
@@ -938,6 +971,39 @@ public:
      *      None.
      **/
     virtual NxDmeMgrHandler *getDmeHandler() = 0;
+
+    /**
+     * Register your handler object for only some of its events,
+     * setDmeHandler(handler) registers it for all of them. The events out of
+     * eventMask are dropped before any object is built (or) any data is read
+     * for them & are counted, refer to getSkippedEventCount().
+     * @param[in] handler    NxDmeMgrHandler object with user overloaded
+     *                       functions to handle events.
+     * @param[in] eventMask  NxDmeMgrHandler::event_mask_e values OR-ed.
+     *
+     *  @code
+     *  C++:
+     *       dmeP->setDmeHandler(dmeHandler, NxDmeMgrHandler::EVENT_DME);
+     *
+     *  Python:
+     *       dmeP.setDmeHandler(myDmeHandler, nx_sdk_py.NxDmeMgrHandler.EVENT_DME)
+     *  @endcode
+     **/
+    virtual bool setDmeHandler(NxDmeMgrHandler *handler, uint32_t eventMask) = 0;
+
+    /**
+     * Get the count of events dropped as out of the event mask of the
+     * handler, refer to setDmeHandler(handler, eventMask).
+     * @param[in] events  [Optional] NxDmeMgrHandler::event_mask_e values
+     *                    OR-ed, a single one for the count of that event.
+     * @returns Count of events skipped, of all the events by default.
+     *
+     *  @code
+     *  C++:
+     *       cout << dmeP->getSkippedEventCount() << " events skipped";
+     *  @endcode
+     **/
+    virtual uint64_t getSkippedEventCount(uint32_t events = 0xffffffff) = 0;
 };
 
 } // namespace nxos
@@ -19,7 +19,9 @@
 #include <string>
 #include <cstring>
 #include <stdexcept>
+#include <vector>
 #include "types/nx_common.h"
+#include "types/nx_intf_mgr.h"
 
 namespace nxos
 {
@@ -781,6 +783,145 @@ class NxIntf
      *
      **/
     virtual bool equal(NxIntf const &intf_obj) const = 0;
+
+    /**
+     *  Get all the secondary IP addresses of the interface in address
+     *  family in one call, in place of looping over getL3ScAddr(af,
+     *  fromFirst). No cursor is kept in the interface, so several
+     *  threads can read the same interface at once.
+     *  @param[in]  af     Address family of L3 address.
+     *  @param[out] addrs  Filled with the addresses. Reuse the vector
+     *                     across calls to reuse its storage.
+     *  @returns  Count of addresses.
+     *
+     *  @code
+     *
+     *  C++:
+     *       std::vector<std::string> addrs;
+     *
+     *       objp->getL3ScAddrs(AF_IPV4, &addrs);
+     *       for (size_t i = 0; i < addrs.size(); i++) {
+     *           cout << addrs[i] << " ";
+     *       }
+     *  @endcode
+     *
+     *  @throws  None.
+     **/
+    virtual unsigned int getL3ScAddrs(af_e af,
+                                      std::vector<std::string> *addrs) = 0;
+
+    /**
+     *  Get all the member names of the channel group in one call, in
+     *  place of looping over getMembers(fromFirst). No cursor is kept in
+     *  the interface, so several threads can read the same interface at
+     *  once.
+     *  @param[out] members  Filled with the short member names.
+     *  @returns  Count of members.
+     *
+     *  @code
+     *
+     *  C++:
+     *        std::vector<std::string> mbrs;
+     *
+     *        objp->getMemberNames(&mbrs);
+     *  @endcode
+     *
+     *  @throws  None.
+     **/
+    virtual unsigned int getMemberNames(std::vector<std::string> *members) = 0;
+
+    /**
+     *  Read all the attributes of the interface in one call, in place of
+     *  calling each getter. The interface is read at once so the values
+     *  are consistent with each other.
+     *  @param[out] snap  Filled with the attributes.
+     *  @returns  true if successful, false if the interface is gone.
+     *
+     *  @code
+     *
+     *  C++:
+     *        nxos::NxIntfSnapshot snap;
+     *
+     *        if (objp->snapshot(&snap)) {
+     *            cout << snap.name << " mtu " << snap.mtu << endl;
+     *        }
+     *  Python:
+     *        snap = nx_sdk_py.NxIntfSnapshot()
+     *        if intf.snapshot(snap):
+     *            print snap.name
+     *  @endcode
+     *
+     *  @throws  None.
+     **/
+    virtual bool snapshot(NxIntfSnapshot *snap) = 0;
+
+    /**
+     *  Get the ifindex of the interface, the integer handle of its name
+     *  in the interface dictionary shared by the managers. Compare the
+     *  ifindexes of interfaces from different managers, i.e
+     *  NxMac::getIfindex(), NxAdj::getIfindex() &
+     *  NxL3NextHop::getOutIfindex(), in place of their names.
+     *  @returns  ifindex, 0 if the interface is gone.
+     *
+     *  @code
+     *
+     *  C++:
+     *        if (mac->getIfindex() == objp->getIfindex()) {
+     *            // MAC learnt on this interface
+     *        }
+     *  Python:
+     *        if mac.getIfindex() == intf.getIfindex():
+     *            print mac.getMacAddress()
+     *  @endcode
+     *
+     *  @throws  None.
+     **/
+    virtual uint32_t getIfindex() = 0;
+
+    /**
+     *  Get the VLANs the interface carries as a bitset, i.e the access
+     *  VLAN (or) the allowed VLANs of a trunk, in place of parsing the
+     *  VLAN ranges.
+     *  @param[out] vlans  Filled with the VLANs.
+     *  @returns  true if successful, false if the interface is gone.
+     *
+     *  @code
+     *
+     *  C++:
+     *        nxos::NxVlanSet vlans;
+     *
+     *        if (objp->getVlanSet(&vlans) && vlans.test(2100)) {
+     *            cout << objp->getName() << " carries vlan 2100" << endl;
+     *        }
+     *  Python:
+     *        vlans = nx_sdk_py.NxVlanSet()
+     *        if intf.getVlanSet(vlans):
+     *            print "%d vlans" % vlans.count()
+     *  @endcode
+     *
+     *  @throws  None.
+     **/
+    virtual bool getVlanSet(NxVlanSet *vlans) = 0;
+
+    /**
+     *  Get the members of the channel group as a bitmap over their
+     *  ifindexes, in place of walking getMembers(fromFirst).
+     *  @param[out] members  Filled with the ifindexes of the members.
+     *  @returns  Count of members.
+     *
+     *  @code
+     *
+     *  C++:
+     *        nxos::NxIntfBitmap mbrs;
+     *
+     *        if (pc->getMemberSet(&mbrs) && mbrs.test(eth->getIfindex())) {
+     *            cout << eth->getName() << " is a member" << endl;
+     *        }
+     *  @endcode
+     *
+     *  @throws  None.
+     **/
+    virtual unsigned int getMemberSet(NxIntfBitmap *members) = 0;
 };
 
 /**
@@ -805,6 +946,24 @@ class NxIntfMgrHandler
 {
   public:
     virtual ~NxIntfMgrHandler() {}
+
+    /**
+     * Events of the handler, one bit per callback. OR them into the
+     * mask of NxIntfMgr::setIntfHandler() to be called only for those, the
+     * others are dropped before they are built.
+     **/
+    typedef enum {
+        EVENT_ADD_DEL           = 0x001,  /// postIntfAddDelCb()
+        EVENT_IPV4_ADDR         = 0x002,  /// postIntfIpv4AddrCb()
+        EVENT_IPV6_ADDR         = 0x004,  /// postIntfIpv6AddrCb()
+        EVENT_STATE             = 0x008,  /// postIntfStateCb()
+        EVENT_LAYER             = 0x010,  /// postIntfLayerCb()
+        EVENT_PORT_MEMBER       = 0x020,  /// postIntfPortMemberCb()
+        EVENT_VRF               = 0x040,  /// postIntfVrfCb()
+        EVENT_VLAN              = 0x080,  /// postIntfVlanCb()
+        EVENT_COUNTER_THRESHOLD = 0x100,  /// postIntfCounterThresholdCb()
+        EVENT_ALL               = 0xffffffff
+    } event_mask_e;
     
     /**
      *  Interface Add/Delete callback notification handler.
@@ -1085,6 +1244,39 @@ class NxIntfMgrHandler
      *      Application exceptions are ignored.
      **/
     virtual bool postIntfVlanCb(NxIntf *obj) { return true; }
+
+    /**
+     *  Interface counter threshold crossing notification handler. Only
+     *  called when an interface watched by NxIntfMgr::watchIntfCounters()
+     *  goes over (or) back under the threshold set with
+     *  NxIntfMgr::setIntfCounterThreshold(), not on every sample.
+     *  @param[in]  obj       Interface that crossed the threshold.
+     *  @param[in]  rates     Its rates over the last interval.
+     *  @param[in]  exceeded  true if it went over the threshold, false
+     *                        if it went back under it.
+     *
+     *  @code
+     *     C++:
+     *        void
+     *        myIntfHandler::postIntfCounterThresholdCb (NxIntf *intf,
+     *                           const nxos::NxIntfRates &rates, bool exceeded)
+     *        {
+     *           cout << intf->getName() << (exceeded ? " over " : " under ")
+     *                << "threshold, rx " << rates.rxUtil << "% tx "
+     *                << rates.txUtil << "%" << endl;
+     *        }
+     *
+     *     Python:
+     *        def postIntfCounterThresholdCb(self, intf, rates, exceeded):
+     *            print intf.getName() + " rx util " + str(rates.rxUtil)
+     *  @endcode
+     *
+     *  @throws
+     *      Application exceptions are ignored.
+     **/
+    virtual void postIntfCounterThresholdCb(NxIntf *obj,
+                                            const nxos::NxIntfRates &rates,
+                                            bool exceeded) {}
 };
 
 /**
@@ -1262,7 +1454,9 @@ class NxIntfMgr
      *  @param[in]  name   The name of the interface to remove.  Only
      *                     logical interfaces can be removed.
      *  @param[in] del_sdk [Optional] Remove the object reference also if open.
-     *  @returns  true if successful
+     *  @returns  true if successful. NxIntf objects of the interface
+     *            held by the App then return empty values & their set
+     *            APIs fail, until an interface of the same name is added.
      *
      * @details
      *     Write API - NX-SDK Applications can use this API only if security profile with permit (or) throttle is 
@@ -1385,6 +1579,389 @@ class NxIntfMgr
      *  @throws  None.
      **/
     virtual NxIntfMgrHandler *getIntfHandler() = 0;
+
+    /**
+     *  Get all the open interfaces in one call into a buffer of the
+     *  caller, in place of looping over iterateIntf(fromFirst). Keeps
+     *  no cursor & can be called from several threads at once.
+     *  @param[out] intfs     Caller buffer of maxCount entries. The
+     *                        objects are owned by NxIntfMgr.
+     *  @param[in]  maxCount  Size of intfs.
+     *  @returns  Count of open interfaces, can be more than maxCount.
+     *            Call again with a larger buffer if so.
+     *
+     *  @code
+     *
+     *  C++:
+     *     std::vector<NxIntf *> intfs(64);
+     *     unsigned int          count;
+     *
+     *     while ((count = intfMgr->getIntfs(&intfs[0], intfs.size())) >
+     *            intfs.size()) {
+     *         intfs.resize(count);
+     *     }
+     *     intfs.resize(count);
+     *  @endcode
+     *
+     *  @throws  None.
+     **/
+    virtual unsigned int getIntfs(NxIntf **intfs, unsigned int maxCount) = 0;
+
+    /**
+     *  Read the attributes of all the open interfaces matching filter
+     *  in one call, in place of getting each interface object & calling
+     *  its getters. Refer to NxIntf::snapshot().
+     *  @param[out] snaps   Filled with a snapshot per interface. Reuse
+     *                      the vector across calls to reuse its storage.
+     *  @param[in]  filter  Interfaces to read, all of them by default.
+     *  @returns  Count of snapshots.
+     *
+     *  @code
+     *
+     *  C++:
+     *     std::vector<nxos::NxIntfSnapshot> snaps;
+     *     nxos::NxIntfFilter                filter;
+     *
+     *     filter.operState = nxos::DOWN;
+     *     intfMgr->getIntfSnapshots(&snaps, filter);
+     *     for (size_t i = 0; i < snaps.size(); i++) {
+     *         cout << snaps[i].name << " is down" << endl;
+     *     }
+     *  @endcode
+     *
+     *  @throws  None.
+     **/
+    virtual unsigned int getIntfSnapshots(std::vector<NxIntfSnapshot> *snaps,
+                                          const NxIntfFilter &filter =
+                                             NxIntfFilter()) = 0;
+
+    /**
+     *  Sample the rx & tx bytes, packets, errors & drops of a set of
+     *  interfaces every interval, in place of running "show interface"
+     *  & parsing its output. The samples are kept in a ring of the last
+     *  history intervals per interface, read with getIntfCounters() &
+     *  getIntfRates(). Replaces the set of a previous call, its samples
+     *  are dropped.
+     *  @param[in] names       Short names of the interfaces, an empty
+     *                         set stops the sampling.
+     *  @param[in] intervalMs  [Optional] Sampling interval, at least
+     *                         1000. Default is 30 secs, the default
+     *                         load-interval of NX-OS.
+     *  @param[in] history     [Optional] Samples kept per interface, at
+     *                         least 2 & at most 4096.
+     *  @returns   true if successful, false if an interface is not open
+     *             (or) the arguments are out of range.
+     *
+     *  @code
+     *
+     *  C++:
+     *       std::vector<std::string> ports;
+     *
+     *       ports.push_back("Ethernet1/1");
+     *       ports.push_back("Ethernet1/2");
+     *       intfMgr->watchIntfCounters(ports, 10000);
+     *
+     *  Python:
+     *       intfMgr.watchIntfCounters(["Ethernet1/1", "Ethernet1/2"], 10000)
+     *
+     *  @endcode
+     *
+     *  @throws  None.
+     **/
+    virtual bool watchIntfCounters(const std::vector<std::string> &names,
+                                   unsigned int intervalMs = 30000,
+                                   unsigned int history = 64) = 0;
+
+    /**
+     *  Set when NxIntfMgrHandler::postIntfCounterThresholdCb() is called
+     *  for the interfaces of watchIntfCounters(). The rates are computed
+     *  for all the interfaces at each sample & only the crossings are
+     *  delivered to the handler.
+     *  @param[in] threshold  Refer to NxIntfCounterThreshold in
+     *                        types/nx_intf_mgr.h, all 0 to not notify.
+     *  @returns   true if successful, false if clearPct > utilPct.
+     *
+     *  @code
+     *
+     *  C++:
+     *       nxos::NxIntfCounterThreshold threshold = { 80, 70, 0 };
+     *
+     *       intfMgr->setIntfCounterThreshold(threshold);
+     *  @endcode
+     *
+     *  @throws  None.
+     **/
+    virtual bool setIntfCounterThreshold(
+                         const nxos::NxIntfCounterThreshold &threshold) = 0;
+
+    /**
+     *  Get the rates & utilization of an interface of watchIntfCounters()
+     *  over its last sampling interval.
+     *  @param[in]  name   Short name of the interface.
+     *  @param[out] rates  Refer to NxIntfRates in types/nx_intf_mgr.h.
+     *  @returns  true if successful, false if the interface is not
+     *            sampled (or) has less than 2 samples.
+     *
+     *  @code
+     *
+     *  C++:
+     *       nxos::NxIntfRates rates;
+     *
+     *       if (intfMgr->getIntfRates("Ethernet1/1", &rates)) {
+     *           cout << "rx " << rates.rxUtil << "%" << endl;
+     *       }
+     *  @endcode
+     *
+     *  @throws  None.
+     **/
+    virtual bool getIntfRates(const std::string &name,
+                              nxos::NxIntfRates *rates) = 0;
+
+    /**
+     *  Get the samples kept of an interface of watchIntfCounters().
+     *  @param[in]  name     Short name of the interface.
+     *  @param[out] samples  Filled with the samples, oldest first.
+     *  @returns  Count of samples.
+     *
+     *  @throws  None.
+     **/
+    virtual unsigned int getIntfCounters(const std::string &name,
+                             std::vector<nxos::NxIntfCounters> *samples) = 0;
+
+    /**
+     *  Apply the configuration changes of many interfaces in one call
+     *  & one commit, in place of an NxIntf setter call & commit per
+     *  change. Changes of an interface are applied all (or) none: an
+     *  interface that is not open (or) with an invalid change is
+     *  skipped & reported in results, the other interfaces are still
+     *  applied.
+     *  @param[in]  txn      Refer to NxIntfConfigTxn in types/nx_intf_mgr.h.
+     *  @param[out] results  [Optional] If set, filled with the status of
+     *                       every interface of txn.
+     *  @returns  true if the changes of at least one interface were
+     *            applied, false if none were.
+     *
+     * @details
+     *     Write API - NX-SDK Applications can use this API only if security profile with permit (or) throttle is
+     *                 enabled for that application. Using this API without the appropriate security profiles will
+     *                 throw an exception. Refer to readmes/security_profiles.md for more info in NX-SDK Git repo.
+     *
+     *  @code
+     *
+     *  C++:
+     *     nxos::NxIntfConfigTxn                 txn;
+     *     std::vector<nxos::NxIntfConfigResult> results;
+     *
+     *     txn.setMtu("Ethernet1/1", 9216);
+     *     txn.setVrf("Ethernet1/1", "tenant-1");
+     *     txn.setMtu("Ethernet1/2", 9216);
+     *     intfMgr->commitIntfConfig(txn, &results);
+     *     for (size_t i = 0; i < results.size(); i++) {
+     *         if (results[i].errCode != ERR_ESUCCESS) {
+     *             cout << results[i].intfName << " failed" << endl;
+     *         }
+     *     }
+     *
+     *  Python:
+     *     txn = nx_sdk_py.NxIntfConfigTxn()
+     *     txn.setMtu("Ethernet1/1", 9216)
+     *     intfMgr.commitIntfConfig(txn)
+     *  @endcode
+     *
+     *  @throws  None.
+     **/
+    virtual bool commitIntfConfig(const nxos::NxIntfConfigTxn &txn,
+                     std::vector<nxos::NxIntfConfigResult> *results = NULL) = 0;
+
+    /**
+     *  Dampen the oper state changes delivered to
+     *  NxIntfMgrHandler::postIntfStateCb() so a flapping interface stops
+     *  waking the App. While an interface is suppressed its changes are
+     *  only counted, when it is reused its state is delivered if it
+     *  differs from the last one delivered. Disabled by default.
+     *  @param[in] policy  Refer to NxIntfDampening in types/nx_intf_mgr.h,
+     *                     a penalty of 0 disables dampening.
+     *  @param[in] name    [Optional] Short name of an interface to set its
+     *                     own policy, else the policy of all the
+     *                     interfaces without one.
+     *  @returns  true if successful, false if reuse >= suppress (or) a
+     *            value is 0.
+     *
+     *  @code
+     *
+     *  C++:
+     *       nxos::NxIntfDampening policy;   // NX-OS defaults
+     *
+     *       intfMgr->setIntfStateDampening(policy);
+     *
+     *  Python:
+     *       intfMgr.setIntfStateDampening(nx_sdk_py.NxIntfDampening())
+     *  @endcode
+     *
+     *  @throws  None.
+     **/
+    virtual bool setIntfStateDampening(const nxos::NxIntfDampening &policy,
+                                       const std::string &name = "") = 0;
+
+    /**
+     *  Conflate the oper state changes delivered to
+     *  NxIntfMgrHandler::postIntfStateCb(). A change of an interface is
+     *  delivered at once, its further changes within windowMs are
+     *  conflated into one delivery of its latest state at the end of
+     *  the window, none if it is back to the state delivered. Applied
+     *  after dampening.
+     *  @param[in] windowMs  Conflation window, 0 disables it (default).
+     *  @returns  true if successful.
+     *
+     *  @code
+     *
+     *  C++:
+     *       intfMgr->setIntfStateConflation(1000);
+     *  @endcode
+     *
+     *  @throws  None.
+     **/
+    virtual bool setIntfStateConflation(unsigned int windowMs) = 0;
+
+    /**
+     *  Get the counters of the oper state changes received, delivered,
+     *  dampened & conflated.
+     *  @param[out] stats  Refer to NxIntfEventStats in types/nx_intf_mgr.h.
+     *  @param[in]  name   [Optional] Short name of an interface for its
+     *                     own counters, else the ones of all interfaces.
+     *  @returns  true if successful, false if the interface is not open.
+     *
+     *  @code
+     *
+     *  C++:
+     *       nxos::NxIntfEventStats stats;
+     *
+     *       intfMgr->getIntfEventStats(&stats);
+     *       cout << stats.dampened << " changes dampened" << endl;
+     *  @endcode
+     *
+     *  @throws  None.
+     **/
+    virtual bool getIntfEventStats(nxos::NxIntfEventStats *stats,
+                                   const std::string &name = "") = 0;
+
+    /**
+     *  Open a system interface based on its ifindex, as getIntf(name).
+     *  @param[in] ifindex  Refer to NxIntf::getIfindex().
+     *  @returns interface object (NxIntf*) or NULL
+     *
+     *  @code
+     *
+     *  C++:
+     *     objp = intfMgr->getIntf(mac->getIfindex());
+     *
+     *  Python:
+     *     objp = intfMgr.getIntf(mac.getIfindex())
+     *  @endcode
+     *
+     *  @throws  None.
+     **/
+    virtual NxIntf *getIntf(uint32_t ifindex) = 0;
+
+    /**
+     *  Get the ifindex of an interface name in the interface dictionary
+     *  shared by the managers. The ifindex of a name never changes, even
+     *  if the interface is deleted & created again, so it can be kept
+     *  in the tables of the App & compared in place of the name.
+     *  @param[in] name  Short name of the interface, e.g Ethernet1/49/2.
+     *  @returns  ifindex, 0 if the name is not known to any manager.
+     *
+     *  @code
+     *
+     *  C++:
+     *       uint32_t uplink = intfMgr->getIfindex("Ethernet1/49/2");
+     *
+     *       if (nh->getOutIfindex() == uplink) {
+     *           // route through the uplink
+     *       }
+     *  @endcode
+     *
+     *  @throws  None.
+     **/
+    virtual uint32_t getIfindex(const std::string &name) = 0;
+
+    /**
+     *  Get the interface name of an ifindex, refer to getIfindex().
+     *  @param[in] ifindex  Interface index.
+     *  @returns  Short name, "" if the ifindex is not known.
+     *
+     *  @code
+     *
+     *  C++:
+     *       cout << intfMgr->getIntfName(adj->getIfindex()) << endl;
+     *  @endcode
+     *
+     *  @throws  None.
+     **/
+    virtual std::string getIntfName(uint32_t ifindex) = 0;
+
+    /**
+     *  Get the interfaces that carry a VLAN, i.e of which NxIntf::
+     *  getVlanSet() has it, as a bitmap over their ifindexes. Read from
+     *  an index kept up to date with every VLAN membership change, as
+     *  delivered to NxIntfMgrHandler::postIntfVlanCb(), so no interface
+     *  is read.
+     *  @param[in]  vlan   VLAN id.
+     *  @param[out] intfs  Filled with the ifindexes of the interfaces.
+     *  @returns  Count of interfaces.
+     *
+     *  @code
+     *
+     *  C++:
+     *       nxos::NxIntfBitmap intfs;
+     *
+     *       intfMgr->getVlanIntfs(2100, &intfs);
+     *       for (uint32_t i = intfs.next(0); i; i = intfs.next(i + 1)) {
+     *           cout << intfMgr->getIntfName(i) << endl;
+     *       }
+     *  Python:
+     *       intfs = nx_sdk_py.NxIntfBitmap()
+     *       print "%d interfaces" % intfMgr.getVlanIntfs(2100, intfs)
+     *  @endcode
+     *
+     *  @throws  None.
+     **/
+    virtual unsigned int getVlanIntfs(unsigned int vlan,
+                                      NxIntfBitmap *intfs) = 0;
+
+    /**
+     * Register your handler object for only some of its events,
+     * setIntfHandler(handler) registers it for all of them. The events out
+     * of eventMask are dropped before any object is built (or) any data is
+     * read for them & are counted, refer to getSkippedEventCount().
+     * @param[in] handler    NxIntfMgrHandler object with user overloaded
+     *                       functions to handle events.
+     * @param[in] eventMask  NxIntfMgrHandler::event_mask_e values OR-ed.
+     *
+     *  @code
+     *  C++:
+     *       intfMgr->setIntfHandler(myIntfCb, NxIntfMgrHandler::EVENT_STATE |
+     *                                         NxIntfMgrHandler::EVENT_ADD_DEL);
+     *
+     *  Python:
+     *       intfMgr.setIntfHandler(myIntfCb, nx_sdk_py.NxIntfMgrHandler.EVENT_STATE)
+     *  @endcode
+     **/
+    virtual void setIntfHandler(NxIntfMgrHandler *handler, uint32_t eventMask) = 0;
+
+    /**
+     * Get the count of events dropped as out of the event mask of the
+     * handler, refer to setIntfHandler(handler, eventMask).
+     * @param[in] events  [Optional] NxIntfMgrHandler::event_mask_e values
+     *                    OR-ed, a single one for the count of that event.
+     * @returns Count of events skipped, of all the events by default.
+     *
+     *  @code
+     *  C++:
+     *       cout << intfMgr->getSkippedEventCount() << " events skipped";
+     *  @endcode
+     **/
+    virtual uint64_t getSkippedEventCount(uint32_t events = 0xffffffff) = 0;
 };
 
 } // namespace nxos
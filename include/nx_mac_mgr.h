@@ -34,6 +34,7 @@
 #include <cstring>
 #include <stdexcept>
 #include "types/nx_common.h"
+#include "types/nx_mac_mgr.h"
 
 namespace nxos
 {
@@ -232,6 +233,41 @@ public:
      *
      **/
     virtual bool equal(NxMac const &mac_obj) const = 0;
+
+    /**
+     * Get the ifindex of the interface of the MAC, refer to
+     * NxIntfMgr::getIfindex().
+     *
+     * @returns ifindex (uint32_t), 0 if none.
+     *
+     *  @code
+     *  C++:
+     *       if (mac->getIfindex() == intf->getIfindex()) {
+     *           // learnt on intf
+     *       }
+     *
+     *  Python:
+     *       if mac.getIfindex() == intf.getIfindex():
+     *           print mac.getMacAddress()
+     *  @endcode
+     **/
+    virtual uint32_t getIfindex() = 0;
+
+    /**
+     * Get the MAC address & VLAN of the MAC packed in 64 bits, refer to
+     * NxMacKey.
+     *
+     * @returns NxMacKey of the MAC.
+     *
+     *  @code
+     *  C++:
+     *       macs[mac->getMacKey().key] = mac->getIfindex();
+     *
+     *  Python:
+     *       macs[mac.getMacKey().key] = mac.getIfindex()
+     *  @endcode
+     **/
+    virtual nxos::NxMacKey getMacKey() = 0;
 };
 
 /**
@@ -246,6 +282,17 @@ public:
      **/
     virtual ~NxMacMgrHandler(){};
 
+    /**
+     * Events of the handler, one bit per callback. OR them into the
+     * mask of NxMacMgr::setMacMgrHandler() to be called only for those, the
+     * others are dropped before they are built.
+     **/
+    typedef enum {
+        EVENT_MAC          = 0x001,  /// postMacHandlerCb()
+        EVENT_MAC_DOWNLOAD = 0x002,  /// postMacHandlerDownloadCb()
+        EVENT_ALL          = 0xffffffff
+    } event_mask_e;
+
     /**
      * User to overload the postMacCb callback method
      * to receive any registered MAC updates based on
@@ -721,6 +768,161 @@ public:
      *          setMacMgrHandler (or) NULL.
      **/
     virtual NxMacMgrHandler *getMacMgrHandler() = 0;
+
+    /**
+     * To add static mac on an interface by ifindex, as
+     * addStaticMac(macAddr, vlan, intf_name).
+     *
+     * @param[in] macAddr: Mac address to add
+     * @param[in] vlan   : vlan value
+     * @param[in] ifindex: Interface that connects to this mac, refer to
+     *                     NxIntfMgr::getIfindex().
+     *
+     * @details
+     *     Write API - NX-SDK Applications can use this API only if security profile with permit (or) throttle is 
+     *                 enabled for that application. Using this API without the appropriate security profiles will
+     *                 throw an exception. Refer to readmes/security_profiles.md for more info in NX-SDK Git repo.
+     *
+     * @returns True  - if successful.
+     *          False - if it not successful.
+     *
+     *  @throws ERR_INVALID macAddr or vlan or ifindex is invalid.
+     */
+    virtual bool addStaticMac(const std::string  &macAddr,
+                              const unsigned int vlan,
+                              uint32_t           ifindex) = 0;
+
+    /**
+     * Register your handler object for only some of its events,
+     * setMacMgrHandler(handler) registers it for all of them. The events out
+     * of eventMask are dropped before any object is built (or) any data is
+     * read for them & are counted, refer to getSkippedEventCount().
+     * @param[in] handler    NxMacMgrHandler object with user overloaded
+     *                       functions to handle events.
+     * @param[in] eventMask  NxMacMgrHandler::event_mask_e values OR-ed.
+     *
+     *  @code
+     *  C++:
+     *       macMgr->setMacMgrHandler(mymaccb, NxMacMgrHandler::EVENT_MAC);
+     *
+     *  Python:
+     *       macMgr.setMacMgrHandler(mymaccb, nx_sdk_py.NxMacMgrHandler.EVENT_MAC)
+     *  @endcode
+     **/
+    virtual void setMacMgrHandler(NxMacMgrHandler *handler, uint32_t eventMask) = 0;
+
+    /**
+     * Get the count of events dropped as out of the event mask of the
+     * handler, refer to setMacMgrHandler(handler, eventMask).
+     * @param[in] events  [Optional] NxMacMgrHandler::event_mask_e values
+     *                    OR-ed, a single one for the count of that event.
+     * @returns Count of events skipped, of all the events by default.
+     *
+     *  @code
+     *  C++:
+     *       cout << macMgr->getSkippedEventCount() << " events skipped";
+     *  @endcode
+     **/
+    virtual uint64_t getSkippedEventCount(uint32_t events = 0xffffffff) = 0;
+
+    /**
+     * To get the MAC object of a MAC address & VLAN packed in key, as
+     * getMac(macAddr, vlan, clearBuffer) with no string to parse. The
+     * MAC table is keyed by NxMacKey, it is found in one hash lookup.
+     * @param[in]  key  MAC address & VLAN, refer to NxMacKey.
+     * @param[in]  clearBuffer [Optional] as for getMac(macAddr, vlan).
+     * @returns NxMac Object if it exists, to be freed by the App.
+     *          NULL if it does not exist (or) key is not valid.
+     *
+     *  @code
+     *  C++:
+     *       NxMac *mac = macMgr->getMac(nxos::NxMacKey(0x001122334455ULL, 10));
+     *
+     *  Python:
+     *       mac = macMgr.getMac(nx_sdk_py.NxMacKey(0x001122334455, 10))
+     *  @endcode
+     **/
+    virtual NxMac *getMac(const nxos::NxMacKey &key,
+                          bool               clearBuffer = false) = 0;
+
+    /**
+     * To receive/subscribe for any updates to a MAC address & VLAN
+     * packed in key, as watchMac(vlan, macAddr, download).
+     * @param[in] key       MAC address & VLAN, refer to NxMacKey.
+     * @param[in] download  [Optional] Specify to get sync download of the
+     *                      existing MAC object or not (default True)
+     * @returns bool True -  if successful.
+     *               False - if not successful (or) key is not valid.
+     *
+     *  @code
+     *  C++:
+     *       macMgr->watchMac(nxos::NxMacKey(0x001122334455ULL, 10));
+     *
+     *  Python:
+     *       macMgr.watchMac(nx_sdk_py.NxMacKey(0x001122334455, 10))
+     *  @endcode
+     **/
+    virtual bool watchMac(const nxos::NxMacKey &key,
+                          bool               download = true) = 0;
+
+    /**
+     * To un-subscribe for updates to a MAC address & VLAN packed in key
+     * watched with watchMac(key).
+     * @param[in] key  MAC address & VLAN, refer to NxMacKey.
+     * @returns bool True -  if successful.
+     *               False - if not successful (or) key is not valid.
+     **/
+    virtual bool unwatchMac(const nxos::NxMacKey &key) = 0;
+
+    /**
+     * To add static mac of a MAC address & VLAN packed in key on an
+     * interface by ifindex, as addStaticMac(macAddr, vlan, intf_name).
+     *
+     * @param[in] key    : Mac address & vlan to add, refer to NxMacKey.
+     * @param[in] ifindex: Interface that connects to this mac, refer to
+     *                     NxIntfMgr::getIfindex().
+     *
+     * @details
+     *     Write API - NX-SDK Applications can use this API only if security profile with permit (or) throttle is 
+     *                 enabled for that application. Using this API without the appropriate security profiles will
+     *                 throw an exception. Refer to readmes/security_profiles.md for more info in NX-SDK Git repo.
+     *
+     * @returns True  - if successful.
+     *          False - if it not successful.
+     *
+     *  @code
+     *  C++:
+     *       macMgr->addStaticMac(nxos::NxMacKey(0x001122334455ULL, 10),
+     *                            intf->getIfindex());
+     *
+     *  Python:
+     *       macMgr.addStaticMac(nx_sdk_py.NxMacKey(0x001122334455, 10),
+     *                           intf.getIfindex())
+     *  @endcode
+     *
+     *  @throws ERR_INVALID key or ifindex is invalid.
+     */
+    virtual bool addStaticMac(const nxos::NxMacKey &key,
+                              uint32_t             ifindex) = 0;
+
+    /**
+     * To delete static mac of a MAC address & VLAN packed in key, as
+     * delStaticMac(macAddr, vlan).
+     * @param[in] key: Mac address & vlan to remove, refer to NxMacKey.
+     * @returns bool True  - if successful.
+     *               False - if not successful.
+     *
+     *  @code
+     *  C++:
+     *       macMgr->delStaticMac(nxos::NxMacKey(0x001122334455ULL, 10));
+     *
+     *  Python:
+     *       macMgr.delStaticMac(nx_sdk_py.NxMacKey(0x001122334455, 10))
+     *  @endcode
+     *
+     *  @throws ERR_INVALID key is invalid.
+     **/
+    virtual bool delStaticMac(const nxos::NxMacKey &key) = 0;
 };
 
 } // namespace nxos
@@ -19,6 +19,8 @@
  *
  *   @note By default, ribMgr CLI is auto-generated for the NxSDK Apps.
  *         Try "show $appname nxsdk ribmgr" in the box to access them.
+ *         "show $appname nxsdk rib-stats" shows the route statistics,
+ *         refer to getL3RouteStats().
  *
  *  @since NXSDK V1.5
  *
@@ -35,8 +37,10 @@
 #include <string>
 #include <cstring>
 #include <stdexcept>
+#include <vector>
 
 #include "nx_common.h"
+#include "types/nx_rib_mgr.h"
 
 namespace nxos
 {
@@ -450,6 +454,131 @@ public:
      *  @endcode
      **/
     virtual bool checkType(nh_types_e type) = 0;
+
+    /**
+     * To get the Address of the NextHop in binary form. Same as
+     * getAddress() without the string allocation & parsing.
+     *
+     * @returns Address of the NextHop(NxIpAddr)
+     *
+     *  @code
+     *  C++:
+     *       nxos::NxIpAddr addr = nh->getIpAddr();
+     *
+     *  Python:
+     *       addr = nh.getIpAddr()
+     *       print "NH Address: %s" % addr.toString()
+     *  @endcode
+     **/
+    virtual nxos::NxIpAddr getIpAddr() = 0;
+
+    /**
+     * To get the ifindex of the outgoing interface for the NextHop, refer
+     * to NxIntfMgr::getIfindex(). Compare it with the ifindex of an
+     * interface, MAC (or) adjacency in place of getOutInterface().
+     *
+     * @returns ifindex of the Outgoing Interface(uint32_t), 0 if none
+     *
+     *  @code
+     *  C++:
+     *       if (nh->getOutIfindex() == adj->getIfindex()) {
+     *           // resolved on the adjacency interface
+     *       }
+     *
+     *  Python:
+     *       intf = intfMgr.getIntf(nh.getOutIfindex())
+     *  @endcode
+     **/
+    virtual uint32_t getOutIfindex() = 0;
+};
+
+/**
+ * @brief Abstract Interface for a set of NextHops shared by L3 Routes.
+ *
+ * NXSDK interns the NextHops of the watched routes, so all the routes
+ * with the same set of NextHops (ex. same ECMP paths) share one group
+ * identified by its group Id. Refer to NxL3Route::getL3NextHopGroupId().
+ * A change to the NextHops of a group (ex. a NextHop going down) is
+ * sent once as a group update through postL3NextHopGroupCb instead of
+ * an update per route using it.
+ *
+ * Group objects are owned by NXSDK & must not be freed.
+ **/
+class NxL3NextHopGroup
+{
+public:
+    /**
+     * Destructor
+     **/
+    virtual ~NxL3NextHopGroup() {}
+
+    /**
+     * To get the Id of the NextHop group. Ids are unique among the
+     * current groups & can be reused once a group is deleted.
+     *
+     * @returns Group Id(uint32_t). Never 0.
+     **/
+    virtual uint32_t getId() = 0;
+
+    /**
+     * To get the count of NextHops in the group.
+     *
+     * @returns Count of NextHops(unsigned int). Can be 0 if all the
+     *          NextHops of the group went down.
+     **/
+    virtual unsigned int getL3NextHopCount() = 0;
+
+    /**
+     * To get the NextHops of the group. Works same as
+     * NxL3Route::getL3NextHop(bool fromFirst).
+     *
+     * @returns a pointer to NxL3NextHop if it exists
+     *          NULL if not.
+     *
+     *  @code
+     *  C++:
+     *       nh = group->getL3NextHop(true);
+     *       while (nh) {
+     *           cout << "NextHop " << nh->getAddress();
+     *           nh = group->getL3NextHop();
+     *       }
+     *
+     *  Python:
+     *       nh = group.getL3NextHop(True)
+     *       while nh:
+     *           print "NextHop %s" % nh.getAddress()
+     *           nh = group.getL3NextHop()
+     *  @endcode
+     **/
+    virtual NxL3NextHop *getL3NextHop(bool fromFirst = false) = 0;
+
+    /**
+     * To get the count of the watched routes using the group.
+     *
+     * @returns Count of routes(unsigned int)
+     **/
+    virtual unsigned int getRouteCount() = 0;
+
+    /**
+     * To get the type of Event(Add, Update, Delete) of the group.
+     * Should be used only in postL3NextHopGroupCb().
+     *
+     * @returns the type of event(nxos::event_type_e)
+     **/
+    virtual nxos::event_type_e getEvent() = 0;
+
+    /**
+     * To get all the NextHops of the group in one call. Works same as
+     * NxL3Route::getL3NextHops().
+     *
+     * @param[out] nextHops Caller buffer of maxCount entries.
+     * @param[in]  maxCount Size of nextHops.
+     *
+     * @returns Count of NextHops of the group(unsigned int), can be more
+     *          than maxCount.
+     **/
+    virtual unsigned int getL3NextHops(NxL3NextHop **nextHops,
+                                       unsigned int maxCount) = 0;
 };
 
 /**
@@ -936,6 +1065,126 @@ public:
      *  @endcode
      **/
     virtual std::string getL3Prefix() const=0;
+
+    /**
+     * To get the prefix of the L3 Route in binary form. Same as
+     * getAddress() & getMaskLen() without the string allocation
+     * & parsing.
+     *
+     * @returns Prefix of the L3 Route(NxPrefix)
+     *
+     *  @code
+     *  C++:
+     *       nxos::NxPrefix prefix = route->getPrefix();
+     *       if (prefix.contains(addr)) ...
+     *
+     *  Python:
+     *       prefix = route.getPrefix()
+     *       print "Route Prefix: %s" % prefix.toString()
+     *  @endcode
+     **/
+    virtual nxos::NxPrefix getPrefix() const = 0;
+
+    /**
+     * Binary address overloads of getL3NextHop(), addL3DirectNextHop(),
+     * addL3RecursiveNextHop() & delL3NextHop(). Behave the same as the
+     * string versions. Address family of the next-hop must match the
+     * route.
+     *
+     *  @code
+     *  C++:
+     *       nxos::NxIpAddr nhAddr;
+     *
+     *       nhAddr.fromString("10.1.1.3");
+     *       route->addL3DirectNextHop(nhAddr, "Eth1/3", 12);
+     *
+     *  Python:
+     *       nhAddr = nx_sdk_py.NxIpAddr()
+     *       nhAddr.fromString("10.1.1.3")
+     *       route.addL3DirectNextHop(nhAddr, "Eth1/3", 12)
+     *  @endcode
+     **/
+    virtual NxL3NextHop *getL3NextHop(const nxos::NxIpAddr &address,
+                                      const std::string    &intfName="") = 0;
+    virtual NxL3NextHop *addL3DirectNextHop(const nxos::NxIpAddr &nextHopAddr,
+                                            const std::string    &intfName,
+                                            uint8_t              preference)=0;
+    virtual NxL3NextHop *addL3RecursiveNextHop(const nxos::NxIpAddr &nextHopAddr,
+                                               uint8_t              preference)=0;
+    virtual bool delL3NextHop(const nxos::NxIpAddr &nextHopAddr,
+                              const std::string    &intfName="")=0;
+
+    /**
+     * To get the Id of the NextHop group the route uses. Routes with
+     * the same set of NextHops share the group. Refer to NxL3NextHopGroup.
+     *
+     * @returns Group Id(uint32_t).
+     *          0 if the NextHops are not shared (ex. routes added by
+     *          the App through addL3Route).
+     *
+     *  @code
+     *  C++:
+     *       NxL3NextHopGroup *group;
+     *
+     *       group = ribMgr->getL3NextHopGroup(route->getL3NextHopGroupId());
+     *
+     *  Python:
+     *       group = ribMgr.getL3NextHopGroup(route.getL3NextHopGroupId())
+     *  @endcode
+     **/
+    virtual uint32_t getL3NextHopGroupId() = 0;
+
+    /**
+     * To get all the NextHops of the route in one call into a buffer of
+     * the caller, in place of looping over getL3NextHop(bool fromFirst).
+     * Unlike getL3NextHop(), it keeps no cursor in the route, so any
+     * number of threads can read the same route at once as long as it
+     * is not modified meanwhile.
+     *
+     * @param[out] nextHops Caller buffer of maxCount entries. The
+     *                      NextHops are owned by the route.
+     * @param[in]  maxCount Size of nextHops. Only the first maxCount
+     *                      NextHops are filled in.
+     *
+     * @returns Count of NextHops of the route(unsigned int), can be more
+     *          than maxCount. Call again with a larger buffer if so.
+     *
+     *  @code
+     *  C++:
+     *       NxL3NextHop  *nhs[32];
+     *       unsigned int  count = route->getL3NextHops(nhs, 32);
+     *
+     *       for (unsigned int i = 0; (i < count) && (i < 32); i++) {
+     *           cout << "NextHop " << nhs[i]->getIpAddr().toString();
+     *       }
+     *  @endcode
+     **/
+    virtual unsigned int getL3NextHops(NxL3NextHop **nextHops,
+                                       unsigned int maxCount) = 0;
+};
+
+/**
+ * @brief Visitor of the prefix queries of NxRibMgr ex.
+ *        forEachMoreSpecific(). User to overload visit().
+ **/
+class NxL3RouteVisitor
+{
+public:
+    /**
+     * Destructor.
+     **/
+    virtual ~NxL3RouteVisitor() {}
+
+    /**
+     * Called for each watched route matching the query.
+     *
+     * @param[in]  route Watched route, only valid during the call. Do
+     *                   not add or delete routes from it.
+     *
+     * @returns True : to visit the next route.
+     *          False: to stop the query.
+     **/
+    virtual bool visit(NxL3Route *route) = 0;
 };
 
 /*
@@ -950,6 +1199,23 @@ public:
      **/
     virtual ~NxRibMgrHandler(){};
 
+    /**
+     * Events of the handler, one bit per callback. OR them into the
+     * mask of NxRibMgr::setRibMgrHandler() to be called only for those, the
+     * others are dropped before they are built.
+     **/
+    typedef enum {
+        EVENT_L3_ROUTE              = 0x001,  /// postL3RouteCb() & postL3RouteBatchCb()
+        EVENT_VRF                   = 0x002,  /// postVrfCb()
+        EVENT_L3_RECURSIVE_NEXT_HOP = 0x004,  /// postL3RecursiveNextHopCb()
+        EVENT_MY_L3_ROUTE           = 0x008,  /// postMyL3RouteCb()
+        EVENT_L3_ROUTE_REPOPULATE   = 0x010,  /// postL3RouteRepopulateCb()
+        EVENT_L3_NEXT_HOP_GROUP     = 0x020,  /// postL3NextHopGroupCb()
+        EVENT_L3_ROUTE_ASYNC        = 0x040,  /// postL3RouteAsyncCb()
+        EVENT_RIB_CONVERGED         = 0x080,  /// postRibConvergedCb()
+        EVENT_ALL                   = 0xffffffff
+    } event_mask_e;
+
     /**
      * User to overload the postL3RouteCb callback method
      * to receive any registered route updates based on the
@@ -1076,6 +1342,10 @@ public:
      *         myribcb = myRibMgrHandler()
      *         ribMgr.setRibMgrHandler(myribcb)
      *  @endcode
+     *
+     * @note Also called when the watched route a recursive next-hop
+     *       resolves through changes, only for the routes affected.
+     *       Refer to getL3RecursiveNextHopRoutes().
      **/
     virtual bool postL3RecursiveNextHopCb(NxL3Route *rnhRoute, 
                                           bool      isResolved) { return (true);}
@@ -1176,11 +1446,189 @@ public:
      *         myribcb = myRibMgrHandler()
      *         ribMgr.setRibMgrHandler(myribcb)
      *  @endcode
+     *
+     * @note Also called for each stale route of the App loaded from the
+     *       warm restart snapshot. Refer to enableL3RouteSnapshot().
      **/
 
     virtual void postL3RouteRepopulateCb(const std::string vrfName,
                                          const std::string routeAddress,
                                          unsigned char     maskLen=0) {}
+
+    /**
+     * User to overload the postL3RouteBatchCb callback method to receive
+     * the registered route updates in batches instead of one postL3RouteCb
+     * call per route. Called only if batching is enabled using
+     * setL3RouteBatch().
+     *
+     * Routes in a batch are in the order they were received, so multiple
+     * updates of the same prefix are always delivered in order. The route
+     * objects are valid only during the callback.
+     * By default, postL3RouteCb is called for every route in the batch.
+     *
+     * @param[in]  routes Batch of NxL3Route objects.
+     *
+     * @returns True : if the action was successful.
+     *          False: if the action was not successful.
+     *
+     *  @code
+     *  C++:
+     *     #include <nx_sdk.h>
+     *     #include <nx_rib_mgr.h>
+     *
+     *     class myRibMgrMgrHandler : public NxRibMgrHandler {
+     *        public:
+     *           bool postL3RouteBatchCb(const std::vector<NxL3Route *> &routes) {
+     *                for (size_t i = 0; i < routes.size(); i++) {
+     *                    // Do your action on routes[i]
+     *                }
+     *           }
+     *     };
+     *
+     *     int  main (int argc, char **argv)
+     *     {
+     *          NxSdk    *sdk = nxos::NxSdk::getSdkInst(argc, argv);
+     *          NxRibMgr *ribMgr = sdk->getRibMgr();
+     *          NxRibMgrHandler *myribcb = new myRibMgrHandler();
+     *          ribMgr->setRibMgrHandler(myribcb);
+     *          ribMgr->setL3RouteBatch(1000, 100);
+     *     }
+     *
+     *  Python:
+     *     import nx_sdk_py
+     *
+     *     class myRibMgrHandler(nx_sdk_py.NxRibMgrHandler):
+     *     ### Overloaded Callback to get batched Route events
+     *           def postL3RouteBatchCb(self, nxroutes):
+     *               for nxroute in nxroutes:
+     *                   # Do your action here
+     *
+     *     # Do SDK related inits in one thread.
+     *     def sdkThread(name,val):
+     *         sdk = nx_sdk_py.NxSdk.getSdkInst(len(sys.argv), sys.argv)
+     *         ribMgr = sdk.getRibMgr()
+     *         myribcb = myRibMgrHandler()
+     *         ribMgr.setRibMgrHandler(myribcb)
+     *         ribMgr.setL3RouteBatch(1000, 100)
+     *  @endcode
+     **/
+    virtual bool postL3RouteBatchCb(const std::vector<NxL3Route *> &routes)
+    {
+        bool ret = true;
+
+        for (size_t i = 0; i < routes.size(); i++) {
+            if (!postL3RouteCb(routes[i])) ret = false;
+        }
+        return (ret);
+    }
+
+    /**
+     * User to overload the postL3NextHopGroupCb callback method to
+     * receive the changes to the NextHop groups of the watched routes.
+     * A group is added before the first route using it is sent, updated
+     * when its NextHops change & deleted after the last route using it
+     * is gone. An update applies to all the routes using the group i.e
+     * no route update is sent for them. When a NextHop going down leaves
+     * a group with the NextHops of another group, its routes move to the
+     * other group, each sent as a route update, & the group is deleted.
+     * A group left with no NextHops is kept for its routes till RIB
+     * updates (or) withdraws them.
+     *
+     * @param[in]  NxL3NextHopGroup object.
+     *
+     * @returns True : if the action was successful.
+     *          False: if the action was not successful.
+     *
+     *  @code
+     *  C++:
+     *     class myRibMgrHandler : public NxRibMgrHandler {
+     *        public:
+     *           bool postL3NextHopGroupCb(NxL3NextHopGroup *group) {
+     *                if (group->getEvent() == nxos::UPDATE) {
+     *                    // Reprogram the paths of group->getId()
+     *                }
+     *                return true;
+     *           }
+     *     };
+     *
+     *  Python:
+     *     class myRibMgrHandler(nx_sdk_py.NxRibMgrHandler):
+     *           def postL3NextHopGroupCb(self, group):
+     *               if group.getEvent() == nx_sdk_py.UPDATE:
+     *                   # Reprogram the paths of group.getId()
+     *               return True
+     *  @endcode
+     **/
+    virtual bool postL3NextHopGroupCb(NxL3NextHopGroup *group) { return (true); }
+
+    /**
+     * User to overload the postL3RouteAsyncCb callback method to
+     * receive the completion of a request made with addL3RoutesAsync(),
+     * delL3RoutesAsync() (or) sendMyL3RoutesToRibAsync(). Requests
+     * complete in the order they were made, unless pacing is enabled,
+     * refer to NxRibMgr::enableL3RoutePacing(). postMyL3RouteCb is
+     * called for the routes of the request before its completion.
+     *
+     * @param[in]  reqId  Id returned when the request was made.
+     * @param[in]  result Same as the return value of the synchronous
+     *                    API i.e true if the request was committed.
+     * @param[in]  errs   Index & error code of every record that failed,
+     *                    empty if all were committed.
+     *
+     *  @code
+     *  C++:
+     *     class myRibMgrHandler : public NxRibMgrHandler {
+     *        public:
+     *           void postL3RouteAsyncCb(uint64_t reqId, bool result,
+     *                   const std::vector<nxos::nx_l3_route_rec_err> &errs) {
+     *                // Release the records of reqId, send the next batch.
+     *           }
+     *     };
+     *
+     *  Python:
+     *     class myRibMgrHandler(nx_sdk_py.NxRibMgrHandler):
+     *           def postL3RouteAsyncCb(self, reqId, result, errs):
+     *               # Release the records of reqId, send the next batch.
+     *  @endcode
+     **/
+    virtual void postL3RouteAsyncCb(uint64_t reqId, bool result,
+                                    const std::vector<nxos::nx_l3_route_rec_err> &errs) {}
+
+    /**
+     * User to overload the postRibConvergedCb callback method to be
+     * notified when RIB is done downloading the watched routes of a VRF
+     * i.e after watchL3Route() (or) a restart, instead of polling from
+     * a timer. All the routes of the download were delivered through
+     * postL3RouteCb (or) postL3RouteBatchCb before it is called.
+     *
+     * @param[in]  af      Address family of the download.
+     * @param[in]  vrfName VRF of the download, "all" if the watch of
+     *                     all the VRFs got no route.
+     * @param[in]  timing  When the download started, its first & last
+     *                     route arrived, it was done & its route count.
+     *
+     *  @code
+     *  C++:
+     *     class myRibMgrHandler : public NxRibMgrHandler {
+     *        public:
+     *           void postRibConvergedCb(nxos::af_e af,
+     *                   const std::string &vrfName,
+     *                   const nxos::NxRibConvergence &timing) {
+     *                if (timing.convergedMs - timing.downloadStartMs > 30000) {
+     *                    // Raise the convergence SLO alert.
+     *                }
+     *           }
+     *     };
+     *
+     *  Python:
+     *     class myRibMgrHandler(nx_sdk_py.NxRibMgrHandler):
+     *           def postRibConvergedCb(self, af, vrfName, timing):
+     *               if timing.convergedMs - timing.downloadStartMs > 30000:
+     *                   # Raise the convergence SLO alert.
+     *  @endcode
+     **/
+    virtual void postRibConvergedCb(nxos::af_e af, const std::string &vrfName,
+                                    const nxos::NxRibConvergence &timing) {}
 };
 
 /**
@@ -1410,6 +1858,10 @@ public:
      *          NULL if not (VrfName empty (or) "all", Vrf does
      *          not exist, down or invalid, no route etc).
      *
+     * @note If the route cache is enabled for the VRF/AF, address lookups
+     *       with maskLen 0 are served from the local cache. Refer to
+     *       enableL3RouteCache().
+     *
      * @code
      *  C++:
      *       #include <nx_sdk.h>
@@ -1754,7 +2206,9 @@ public:
     /**
      * Tell Route information base that all routes belonging to the application
      * were programmed. This is needed after system switch over and the 
-     * application has added all its routes.
+     * application has added all its routes. To know when RIB is done
+     * downloading the watched routes, there is no need to poll, overload
+     * NxRibMgrHandler::postRibConvergedCb().
      * @param[in] af Address Family
      * @param[in] vrfName Name of the VRF
      *                    
@@ -1782,6 +2236,827 @@ public:
      **/
     virtual bool converged(nxos::af_e  af=nxos::AF_IPV4, 
                            const std::string &vrfName="all") = 0;
+
+    /**
+     * To add a batch of L3 Routes of a VRF & Address family in one call.
+     * Unlike addL3Route(), no NxL3Route objects are created and the whole
+     * batch is committed to RIB in one transaction i.e there is no need to
+     * call sendMyL3RoutesToRib() for the routes in the batch.
+     *
+     * For every prefix in the batch, its next-hops are set to the next-hops
+     * listed in the batch for that prefix, so re-sending the same batch is
+     * harmless. Invalid records (bad address, maskLen or address family
+     * mismatch) are skipped and reported in errs, rest of the batch is
+     * still committed.
+     * postMyL3RouteCb is called for the committed routes just like
+     * sendMyL3RoutesToRib().
+     *
+     * @param[in] routes Contiguous array of prefix + next-hop records.
+     *                   Refer to nx_l3_route_rec in types/nx_rib_mgr.h.
+     * @param[in] vrfName [Optional] VrfName to add the routes in.
+     *                    If not set "default" will be used.
+     *                    vrfName cannot be "all" or empty string "".
+     * @param[in] af [Optional] Address family of all the routes in the
+     *               batch. If not set AF_IPV4 will be used.
+     * @param[out] errs [Optional] If set, filled with the index and error
+     *                  code of every record that failed. Left empty if
+     *                  all the records were committed.
+     *
+     * @returns true if the batch was committed to RIB.
+     *          false if nothing could be committed.
+     *
+     * @details
+     *     Write API - NX-SDK Applications can use this API only if security profile with permit (or) throttle is 
+     *                 enabled for that application. Using this API without the appropriate security profiles will
+     *                 throw an exception. Refer to readmes/security_profiles.md for more info in NX-SDK Git repo.
+     *
+     *  @code
+     *  C++:
+     *       #include <nx_sdk.h>
+     *       #include <nx_rib_mgr.h>
+     *
+     *       std::vector<nxos::nx_l3_route_rec>     routes;
+     *       std::vector<nxos::nx_l3_route_rec_err> errs;
+     *
+     *       sdk = nxos::NxSdk::getSdkInst(argc, argv);
+     *       ribMgr = sdk->getRibMgr();
+     *
+     *       // Fill routes, refer to nx_l3_route_rec.
+     *       if (ribMgr->addL3Routes(routes, "default", nxos::AF_IPV4, &errs)) {
+     *           for (size_t i = 0; i < errs.size(); i++) {
+     *               cout << "Route " << routes[errs[i].index].address
+     *                    << " failed with " << errs[i].errCode;
+     *           }
+     *       }
+     *
+     *  Python:
+     *       import nx_sdk_py
+     *       sdk = nx_sdk_py.NxSdk.getSdkInst(len(sys.argv), sys.argv)
+     *       ribMgr = sdk.getRibMgr()
+     *
+     *       routes = nx_sdk_py.nx_l3_route_rec_vector()
+     *       # Fill routes, refer to nx_l3_route_rec.
+     *       result = ribMgr.addL3Routes(routes, "default", nx_sdk_py.AF_IPV4)
+     *  @endcode
+     *
+     *  @throws invalid Address family
+     *  @throws vrfName is more than 32 characters.
+     **/
+    virtual bool addL3Routes(const std::vector<nxos::nx_l3_route_rec> &routes,
+                             const std::string &vrfName = "default",
+                             nxos::af_e        af      = nxos::AF_IPV4,
+                             std::vector<nxos::nx_l3_route_rec_err> *errs = NULL) = 0;
+
+    /**
+     * To delete a batch of L3 Routes of a VRF & Address family and all
+     * their next-hops owned by the application in one call. The whole
+     * batch is committed to RIB in one transaction.
+     * Only address & maskLen of the records are used. Deleting a route
+     * that was not added by the application is reported as ERR_NOT_FOUND.
+     *
+     * @param[in] routes Contiguous array of prefix records.
+     * @param[in] vrfName [Optional] VrfName to delete the routes from.
+     *                    If not set "default" will be used.
+     *                    vrfName cannot be "all" or empty string "".
+     * @param[in] af [Optional] Address family of all the routes in the
+     *               batch. If not set AF_IPV4 will be used.
+     * @param[out] errs [Optional] If set, filled with the index and error
+     *                  code of every record that failed.
+     *
+     * @returns true if the batch was committed to RIB.
+     *          false if nothing could be committed.
+     *
+     * @details
+     *     Write API - NX-SDK Applications can use this API only if security profile with permit (or) throttle is 
+     *                 enabled for that application. Using this API without the appropriate security profiles will
+     *                 throw an exception. Refer to readmes/security_profiles.md for more info in NX-SDK Git repo.
+     *
+     *  @code
+     *  C++:
+     *       #include <nx_sdk.h>
+     *       #include <nx_rib_mgr.h>
+     *
+     *       std::vector<nxos::nx_l3_route_rec> routes;
+     *
+     *       sdk = nxos::NxSdk::getSdkInst(argc, argv);
+     *       ribMgr = sdk->getRibMgr();
+     *
+     *       bool result = ribMgr->delL3Routes(routes, "default", nxos::AF_IPV4);
+     *
+     *  Python:
+     *       import nx_sdk_py
+     *       sdk = nx_sdk_py.NxSdk.getSdkInst(len(sys.argv), sys.argv)
+     *       ribMgr = sdk.getRibMgr()
+     *
+     *       result = ribMgr.delL3Routes(routes, "default", nx_sdk_py.AF_IPV4)
+     *  @endcode
+     *
+     *  @throws invalid Address family
+     *  @throws vrfName is more than 32 characters.
+     **/
+    virtual bool delL3Routes(const std::vector<nxos::nx_l3_route_rec> &routes,
+                             const std::string &vrfName = "default",
+                             nxos::af_e        af      = nxos::AF_IPV4,
+                             std::vector<nxos::nx_l3_route_rec_err> *errs = NULL) = 0;
+
+    /**
+     * To enable (or) disable the local route cache of a VRF & Address
+     * family. Once enabled, NXSDK keeps a local longest prefix match (LPM)
+     * table of the VRF/AF in sync with the route updates received for the
+     * watchL3Route() filters, before postL3RouteCb is called. Address
+     * lookups using getL3Route() with maskLen 0 (or) lookupL3Route() are
+     * then served from the local table without going to NXOS RIB.
+     *
+     * NOTE: The cache holds only the routes of the watched protocols. Watch
+     *       all the protocols the lookups need to resolve to. Disabling the
+     *       cache frees it.
+     *
+     * @param[in] af [Optional] Address family of the cache.
+     *               If not set AF_IPV4 will be used.
+     * @param[in] vrfName [Optional] VrfName of the cache. If not set
+     *                    "default" will be used. vrfName cannot be "all"
+     *                    or empty string "".
+     * @param[in] enable [Optional] True to enable, False to disable.
+     *
+     * @returns true if successful.
+     *          false if not (invalid AF, VrfName empty (or) "all").
+     *
+     *  @code
+     *  C++:
+     *       #include <nx_sdk.h>
+     *       #include <nx_rib_mgr.h>
+     *
+     *       sdk = nxos::NxSdk::getSdkInst(argc, argv);
+     *       ribMgr = sdk->getRibMgr();
+     *
+     *       ribMgr->enableL3RouteCache(nxos::AF_IPV4, "default");
+     *       ribMgr->watchL3Route("bgp", "100", "default", nxos::AF_IPV4);
+     *
+     *  Python:
+     *       import nx_sdk_py
+     *       sdk = nx_sdk_py.NxSdk.getSdkInst(len(sys.argv), sys.argv)
+     *       ribMgr = sdk.getRibMgr()
+     *
+     *       ribMgr.enableL3RouteCache(nx_sdk_py.AF_IPV4, "default")
+     *       ribMgr.watchL3Route("bgp", "100", "default", nx_sdk_py.AF_IPV4)
+     *  @endcode
+     *
+     *  @throws vrfName is more than 32 characters.
+     **/
+    virtual bool enableL3RouteCache(nxos::af_e        af      = nxos::AF_IPV4,
+                                    const std::string &vrfName = "default",
+                                    bool              enable  = true) = 0;
+
+    /**
+     * To get the best matching L3 Route of an address from the local route
+     * cache of the VRF. Refer to enableL3RouteCache(). Unlike getL3Route(),
+     * no new object is created i.e the returned route is owned by NXSDK,
+     * must not be freed and is valid only till the next route update
+     * is processed (or) the cache is disabled.
+     *
+     * @param[in] address IPv4 (or) IPv6 address as a string.
+     * @param[in] vrfName [Optional] VrfName of the cache. If not set
+     *                    "default" will be used.
+     *
+     * @returns NxL3Route object of the longest matching prefix.
+     *          NULL if not (cache not enabled, invalid address, no route).
+     *
+     *  @code
+     *  C++:
+     *       #include <nx_sdk.h>
+     *       #include <nx_rib_mgr.h>
+     *
+     *       NxL3Route    *route;
+     *
+     *       sdk = nxos::NxSdk::getSdkInst(argc, argv);
+     *       ribMgr = sdk->getRibMgr();
+     *
+     *       route = ribMgr->lookupL3Route("10.1.1.1", "default");
+     *       if (route) cout << "Matched " << route->getL3Prefix();
+     *
+     *  Python:
+     *       import nx_sdk_py
+     *       sdk = nx_sdk_py.NxSdk.getSdkInst(len(sys.argv), sys.argv)
+     *       ribMgr = sdk.getRibMgr()
+     *
+     *       route = ribMgr.lookupL3Route("10.1.1.1", "default")
+     *       if route:
+     *          print "Matched %s" % route.getL3Prefix()
+     *  @endcode
+     **/
+    virtual NxL3Route *lookupL3Route(const std::string &address,
+                                     const std::string &vrfName = "default") = 0;
+
+    /**
+     * To enable (or) disable batched delivery of the watched route updates.
+     * Once enabled, route updates are queued and delivered through
+     * postL3RouteBatchCb when either maxRoutes updates are queued (or)
+     * the oldest queued update has waited for maxDelayMs, whichever
+     * happens first. Use this to cut the per route callback overhead
+     * during a full table download or a route flap.
+     *
+     * @param[in] maxRoutes Max number of route updates in a batch.
+     *                      0 (or) 1 disables batching and any queued
+     *                      updates are delivered right away.
+     * @param[in] maxDelayMs [Optional] Max time in milliseconds a route
+     *                       update can be queued. If not set 100ms
+     *                       will be used.
+     *
+     * @returns true if successful.
+     *
+     *  @code
+     *  C++:
+     *       #include <nx_sdk.h>
+     *       #include <nx_rib_mgr.h>
+     *
+     *       sdk = nxos::NxSdk::getSdkInst(argc, argv);
+     *       ribMgr = sdk->getRibMgr();
+     *
+     *       ribMgr->setL3RouteBatch(1000, 100);
+     *
+     *  Python:
+     *       import nx_sdk_py
+     *       sdk = nx_sdk_py.NxSdk.getSdkInst(len(sys.argv), sys.argv)
+     *       ribMgr = sdk.getRibMgr()
+     *
+     *       ribMgr.setL3RouteBatch(1000, 100)
+     *  @endcode
+     **/
+    virtual bool setL3RouteBatch(unsigned int maxRoutes,
+                                 unsigned int maxDelayMs = 100) = 0;
+
+    /**
+     * Binary prefix overloads of getL3Route(), getL3RouteDetail(),
+     * addL3Route() & delL3Route(). Behave the same as the string versions
+     * except that prefix.maskLen is taken as is i.e use /32 (or) /128 for
+     * a host route, 0 is the default route. getL3Route() of a host route
+     * is served from the route cache like maskLen 0 of the string version.
+     *
+     * @param[in] prefix IPv4 (or) IPv6 prefix. AF of the route is picked
+     *                   from the prefix.
+     * @param[in] vrfName [Optional] VrfName in which the route is
+     *                    present. If not set "default" will be used.
+     *
+     *  @code
+     *  C++:
+     *       nxos::NxPrefix prefix;
+     *
+     *       prefix.fromString("10.1.1.0/24");
+     *       route = ribMgr->addL3Route(prefix, "default");
+     *       route->addL3RecursiveNextHop(nhAddr, 1);
+     *       ribMgr->sendMyL3RoutesToRib(nxos::AF_IPV4);
+     *
+     *  Python:
+     *       prefix = nx_sdk_py.NxPrefix()
+     *       prefix.fromString("10.1.1.0/24")
+     *       route = ribMgr.addL3Route(prefix, "default")
+     *  @endcode
+     **/
+    virtual NxL3Route *getL3Route(const nxos::NxPrefix &prefix,
+                                  const std::string    &vrfName     = "default",
+                                  bool                 clearBuffer = false) = 0;
+    virtual NxL3Route *getL3RouteDetail(const nxos::NxPrefix &prefix,
+                                        const std::string    &vrfName = "default") = 0;
+    virtual NxL3Route *addL3Route(const nxos::NxPrefix &prefix,
+                                  const std::string    &vrfName = "default") = 0;
+    virtual bool delL3Route(const nxos::NxPrefix &prefix,
+                            const std::string    &vrfName = "default") = 0;
+
+    /**
+     * Binary address overload of lookupL3Route(). Lookups do no
+     * allocation & no parsing.
+     *
+     *  @code
+     *  C++:
+     *       nxos::NxIpAddr addr;
+     *
+     *       addr.fromString("10.1.1.1");
+     *       route = ribMgr->lookupL3Route(addr, "default");
+     *
+     *  Python:
+     *       addr = nx_sdk_py.NxIpAddr()
+     *       addr.fromString("10.1.1.1")
+     *       route = ribMgr.lookupL3Route(addr, "default")
+     *  @endcode
+     **/
+    virtual NxL3Route *lookupL3Route(const nxos::NxIpAddr &address,
+                                     const std::string    &vrfName = "default") = 0;
+
+    /**
+     * To get a NextHop group of the watched routes by its Id. Refer to
+     * NxL3NextHopGroup. The returned object is owned by NXSDK, must not
+     * be freed & is valid till the group is deleted.
+     *
+     * @param[in] groupId Id of the group.
+     *
+     * @returns NxL3NextHopGroup object if it exists.
+     *          NULL if not.
+     *
+     *  @code
+     *  C++:
+     *       group = ribMgr->getL3NextHopGroup(route->getL3NextHopGroupId());
+     *
+     *  Python:
+     *       group = ribMgr.getL3NextHopGroup(route.getL3NextHopGroupId())
+     *  @endcode
+     **/
+    virtual NxL3NextHopGroup *getL3NextHopGroup(uint32_t groupId) = 0;
+
+    /**
+     * To enable (or) disable the warm restart snapshot of the routes
+     * tracked by NXSDK. Once enabled, the watched routes & the routes
+     * added by the App are saved to a versioned memory mapped file at
+     * path every intervalSec seconds if they changed, and on
+     * saveL3RouteSnapshot().
+     *
+     * If a valid snapshot exists at path when enabled (ex. after the App
+     * restarted), it is loaded in place of a full download:
+     *  - Watched routes are sent right away through postL3RouteCb with
+     *    event DOWNLOAD & are marked stale. As RIB downloads the routes
+     *    again, only the routes that differ are sent. Stale routes that
+     *    RIB no longer has are sent as DELETE once the download is done.
+     *  - Routes added by the App are marked stale & postL3RouteRepopulateCb
+     *    is called for each of them. The App re-adds the routes it still
+     *    needs, stale routes left are deleted on converged().
+     * A snapshot of another version is ignored.
+     *
+     * @param[in] path File to save the snapshot to & load it from.
+     * @param[in] intervalSec [Optional] Min seconds between periodic saves.
+     *                        0 saves only on saveL3RouteSnapshot(). If not
+     *                        set 60 will be used.
+     * @param[in] enable [Optional] False to stop saving. The file is left
+     *                   as is.
+     *
+     * @returns true if successful.
+     *          false if path is empty.
+     *
+     *  @code
+     *  C++:
+     *       ribMgr->setRibMgrHandler(myribcb);
+     *       ribMgr->enableL3RouteSnapshot("/bootflash/myApp.rib", 60);
+     *       ribMgr->watchL3Route("bgp", "100", "default", nxos::AF_IPV4);
+     *
+     *  Python:
+     *       ribMgr.setRibMgrHandler(myribcb)
+     *       ribMgr.enableL3RouteSnapshot("/bootflash/myApp.rib", 60)
+     *       ribMgr.watchL3Route("bgp", "100", "default", nx_sdk_py.AF_IPV4)
+     *  @endcode
+     **/
+    virtual bool enableL3RouteSnapshot(const std::string &path,
+                                       unsigned int      intervalSec = 60,
+                                       bool              enable      = true) = 0;
+
+    /**
+     * To save the warm restart snapshot now. Refer to
+     * enableL3RouteSnapshot(). The file is replaced atomically.
+     *
+     * @returns true if saved.
+     *          false if the snapshot is not enabled (or) the file
+     *          could not be written.
+     *
+     *  @code
+     *  C++:
+     *       ribMgr->saveL3RouteSnapshot();
+     *
+     *  Python:
+     *       ribMgr.saveL3RouteSnapshot()
+     *  @endcode
+     **/
+    virtual bool saveL3RouteSnapshot() = 0;
+
+    /**
+     * To register for route updates of protocol, same as
+     * watchL3Route(protocol, tag, vrfName, af), with the updates
+     * further narrowed down by filter. Refer to NxL3RouteFilter in
+     * [types/nx_rib_mgr.h](types/nx_rib_mgr.h).
+     *
+     * The filter is compiled once & applied to the updates from RIB
+     * before any NxL3Route is built. A route that stops passing the
+     * filter (ex. its metric went over maxMetric) is sent as DELETE.
+     * Watching the same protocol, tag, vrfName & af again replaces the
+     * filter, unwatchL3Route() removes it.
+     *
+     * @param[in] protocol Owner of the routes in NX RIB.
+     * @param[in] tag Instance id of the owner, "" for all.
+     * @param[in] vrfName VRF of the routes, "all" for all VRFs.
+     * @param[in] af Address family of the routes, MAX_AF for all.
+     * @param[in] filter Prefix ranges & next-hop conditions.
+     *
+     * @returns true if successful.
+     *          false if vrfName is empty (or) a prefix range of filter
+     *          is not within its address family, as checked by
+     *          NxL3RouteFilter::addPrefixRange().
+     *
+     *  @code
+     *  C++:
+     *       nxos::NxL3RouteFilter filter;
+     *
+     *       filter.addPrefixRange("10.1.0.0/16", 24, 24);
+     *       filter.nhIntfName = "Ethernet1/1";
+     *       ribMgr->watchL3Route("bgp", "100", "default", nxos::AF_IPV4,
+     *                            filter);
+     *
+     *  Python:
+     *       filter = nx_sdk_py.NxL3RouteFilter()
+     *       filter.addPrefixRange("10.1.0.0/16", 24, 24)
+     *       filter.nhIntfName = "Ethernet1/1"
+     *       ribMgr.watchL3Route("bgp", "100", "default", nx_sdk_py.AF_IPV4,
+     *                           filter)
+     *  @endcode
+     **/
+    virtual bool watchL3Route(const std::string           &protocol,
+                              const std::string           &tag,
+                              const std::string           &vrfName,
+                              nxos::af_e                  af,
+                              const nxos::NxL3RouteFilter &filter) = 0;
+
+    /**
+     * To get the routes added by the App whose recursive next-hops
+     * resolve through a watched route.
+     *
+     * NXSDK keeps an index of the recursive next-hops of the App routes
+     * (refer to addL3RecursiveNextHop()) against the longest watched
+     * route covering each of them. When a watched route is added,
+     * changed (or) deleted, only the next-hops under it are resolved
+     * again & postL3RecursiveNextHopCb is called only for the App routes
+     * using them. Watch the routes (ex. IGP) the next-hops resolve
+     * through using watchL3Route().
+     *
+     * @param[in] prefix Prefix of the watched (resolving) route.
+     * @param[in] vrfName [Optional] VRF of the routes. If not set
+     *                    "default" will be used.
+     * @param[out] routes [Optional] Filled with the prefixes of the App
+     *                    routes depending on prefix.
+     *
+     * @returns Number of App routes depending on prefix.
+     *
+     *  @code
+     *  C++:
+     *       nxos::NxPrefix              igp;
+     *       std::vector<nxos::NxPrefix> deps;
+     *
+     *       igp.fromString("192.168.1.0/24");
+     *       ribMgr->getL3RecursiveNextHopRoutes(igp, "default", &deps);
+     *
+     *  Python:
+     *       igp = nx_sdk_py.NxPrefix()
+     *       igp.fromString("192.168.1.0/24")
+     *       count = ribMgr.getL3RecursiveNextHopRoutes(igp, "default")
+     *  @endcode
+     **/
+    virtual unsigned int
+    getL3RecursiveNextHopRoutes(const nxos::NxPrefix        &prefix,
+                                const std::string           &vrfName = "default",
+                                std::vector<nxos::NxPrefix> *routes  = NULL) = 0;
+
+    /**
+     * Asynchronous addL3Routes(). The batch is queued & sent to RIB
+     * without waiting for the previous requests to complete, so many
+     * requests can be outstanding & route injection is bound by the
+     * bandwidth rather than the round trip to RIB. The completion is
+     * sent to NxRibMgrHandler::postL3RouteAsyncCb with the returned id.
+     *
+     * Requests complete in the order they were made, unless pacing is
+     * enabled, refer to enableL3RoutePacing(). A synchronous route API
+     * call waits for the outstanding requests to complete first. The number of outstanding requests is bound by
+     * setL3RouteAsyncLimit(), a request over the limit is refused.
+     *
+     * @param[in] routes Same as addL3Routes(). Copied, can be reused
+     *                   once the call returns.
+     * @param[in] vrfName [Optional] Same as addL3Routes().
+     * @param[in] af [Optional] Same as addL3Routes().
+     *
+     * @returns Non-zero request id.
+     *          0 if the request is invalid (or) the in-flight limit is
+     *          reached, retry after a completion.
+     *
+     * @details
+     *     Write API - NX-SDK Applications can use this API only if security profile with permit (or) throttle is 
+     *                 enabled for that application. Using this API without the appropriate security profiles will
+     *                 throw an exception. Refer to readmes/security_profiles.md for more info in NX-SDK Git repo.
+     *
+     *  @code
+     *  C++:
+     *       std::vector<nxos::nx_l3_route_rec> routes;
+     *
+     *       ribMgr->setL3RouteAsyncLimit(32);
+     *       // Fill routes, refer to nx_l3_route_rec.
+     *       uint64_t reqId = ribMgr->addL3RoutesAsync(routes, "default",
+     *                                                 nxos::AF_IPV4);
+     *       if (!reqId) {
+     *           // Over the limit, send it from postL3RouteAsyncCb.
+     *       }
+     *
+     *  Python:
+     *       reqId = ribMgr.addL3RoutesAsync(routes, "default",
+     *                                       nx_sdk_py.AF_IPV4)
+     *  @endcode
+     **/
+    virtual uint64_t addL3RoutesAsync(const std::vector<nxos::nx_l3_route_rec> &routes,
+                                      const std::string &vrfName = "default",
+                                      nxos::af_e        af      = nxos::AF_IPV4) = 0;
+
+    /**
+     * Asynchronous delL3Routes(). Refer to addL3RoutesAsync().
+     *
+     * @returns Non-zero request id.
+     *          0 if the request is invalid (or) the in-flight limit is
+     *          reached.
+     **/
+    virtual uint64_t delL3RoutesAsync(const std::vector<nxos::nx_l3_route_rec> &routes,
+                                      const std::string &vrfName = "default",
+                                      nxos::af_e        af      = nxos::AF_IPV4) = 0;
+
+    /**
+     * Asynchronous sendMyL3RoutesToRib(). The route operations pending
+     * at the time of the call are sent, routes added (or) deleted
+     * afterwards go with the next request. A route deleted & sent is
+     * gone from the App at once, adding it again creates a new route.
+     * Refer to addL3RoutesAsync().
+     *
+     * @param[in] af [Optional] Address family of the routes to send.
+     *               If not set AF_IPV4 will be used.
+     *
+     * @returns Non-zero request id.
+     *          0 if there is nothing to send (or) the in-flight limit
+     *          is reached.
+     **/
+    virtual uint64_t sendMyL3RoutesToRibAsync(nxos::af_e af = nxos::AF_IPV4) = 0;
+
+    /**
+     * To set the in-flight limits of the asynchronous route requests.
+     * Defaults to 64 requests & no route limit.
+     *
+     * @param[in] maxRequests Max outstanding requests, min 1.
+     * @param[in] maxRoutes [Optional] Max outstanding route records
+     *                      (or) routes over all the requests, 0 for no
+     *                      limit. A request bigger than the limit is
+     *                      accepted when nothing is outstanding.
+     *
+     * @returns true if the limits were set.
+     *
+     *  @code
+     *  C++:
+     *       ribMgr->setL3RouteAsyncLimit(32, 100000);
+     *
+     *  Python:
+     *       ribMgr.setL3RouteAsyncLimit(32, 100000)
+     *  @endcode
+     **/
+    virtual bool setL3RouteAsyncLimit(unsigned int maxRequests,
+                                      unsigned int maxRoutes = 0) = 0;
+
+    /**
+     * @returns Number of outstanding asynchronous route requests.
+     **/
+    virtual unsigned int getL3RouteAsyncInFlight() = 0;
+
+    /**
+     * To pace the routes sent to RIB so that a large burst does not back
+     * up URIB & starve the other protocols.
+     *
+     * The asynchronous requests (refer to addL3RoutesAsync()) and the
+     * route operations sent with sendMyL3RoutesToRibAsync() are queued &
+     * sent at the current install rate. The rate adapts to RIB (AIMD): it
+     * grows by maxRate/20 after each request committed within
+     * targetLatencyMs & halves, down to minRate, after a slower commit
+     * (or) a commit failure. Withdrawals (delL3RoutesAsync()) jump ahead
+     * of the queued adds of other prefixes & are not held by the rate,
+     * so requests may complete out of the order they were made. The
+     * synchronous addL3Routes(), delL3Routes() & sendMyL3RoutesToRib()
+     * are not paced, they send the queued requests first.
+     *
+     * @param[in] maxRate Max install rate in routes per second.
+     * @param[in] minRate [Optional] Min install rate. If 0 maxRate/10
+     *                    will be used.
+     * @param[in] targetLatencyMs [Optional] Commit latency above which
+     *                    the rate is decreased.
+     * @param[in] enable [Optional] false to stop pacing, the queued
+     *                   requests are sent at once.
+     *
+     * @returns true if pacing was enabled (or) disabled.
+     *          false if maxRate is 0 (or) minRate > maxRate.
+     *
+     *  @code
+     *  C++:
+     *       nxos::NxL3RoutePacingStats stats;
+     *
+     *       ribMgr->enableL3RoutePacing(20000, 1000, 50);
+     *       ...
+     *       ribMgr->getL3RoutePacingStats(&stats);
+     *       cout << "rate " << stats.rate << " queued "
+     *            << stats.queuedRoutes << endl;
+     *
+     *  Python:
+     *       ribMgr.enableL3RoutePacing(20000, 1000, 50)
+     *  @endcode
+     **/
+    virtual bool enableL3RoutePacing(unsigned int maxRate,
+                                     unsigned int minRate         = 0,
+                                     unsigned int targetLatencyMs = 100,
+                                     bool         enable          = true) = 0;
+
+    /**
+     * To get the current rate, queue depth & counters of the route
+     * install pacer.
+     *
+     * @param[out] stats Refer to NxL3RoutePacingStats in
+     *                   types/nx_rib_mgr.h.
+     *
+     * @returns true if pacing is enabled.
+     **/
+    virtual bool getL3RoutePacingStats(nxos::NxL3RoutePacingStats *stats) = 0;
+
+    /**
+     * To get the route count, prefix length histogram & next-hop count
+     * distribution of the watched routes of an AF, VRF & owner.
+     *
+     * NXSDK keeps the aggregates up to date as the route updates are
+     * received, so the call does not walk the routes & costs the same
+     * for any table size. The owner of a route is the protocol & tag
+     * of its next-hops ex. "bgp-100". The same statistics are shown by
+     * the auto-generated "show <appname> nxsdk rib-stats" command.
+     *
+     * @param[out] stats Refer to NxL3RouteStats in types/nx_rib_mgr.h.
+     * @param[in] af [Optional] Address family. If not set AF_IPV4 will
+     *               be used.
+     * @param[in] vrfName [Optional] VRF, "all" for all the VRFs.
+     * @param[in] owner [Optional] Owner, "all" for all the owners.
+     *
+     * @returns true if routes of the AF, VRF & owner were received.
+     *          false otherwise, stats are zeroed.
+     *
+     *  @code
+     *  C++:
+     *       nxos::NxL3RouteStats stats;
+     *
+     *       if (ribMgr->getL3RouteStats(&stats, nxos::AF_IPV4, "default",
+     *                                   "bgp-100")) {
+     *           cout << stats.routes << " routes, "
+     *                << stats.maskLens[24] << " /24s" << endl;
+     *       }
+     *
+     *  Python:
+     *       stats = nx_sdk_py.NxL3RouteStats()
+     *       if ribMgr.getL3RouteStats(stats, nx_sdk_py.AF_IPV4, "default"):
+     *          print "%d routes" % stats.routes
+     *  @endcode
+     **/
+    virtual bool getL3RouteStats(nxos::NxL3RouteStats *stats,
+                                 nxos::af_e        af      = nxos::AF_IPV4,
+                                 const std::string &vrfName = "all",
+                                 const std::string &owner   = "all") = 0;
+
+    /**
+     * To visit the watched routes of a VRF falling within prefix, in
+     * prefix order i.e a route before its own more-specifics.
+     *
+     * The watched routes are kept ordered by prefix, so the query costs
+     * O(log n) to find the first route plus O(1) per route visited, and
+     * does no allocation per route.
+     *
+     * @param[in] prefix Covering prefix ex. 10.1.0.0/16.
+     * @param[in] visitor Called for each route, refer to
+     *                    NxL3RouteVisitor.
+     * @param[in] vrfName [Optional] Name of the VRF. If not set "default"
+     *                    will be used.
+     * @param[in] inclusive [Optional] Visit the route of prefix itself
+     *                      too. True by default.
+     *
+     * @returns Number of routes visited.
+     *
+     *  @code
+     *  C++:
+     *       class myVisitor : public nxos::NxL3RouteVisitor {
+     *          public:
+     *             bool visit(NxL3Route *route) {
+     *                cout << route->getL3Prefix() << endl;
+     *                return true;
+     *             }
+     *       };
+     *
+     *       myVisitor      visitor;
+     *       nxos::NxPrefix prefix;
+     *
+     *       prefix.fromString("10.1.0.0/16");
+     *       ribMgr->forEachMoreSpecific(prefix, &visitor, "default");
+     *
+     *  Python:
+     *       class myVisitor(nx_sdk_py.NxL3RouteVisitor):
+     *          def visit(self, route):
+     *             print route.getL3Prefix()
+     *             return True
+     *
+     *       prefix = nx_sdk_py.NxPrefix()
+     *       prefix.fromString("10.1.0.0/16")
+     *       ribMgr.forEachMoreSpecific(prefix, myVisitor(), "default")
+     *  @endcode
+     **/
+    virtual unsigned int forEachMoreSpecific(const nxos::NxPrefix &prefix,
+                                             NxL3RouteVisitor     *visitor,
+                                             const std::string    &vrfName   = "default",
+                                             bool                 inclusive = true) = 0;
+
+    /**
+     * To visit the watched routes of a VRF covering prefix, from the
+     * longest (closest) to the shortest (widest) ex. the covering
+     * aggregates of a /32.
+     *
+     * Only the mask lengths in use in the VRF are tried, refer to
+     * getL3RouteStats(), each in O(log n) & with no allocation.
+     *
+     * @param[in] prefix Prefix (or) host route ex. 10.1.1.1/32.
+     * @param[in] visitor Called for each route, refer to
+     *                    NxL3RouteVisitor.
+     * @param[in] vrfName [Optional] Name of the VRF. If not set "default"
+     *                    will be used.
+     * @param[in] inclusive [Optional] Visit the route of prefix itself
+     *                      too. True by default.
+     *
+     * @returns Number of routes visited.
+     *
+     *  @code
+     *  C++:
+     *       prefix.fromString("10.1.1.1/32");
+     *       ribMgr->forEachLessSpecific(prefix, &visitor, "default", false);
+     *
+     *  Python:
+     *       prefix.fromString("10.1.1.1/32")
+     *       ribMgr.forEachLessSpecific(prefix, myVisitor(), "default", False)
+     *  @endcode
+     **/
+    virtual unsigned int forEachLessSpecific(const nxos::NxPrefix &prefix,
+                                             NxL3RouteVisitor     *visitor,
+                                             const std::string    &vrfName   = "default",
+                                             bool                 inclusive = true) = 0;
+
+    /**
+     * To visit the watched routes of a VRF whose prefix address is from
+     * first to last included, in prefix order. Costs O(log n) plus O(1)
+     * per route visited, with no allocation per route.
+     *
+     * @param[in] first First address of the range.
+     * @param[in] last Last address of the range, same address family.
+     * @param[in] visitor Called for each route, refer to
+     *                    NxL3RouteVisitor.
+     * @param[in] vrfName [Optional] Name of the VRF. If not set "default"
+     *                    will be used.
+     *
+     * @returns Number of routes visited.
+     *
+     *  @code
+     *  C++:
+     *       nxos::NxIpAddr first, last;
+     *
+     *       first.fromString("10.1.0.0");
+     *       last.fromString("10.3.255.255");
+     *       ribMgr->forEachInRange(first, last, &visitor, "default");
+     *
+     *  Python:
+     *       first = nx_sdk_py.NxIpAddr()
+     *       first.fromString("10.1.0.0")
+     *       last = nx_sdk_py.NxIpAddr()
+     *       last.fromString("10.3.255.255")
+     *       ribMgr.forEachInRange(first, last, myVisitor(), "default")
+     *  @endcode
+     **/
+    virtual unsigned int forEachInRange(const nxos::NxIpAddr &first,
+                                        const nxos::NxIpAddr &last,
+                                        NxL3RouteVisitor     *visitor,
+                                        const std::string    &vrfName = "default") = 0;
+
+    /**
+     * Register your handler object for only some of its events,
+     * setRibMgrHandler(handler) registers it for all of them. The events out
+     * of eventMask are dropped before any object is built (or) any data is
+     * read for them & are counted, refer to getSkippedEventCount().
+     * @param[in] handler    NxRibMgrHandler object with user overloaded
+     *                       functions to handle events.
+     * @param[in] eventMask  NxRibMgrHandler::event_mask_e values OR-ed.
+     *
+     *  @code
+     *  C++:
+     *       ribMgr->setRibMgrHandler(myribcb, NxRibMgrHandler::EVENT_L3_ROUTE);
+     *
+     *  Python:
+     *       ribMgr.setRibMgrHandler(myribcb, nx_sdk_py.NxRibMgrHandler.EVENT_L3_ROUTE)
+     *  @endcode
+     **/
+    virtual void setRibMgrHandler(NxRibMgrHandler *handler, uint32_t eventMask) = 0;
+
+    /**
+     * Get the count of events dropped as out of the event mask of the
+     * handler, refer to setRibMgrHandler(handler, eventMask).
+     * @param[in] events  [Optional] NxRibMgrHandler::event_mask_e values
+     *                    OR-ed, a single one for the count of that event.
+     * @returns Count of events skipped, of all the events by default.
+     *
+     *  @code
+     *  C++:
+     *       cout << ribMgr->getSkippedEventCount() << " events skipped";
+     *  @endcode
+     **/
+    virtual uint64_t getSkippedEventCount(uint32_t events = 0xffffffff) = 0;
 };
 
 } // namespace nxos
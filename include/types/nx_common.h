@@ -16,6 +16,15 @@
 
 namespace nxos {
 
+/// Max length of an IPv4 or IPv6 address string including the NUL.
+#define NX_IP_ADDR_STR_LEN   46
+
+/// Max length of an IPv4 or IPv6 prefix string "addr/len" including the NUL.
+#define NX_IP_PREFIX_STR_LEN 50
+
+/// Max length of an interface name string including the NUL.
+#define NX_INTF_NAME_STR_LEN 64
+
 // Supported Record types
 typedef enum {
    /// Record Type is TEXT
@@ -0,0 +1,350 @@
+/** @file nx_intf_mgr.h
+ *  @brief Provides necessary types needed for reading interfaces using NXSDK
+ *
+ *  @author nxos-sdk@cisco.com
+ *  @bug No known bugs.
+ */
+
+#ifndef __NX_INTF_MGR_TYPES_H__
+#define __NX_INTF_MGR_TYPES_H__
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "nx_common.h"
+
+namespace nxos {
+
+/// Max length of an interface description string including the NUL.
+#define NX_INTF_DESC_STR_LEN 256
+
+/// Max length of a VRF name string including the NUL.
+#define NX_VRF_NAME_STR_LEN  33
+
+/// Max length of the other interface attribute strings (layer, MAC
+/// address, last modified time) including the NUL.
+#define NX_INTF_ATTR_STR_LEN 32
+
+/// Count of VLAN ids, 1 to 4094 are valid.
+#define NX_VLAN_COUNT        4096
+
+/**
+ * @brief All the attributes of an interface read in one call, refer to
+ *        NxIntf::snapshot() & NxIntfMgr::getIntfSnapshots().
+ *
+ * Plain value type with no heap allocation, a copy of the interface at
+ * the time of the call that is not updated afterwards. The strings are
+ * the ones returned by the NxIntf getters, NUL terminated & truncated to
+ * the size of their field. The secondary addresses & members are only
+ * counted, read them with NxIntf::getL3ScAddrs() & getMemberNames().
+ *
+ *  @code{.cpp}
+ *       nxos::NxIntfSnapshot snap;
+ *
+ *       if (intf->snapshot(&snap)) {
+ *           cout << snap.name << " " << snap.vrf << " " << snap.mtu << endl;
+ *       }
+ *  @endcode
+ *
+ *  @code{.py}
+ *       snap = nx_sdk_py.NxIntfSnapshot()
+ *       if intf.snapshot(snap):
+ *           print snap.name + " " + snap.vrf
+ *  @endcode
+ **/
+struct NxIntfSnapshot {
+   char           name[NX_INTF_NAME_STR_LEN];        /// Short name.
+   uint32_t       ifindex;                           /// Interface index.
+   intf_type_e    type;
+   char           layer[NX_INTF_ATTR_STR_LEN];       /// Layer2 (or) Layer3.
+   char           vrf[NX_VRF_NAME_STR_LEN];
+   uint16_t       vlan;                              /// 0 if none.
+   char           description[NX_INTF_DESC_STR_LEN];
+   char           l3PrAddr[MAX_AF][NX_IP_PREFIX_STR_LEN]; /// By af_e.
+   unsigned int   l3ScAddrCount[MAX_AF];             /// Secondary addresses.
+   char           l2Address[NX_INTF_ATTR_STR_LEN];
+   char           l2AddressHW[NX_INTF_ATTR_STR_LEN];
+   state_type_e   adminState;
+   state_type_e   operState;
+   uint32_t       mtu;
+   uint32_t       speed;                             /// INTF_SPEED_* value.
+   unsigned int   memberCount;                       /// Channel members.
+   event_type_e   event;                             /// Last event.
+   char           lastMod[NX_INTF_ATTR_STR_LEN];
+};
+
+/**
+ * @brief Selects the interfaces of NxIntfMgr::getIntfSnapshots(). An
+ *        interface is selected if it matches all the set fields, the
+ *        default filter selects all the interfaces.
+ *
+ *  @code{.cpp}
+ *       nxos::NxIntfFilter filter;
+ *
+ *       // Layer3 subinterfaces of VRF tenant-1 that are up
+ *       filter.type      = nxos::NX_TYPE_SUBINTF;
+ *       filter.vrf       = "tenant-1";
+ *       filter.layer     = "Layer3";
+ *       filter.operState = nxos::UP;
+ *  @endcode
+ **/
+struct NxIntfFilter {
+   intf_type_e    type;       /// Any if NX_TYPE_UNKNOWN.
+   std::string    vrf;        /// Any if empty.
+   std::string    layer;      /// Any if empty.
+   state_type_e   operState;  /// Any if UNKNOWN.
+
+   /// Matches all the interfaces.
+   NxIntfFilter();
+};
+
+/**
+ * @brief Counters of an interface sampled by NxIntfMgr::watchIntfCounters(),
+ *        refer to NxIntfMgr::getIntfCounters().
+ **/
+struct NxIntfCounters {
+   uint64_t       timeMs;     /// Monotonic time of the sample.
+   uint64_t       rxBytes;
+   uint64_t       txBytes;
+   uint64_t       rxPackets;
+   uint64_t       txPackets;
+   uint64_t       rxErrors;
+   uint64_t       txErrors;
+   uint64_t       rxDrops;
+   uint64_t       txDrops;
+};
+
+/**
+ * @brief Rates of an interface over the last sampling interval, refer to
+ *        NxIntfMgr::getIntfRates().
+ **/
+struct NxIntfRates {
+   uint32_t       intervalMs; /// Between the two samples.
+   double         rxBps;      /// Bits per second.
+   double         txBps;
+   double         rxPps;      /// Packets per second.
+   double         txPps;
+   double         rxErrorsPs; /// Errors per second.
+   double         txErrorsPs;
+   double         rxDropsPs;  /// Drops per second.
+   double         txDropsPs;
+   double         rxUtil;     /// Percent of the speed, 0 if not known.
+   double         txUtil;
+};
+
+/**
+ * @brief When NxIntfMgrHandler::postIntfCounterThresholdCb() is called,
+ *        refer to NxIntfMgr::setIntfCounterThreshold(). A condition of 0
+ *        is not checked.
+ *
+ * An interface exceeds the threshold when its rx (or) tx utilization
+ * reaches utilPct (or) its errors & drops per second reach errorRate.
+ * It is back under it when both utilizations are below clearPct & the
+ * errors & drops per second are below errorRate.
+ **/
+struct NxIntfCounterThreshold {
+   double         utilPct;    /// Rx (or) tx utilization, percent.
+   double         clearPct;   /// Utilization to clear, utilPct if 0.
+   double         errorRate;  /// Rx & tx errors & drops per second.
+};
+
+/**
+ * @brief Configuration changes of many interfaces committed in one call,
+ *        refer to NxIntfMgr::commitIntfConfig().
+ *
+ * A plain list of changes built by the App, nothing is sent until it is
+ * committed. Changes of an interface are applied in the order they were
+ * added, all (or) none of them.
+ *
+ *  @code{.cpp}
+ *       nxos::NxIntfConfigTxn txn;
+ *
+ *       for (size_t i = 0; i < ports.size(); i++) {
+ *           txn.setMtu(ports[i], 9216);
+ *           txn.setDescription(ports[i], "to spine");
+ *           txn.setAdminState(ports[i], nxos::UP);
+ *       }
+ *  @endcode
+ *
+ *  @code{.py}
+ *       txn = nx_sdk_py.NxIntfConfigTxn()
+ *       txn.setMtu("Ethernet1/1", 9216)
+ *       txn.setAdminState("Ethernet1/1", nx_sdk_py.UP)
+ *  @endcode
+ **/
+struct NxIntfConfigTxn {
+   /// Attribute of a change.
+   typedef enum {
+      LAYER = 0,
+      VRF,
+      DESCRIPTION,
+      ADMIN_STATE,
+      MTU,
+      SPEED,
+      VLAN
+   } attr_e;
+
+   /// One change, as the NxIntf setter of attr would make it.
+   struct Change {
+      std::string    intfName;
+      attr_e         attr;
+      std::string    str;      /// LAYER, VRF & DESCRIPTION.
+      uint32_t       value;    /// Other attributes.
+   };
+
+   std::vector<Change> changes;
+
+   void setLayer(const std::string &intfName, const std::string &layer);
+   void setVrf(const std::string &intfName, const std::string &vrf);
+   void setDescription(const std::string &intfName, const std::string &desc);
+   void setAdminState(const std::string &intfName, state_type_e state);
+   void setMtu(const std::string &intfName, uint32_t mtu);
+   void setSpeed(const std::string &intfName, uint32_t speed);
+   void setVlan(const std::string &intfName, unsigned int vlanId);
+
+   /// Drop the changes to reuse the transaction.
+   void clear() { changes.clear(); }
+};
+
+/**
+ * @brief Status of an interface of a committed NxIntfConfigTxn, one per
+ *        interface in the order of their first change.
+ **/
+struct NxIntfConfigResult {
+   std::string    intfName;
+   unsigned int   index;    /// Index of the failed change, if any.
+   unsigned long  errCode;  /// ERR_ESUCCESS if applied, else of type
+                            /// err_type_e & none of its changes are.
+};
+
+/**
+ * @brief Dampening of the oper state changes of an interface, refer to
+ *        NxIntfMgr::setIntfStateDampening(). Same as the NX-OS interface
+ *        "dampening" command.
+ *
+ * Each change to down adds penalty to the penalty of the interface, which
+ * halves every halfLifeMs. Its changes are suppressed, i.e not delivered
+ * to NxIntfMgrHandler::postIntfStateCb(), from when the penalty reaches
+ * suppress until it decays below reuse. The penalty is capped so an
+ * interface is suppressed at most maxSuppressMs after it stops flapping.
+ **/
+struct NxIntfDampening {
+   uint32_t       penalty;        /// Per change to down, 0 disables.
+   uint32_t       suppress;       /// Suppress from this penalty.
+   uint32_t       reuse;          /// Reuse below this penalty.
+   uint32_t       halfLifeMs;
+   uint32_t       maxSuppressMs;
+
+   /// NX-OS defaults: 1000, 2000, 1000, 5 secs & 20 secs.
+   NxIntfDampening();
+};
+
+/**
+ * @brief Counters of the oper state events, refer to
+ *        NxIntfMgr::getIntfEventStats().
+ **/
+struct NxIntfEventStats {
+   uint64_t       received;    /// Oper state changes received.
+   uint64_t       delivered;   /// postIntfStateCb() calls.
+   uint64_t       dampened;    /// Changes suppressed by dampening.
+   uint64_t       conflated;   /// Changes superseded within a window.
+   uint32_t       suppressed;  /// Interfaces suppressed now.
+   double         penalty;     /// Dampening penalty, of an interface only.
+};
+
+/**
+ * @brief Set of VLANs, a bit per VLAN id, refer to NxIntf::getVlanSet().
+ *
+ * Plain 512 bytes value type. The set operations go over 64 bits words
+ * in loops the compiler vectorizes, so "is VLAN 2100 on the interface"
+ * is a bit test & "the VLANs both trunks carry" one & of two sets.
+ *
+ *  @code{.cpp}
+ *       nxos::NxVlanSet trunk1, trunk2;
+ *
+ *       intf1->getVlanSet(&trunk1);
+ *       intf2->getVlanSet(&trunk2);
+ *       trunk1 &= trunk2;
+ *       for (int v = trunk1.next(0); v >= 0; v = trunk1.next(v + 1)) {
+ *           cout << "common vlan " << v << endl;
+ *       }
+ *  @endcode
+ *
+ *  @code{.py}
+ *       vlans = nx_sdk_py.NxVlanSet()
+ *       if intf.getVlanSet(vlans) and vlans.test(2100):
+ *           print intf.getName() + " carries vlan 2100"
+ *  @endcode
+ **/
+struct NxVlanSet {
+   uint64_t       words[NX_VLAN_COUNT / 64];  /// Bit v % 64 of word v / 64.
+
+   /// Empty set.
+   NxVlanSet();
+
+   /// Add (or) remove vlan, false if it is not below NX_VLAN_COUNT.
+   bool set(unsigned int vlan);
+   bool reset(unsigned int vlan);
+   bool test(unsigned int vlan) const {
+      return (vlan < NX_VLAN_COUNT) && ((words[vlan / 64] >> (vlan % 64)) & 1);
+   }
+   void clear();
+
+   /// Lowest VLAN of the set from vlan on, -1 if none.
+   int next(unsigned int vlan) const;
+   /// Count of VLANs in the set.
+   unsigned int count() const;
+   bool any() const;
+   /// Has any VLAN in common with vlans.
+   bool intersects(const NxVlanSet &vlans) const;
+
+   NxVlanSet &operator&=(const NxVlanSet &vlans);
+   NxVlanSet &operator|=(const NxVlanSet &vlans);
+   bool operator==(const NxVlanSet &vlans) const;
+   bool operator!=(const NxVlanSet &vlans) const { return !(*this == vlans); }
+};
+
+/**
+ * @brief Set of interfaces, a bit per ifindex, refer to
+ *        NxIntf::getIfindex(), NxIntf::getMemberSet() &
+ *        NxIntfMgr::getVlanIntfs().
+ *
+ * Grows to the highest ifindex set, bits past its end are 0. The set
+ * operations are vectorized as the ones of NxVlanSet.
+ *
+ *  @code{.cpp}
+ *       nxos::NxIntfBitmap intfs, members;
+ *
+ *       // Members of port-channel10 that carry VLAN 2100
+ *       intfMgr->getVlanIntfs(2100, &intfs);
+ *       pc->getMemberSet(&members);
+ *       intfs &= members;
+ *  @endcode
+ **/
+struct NxIntfBitmap {
+   std::vector<uint64_t> words;  /// Bit i % 64 of word i / 64.
+
+   /// Add (or) remove ifindex, false if it is 0.
+   bool set(uint32_t ifindex);
+   bool reset(uint32_t ifindex);
+   bool test(uint32_t ifindex) const {
+      return ((ifindex / 64) < words.size()) &&
+             ((words[ifindex / 64] >> (ifindex % 64)) & 1);
+   }
+   void clear() { words.clear(); }
+
+   /// Lowest ifindex of the set from ifindex on, 0 if none.
+   uint32_t next(uint32_t ifindex) const;
+   /// Count of interfaces in the set.
+   unsigned int count() const;
+   bool any() const;
+   /// Has any interface in common with intfs.
+   bool intersects(const NxIntfBitmap &intfs) const;
+
+   NxIntfBitmap &operator&=(const NxIntfBitmap &intfs);
+   NxIntfBitmap &operator|=(const NxIntfBitmap &intfs);
+};
+
+}
+
+#endif //__NX_INTF_MGR_TYPES_H__
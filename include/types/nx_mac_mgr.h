@@ -0,0 +1,75 @@
+/** @file nx_mac_mgr.h
+ *  @brief Provides necessary types needed for managing MACs using NXSDK
+ *
+ *  @author nxos-sdk@cisco.com
+ *  @bug No known bugs.
+ */
+
+#ifndef __NX_MAC_MGR_TYPES_H__
+#define __NX_MAC_MGR_TYPES_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include "nx_common.h"
+
+namespace nxos {
+
+/// Max length of a MAC address string "xxxx.xxxx.xxxx" including the NUL.
+#define NX_MAC_ADDR_STR_LEN 15
+
+/**
+ * @brief MAC address & VLAN packed in 64 bits.
+ *
+ * Plain 8 byte value type, the key of the MAC table: the MAC address in
+ * bits 0-47 with its first byte the most significant & the VLAN in bits
+ * 48-59, the other bits are 0. Keys compare & hash as integers, so an
+ * App mirroring the MAC table keys it by NxMacKey in place of the
+ * address strings. Valid keys have a VLAN from 1 to 4094.
+ *
+ *  @code{.cpp}
+ *       nxos::NxMacKey key;
+ *
+ *       if (key.fromString("0011.2233.4455", 10)) {
+ *           NxMac *mac = macMgr->getMac(key);
+ *       }
+ *       key = nxos::NxMacKey(0x001122334455ULL, 10);
+ *  @endcode
+ *
+ *  @code{.py}
+ *       key = nx_sdk_py.NxMacKey()
+ *       if key.fromString("0011.2233.4455", 10):
+ *           mac = macMgr.getMac(key)
+ *  @endcode
+ **/
+struct NxMacKey {
+   uint64_t       key;  /// MAC in bits 0-47, VLAN in bits 48-59.
+
+   /// Invalid key.
+   NxMacKey() : key(0) {}
+   /// Key of the 48 bit mac in vlan, bits above are dropped.
+   NxMacKey(uint64_t mac, unsigned int vlan);
+
+   /// Parse a MAC in "xxxx.xxxx.xxxx", "xx:xx:xx:xx:xx:xx" (or)
+   /// "xx-xx-xx-xx-xx-xx" form, with vlan. Returns false if either is
+   /// invalid.
+   bool fromString(const char *macAddr, unsigned int vlan);
+   bool fromString(const std::string &macAddr, unsigned int vlan);
+
+   /// Write the MAC as "xxxx.xxxx.xxxx" & a NUL into buf. Returns the
+   /// length written without the NUL, 0 if len is too small.
+   size_t toString(char *buf, size_t len) const;
+   std::string toString() const;
+
+   uint64_t mac() const { return key & 0xffffffffffffULL; }
+   unsigned int vlan() const { return (unsigned int)(key >> 48) & 0xfff; }
+   bool valid() const { return (vlan() >= 1) && (vlan() <= 4094); }
+
+   bool operator==(const NxMacKey &k) const { return key == k.key; }
+   bool operator!=(const NxMacKey &k) const { return key != k.key; }
+   bool operator<(const NxMacKey &k) const { return key < k.key; }
+};
+
+}
+
+#endif //__NX_MAC_MGR_TYPES_H__
@@ -0,0 +1,272 @@
+/** @file nx_rib_mgr.h
+ *  @brief Provides necessary types needed for managing L3 Routes using NXSDK
+ *
+ *  @author nxos-sdk@cisco.com
+ *  @bug No known bugs.
+ */
+
+#ifndef __NX_RIB_MGR_TYPES_H__
+#define __NX_RIB_MGR_TYPES_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include "nx_common.h"
+
+namespace nxos {
+
+/// Next-hop count from which routes share the last bucket of
+/// NxL3RouteStats::nhCounts.
+#define NX_L3_ROUTE_STATS_MAX_NH 16
+
+/**
+ * @brief Binary IPv4 or IPv6 address.
+ *
+ * Plain 17 byte value type, trivially copyable with no heap allocation,
+ * to pass addresses to & from the RIB APIs without going through text.
+ * Address is in network byte order. IPv4 uses the first 4 bytes and the
+ * unused bytes are always 0, so addresses can be compared bytewise.
+ * Always set it using fromString() (or) memset it to 0 & fill it in.
+ *
+ *  @code{.cpp}
+ *       nxos::NxIpAddr addr;
+ *       char           buf[NX_IP_ADDR_STR_LEN];
+ *
+ *       if (addr.fromString("10.1.1.1")) {
+ *           addr.toString(buf, sizeof(buf));
+ *       }
+ *  @endcode
+ *
+ *  @code{.py}
+ *       import nx_sdk_py
+ *       addr = nx_sdk_py.NxIpAddr()
+ *       if addr.fromString("10.1.1.1"):
+ *          print addr.toString()
+ *  @endcode
+ **/
+struct NxIpAddr {
+   unsigned char  addr[16];  /// Address in network byte order.
+   uint8_t        af;        /// Address family of type af_e.
+
+   /// Parse an IPv4 (or) IPv6 address. Returns false if invalid.
+   bool fromString(const char *str);
+   bool fromString(const std::string &str);
+
+   /// Write the address & a NUL into buf. Returns the length written
+   /// without the NUL, 0 if len is too small.
+   size_t toString(char *buf, size_t len) const;
+   std::string toString() const;
+
+   /// 32 for IPv4, 128 for IPv6.
+   unsigned int addrBits() const { return (af == AF_IPV6) ? 128 : 32; }
+
+   bool operator==(const NxIpAddr &ip) const;
+   bool operator!=(const NxIpAddr &ip) const { return !(*this == ip); }
+   bool operator<(const NxIpAddr &ip) const;
+};
+
+/**
+ * @brief Binary IPv4 or IPv6 prefix.
+ *
+ * NxIpAddr with a mask length. Host bits of the address are always 0.
+ * maskLen is taken as is i.e unlike the string APIs, 0 is the default
+ * route and a host route is /32 (or) /128.
+ *
+ *  @code{.cpp}
+ *       nxos::NxPrefix prefix;
+ *
+ *       if (prefix.fromString("10.1.1.0/24")) {
+ *           route = ribMgr->addL3Route(prefix, "default");
+ *       }
+ *  @endcode
+ *
+ *  @code{.py}
+ *       import nx_sdk_py
+ *       prefix = nx_sdk_py.NxPrefix()
+ *       if prefix.fromString("10.1.1.0/24"):
+ *          route = ribMgr.addL3Route(prefix, "default")
+ *  @endcode
+ **/
+struct NxPrefix {
+   NxIpAddr       ip;       /// Prefix address, masked to maskLen.
+   uint8_t        maskLen;  /// Mask length.
+
+   /// Parse "addr/len". A bare address is taken as a host route.
+   /// Returns false if invalid.
+   bool fromString(const char *str);
+   bool fromString(const std::string &str);
+
+   /// Set to addr masked to len. Returns false if len is invalid.
+   bool set(const NxIpAddr &addr, unsigned int len);
+
+   /// Write "addr/len" & a NUL into buf. Returns the length written
+   /// without the NUL, 0 if len is too small.
+   size_t toString(char *buf, size_t len) const;
+   std::string toString() const;
+
+   /// True if addr (or) prefix falls within this prefix.
+   bool contains(const NxIpAddr &addr) const;
+   bool contains(const NxPrefix &prefix) const;
+
+   bool operator==(const NxPrefix &prefix) const;
+   bool operator!=(const NxPrefix &prefix) const { return !(*this == prefix); }
+   bool operator<(const NxPrefix &prefix) const;
+};
+
+/**
+ * @brief One prefix + next-hop record of a bulk route operation.
+ *
+ * Used by NxRibMgr::addL3Routes() and NxRibMgr::delL3Routes() to program
+ * many routes of a VRF/AF in a single call. Records are plain fixed size
+ * structs so that a batch is one contiguous array with no per-route heap
+ * allocation.
+ *
+ *  - To add an ECMP route, use one record per next-hop with the same
+ *    address & maskLen. Records of the same prefix need not be adjacent.
+ *  - If intfName is empty, nextHopAddr is added as a recursive next-hop
+ *    else as a direct next-hop out of intfName.
+ *  - For delL3Routes(), only address & maskLen are used.
+ *
+ *  @code{.cpp}
+ *       std::vector<nxos::nx_l3_route_rec> routes(1);
+ *       strcpy(routes[0].address, "10.1.1.0");
+ *       routes[0].maskLen = 24;
+ *       strcpy(routes[0].nextHopAddr, "10.1.1.3");
+ *       strcpy(routes[0].intfName, "Ethernet1/3");
+ *       routes[0].preference = 12;
+ *  @endcode
+ *
+ *  @code{.py}
+ *       import nx_sdk_py
+ *       rec = nx_sdk_py.nx_l3_route_rec()
+ *       rec.address = "10.1.1.0"
+ *       rec.maskLen = 24
+ *       rec.nextHopAddr = "10.1.1.3"
+ *       rec.intfName = "Ethernet1/3"
+ *       rec.preference = 12
+ *  @endcode
+ **/
+typedef struct nx_l3_route_rec_ {
+   char           address[NX_IP_ADDR_STR_LEN];     /// Route address.
+   unsigned char  maskLen;                         /// 0 picks /32 (or) /128.
+   char           nextHopAddr[NX_IP_ADDR_STR_LEN]; /// Next-hop address.
+   char           intfName[NX_INTF_NAME_STR_LEN];  /// Empty for recursive NH.
+   uint8_t        preference;                      /// Lower is more preferred.
+} nx_l3_route_rec;
+
+/**
+ * @brief Failure of one record in a bulk route operation.
+ *
+ * Only failed records are reported, so a fully successful batch
+ * reports nothing.
+ **/
+typedef struct nx_l3_route_rec_err_ {
+   unsigned int   index;    /// Index of the failed record in the batch.
+   unsigned long  errCode;  /// Failure reason of type err_type_e.
+} nx_l3_route_rec_err;
+
+/**
+ * @brief Prefix range of a route filter, same as a prefix-list entry.
+ *
+ * Matches the routes within prefix whose mask length is in [ge, le].
+ **/
+struct NxL3RoutePrefixRange {
+   NxPrefix       prefix;   /// Covering prefix.
+   uint8_t        ge;       /// Min mask length of the routes.
+   uint8_t        le;       /// Max mask length of the routes.
+};
+
+/**
+ * @brief Filter of the routes to watch, passed to NxRibMgr::watchL3Route().
+ *
+ * The filter is compiled by NXSDK and applied to the route updates from
+ * RIB before any NxL3Route is built, routes that do not pass are never
+ * sent to the App. A route passes if
+ *  - it matches any of the prefix ranges (or) there are no prefix ranges,
+ *  - and, if any next-hop condition is set, one of its next-hops is out
+ *    of nhIntfName with a preference <= maxPreference & a metric
+ *    <= maxMetric.
+ *
+ *  @code{.cpp}
+ *       nxos::NxL3RouteFilter filter;
+ *
+ *       // 10.1.0.0/16 ge 24 le 24, only the /24s under 10.1.0.0/16
+ *       filter.addPrefixRange("10.1.0.0/16", 24, 24);
+ *       filter.addPrefixRange("10.2.3.0/24");
+ *       filter.maxMetric = 100;
+ *  @endcode
+ *
+ *  @code{.py}
+ *       import nx_sdk_py
+ *       filter = nx_sdk_py.NxL3RouteFilter()
+ *       filter.addPrefixRange("10.1.0.0/16", 24, 24)
+ *       filter.maxMetric = 100
+ *  @endcode
+ **/
+struct NxL3RouteFilter {
+   std::vector<NxL3RoutePrefixRange> prefixRanges;  /// Any of, all if empty.
+   std::string    nhIntfName;     /// Next-hop out interface, any if empty.
+   uint32_t       maxPreference;  /// Max next-hop preference.
+   uint32_t       maxMetric;      /// Max next-hop metric.
+
+   /// Matches all the routes.
+   NxL3RouteFilter();
+
+   /// Add a prefix range. As in a prefix-list, ge & le of 0 match only
+   /// prefix itself, only ge set matches up to the host routes and only
+   /// le set matches from the mask length of prefix. Returns false if
+   /// ge/le are not within [maskLen, 32 (or) 128] (or) ge > le.
+   bool addPrefixRange(const NxPrefix &prefix, unsigned int ge = 0,
+                       unsigned int le = 0);
+   bool addPrefixRange(const std::string &prefix, unsigned int ge = 0,
+                       unsigned int le = 0);
+
+   /// True if no next-hop condition is set.
+   bool anyNextHop() const;
+};
+
+/**
+ * @brief Counters of the route install pacer, refer to
+ *        NxRibMgr::enableL3RoutePacing().
+ **/
+struct NxL3RoutePacingStats {
+   uint32_t       rate;            /// Current install rate, routes/sec.
+   uint32_t       queuedRequests;  /// Requests waiting to be sent.
+   uint32_t       queuedRoutes;    /// Records (or) routes waiting.
+   uint32_t       lastCommitUs;    /// Commit latency of the last request.
+   uint64_t       sentRoutes;      /// Routes sent to RIB while paced.
+   uint64_t       urgentRequests;  /// Withdrawals queued ahead of adds.
+   uint64_t       increases;       /// Rate increases.
+   uint64_t       backoffs;        /// Rate decreases on latency (or) errors.
+};
+
+/**
+ * @brief Aggregates of the watched routes of an AF, VRF & owner, refer
+ *        to NxRibMgr::getL3RouteStats().
+ **/
+struct NxL3RouteStats {
+   uint32_t       routes;          /// Routes.
+   uint64_t       nextHops;        /// Next-hops of all the routes.
+   uint32_t       maskLens[129];   /// Routes per mask length.
+   uint32_t       nhCounts[NX_L3_ROUTE_STATS_MAX_NH + 1];  /// Routes per
+                                   /// next-hop count, the last one for
+                                   /// NX_L3_ROUTE_STATS_MAX_NH or more.
+};
+
+/**
+ * @brief Timing of a route download from RIB, refer to
+ *        NxRibMgrHandler::postRibConvergedCb(). Times are milliseconds
+ *        of a monotonic clock, only their differences are meaningful.
+ **/
+struct NxRibConvergence {
+   uint64_t       downloadStartMs; /// Route download requested.
+   uint64_t       firstRouteMs;    /// First route received, 0 if none.
+   uint64_t       lastRouteMs;     /// Last route received, 0 if none.
+   uint64_t       convergedMs;     /// Download done.
+   uint32_t       routes;          /// Routes received in the download.
+};
+
+}
+
+#endif //__NX_RIB_MGR_TYPES_H__
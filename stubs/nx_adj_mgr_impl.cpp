@@ -7,6 +7,7 @@
     * All rights reserved.
 ************************************************************************/
 #include "nx_adj_mgr_impl.h" 
+#include "nx_intf_dict.h"
    
 using namespace nxos;
 
@@ -94,6 +95,18 @@ NxAdjImpl::equal(NxAdj const& adj_obj) const
 {
    return false;
 }
+
+uint32_t 
+NxAdjImpl::getIfindex()
+{
+   return NxIntfDict::get().ifindex(getIntfName(), false);
+}
+
+uint32_t 
+NxAdjImpl::getPhyIfindex()
+{
+   return NxIntfDict::get().ifindex(getPhyIntfName(), false);
+}
     
 // Implementation for class  
 NxAdjMgrImpl::NxAdjMgrImpl()
@@ -158,4 +171,39 @@ NxAdjMgrHandler*
 NxAdjMgrImpl::getAdjMgrHandler()
 {
    return NULL;
+}
+
+NxAdj* 
+NxAdjMgrImpl::getAdj(uint32_t ifindex, const std::string& ipAddr)
+{
+   return getAdj(NxIntfDict::get().name(ifindex), ipAddr);
+}
+
+bool 
+NxAdjMgrImpl::watchAdj(uint32_t ifindex, nxos::af_e addr_family, bool download, const std::string& ipAddr)
+{
+   std::string intfName = NxIntfDict::get().name(ifindex);
+
+   return !intfName.empty() && watchAdj(intfName, addr_family, download, ipAddr);
+}
+
+bool 
+NxAdjMgrImpl::unwatchAdj(uint32_t ifindex, nxos::af_e addr_family, const std::string& ipAddr)
+{
+   std::string intfName = NxIntfDict::get().name(ifindex);
+
+   return !intfName.empty() && unwatchAdj(intfName, addr_family, ipAddr);
+}
+
+void 
+NxAdjMgrImpl::setAdjMgrHandler(NxAdjMgrHandler* handler, uint32_t eventMask)
+{
+   m_handlerFilter.setMask(eventMask);
+   setAdjMgrHandler(handler);
+}
+
+uint64_t 
+NxAdjMgrImpl::getSkippedEventCount(uint32_t events)
+{
+   return m_handlerFilter.skipped(events);
 }
\ No newline at end of file
@@ -10,6 +10,7 @@
 #define __nx_adj_mgr_impl_H__
 
 #include "nx_adj_mgr.h" 
+#include "nx_event_filter.h"
    
 using namespace nxos;
 
@@ -32,6 +33,8 @@ public:
     bool operator==(NxAdj const &adj_obj) const;
     bool operator!=(NxAdj const &adj_obj) const;
     bool equal(NxAdj const &adj_obj) const;
+    uint32_t getIfindex();
+    uint32_t getPhyIfindex();
 };
 
 class NxAdjMgrImpl : public NxAdjMgr {
@@ -47,6 +50,14 @@ public:
     void setAdjMgrHandler(NxAdjMgrHandler *handler);
     void unsetAdjMgrHandler();
     NxAdjMgrHandler* getAdjMgrHandler();
+    NxAdj* getAdj(uint32_t ifindex,const std::string &ipAddr);
+    bool watchAdj(uint32_t ifindex,nxos::af_e addr_family = AF_IPV4,bool download = true,const std::string &ipAddr = "");
+    bool unwatchAdj(uint32_t ifindex,nxos::af_e addr_family = AF_IPV4,const std::string &ipAddr = "");
+    void setAdjMgrHandler(NxAdjMgrHandler *handler,uint32_t eventMask);
+    uint64_t getSkippedEventCount(uint32_t events = 0xffffffff);
+
+private:
+    NxEventFilter m_handlerFilter;  // events of the handler
 };
 }
 #endif // __nx_adj_mgr_impl_H__ 
\ No newline at end of file
@@ -14,6 +14,7 @@ using namespace nxos;
     
 // Implementation for class  
 NxDmeImpl::NxDmeImpl()
+   : m_propCursor(0)
 {
 
 }
@@ -32,12 +33,23 @@ NxDmeImpl::getDn()
 void 
 NxDmeImpl::setProperty(const std::string& sInPropName, const std::string& sInValue, int* err)
 {
-   return;
+   if (err) *err = 0;
+   for (size_t i = 0; i < m_props.size(); i++) {
+      if (m_props[i].first == sInPropName) {
+         m_props[i].second = sInValue;
+         return;
+      }
+   }
+   m_props.push_back(std::make_pair(sInPropName, sInValue));
 }
 
 std::string 
 NxDmeImpl::getProperty(const std::string& sInPropName, int* err)
 {
+   if (err) *err = 0;
+   for (size_t i = 0; i < m_props.size(); i++) {
+      if (m_props[i].first == sInPropName) return m_props[i].second;
+   }
    return "";
 }
 
@@ -56,7 +68,9 @@ NxDmeImpl::getDataJson()
 std::string 
 NxDmeImpl::iterateProperties(bool fromFirst)
 {
-   return "";
+   if (fromFirst) m_propCursor = 0;
+   if (m_propCursor >= m_props.size()) return "";
+   return m_props[m_propCursor++].first;
 }
 
 nxos::event_type_e 
@@ -118,6 +132,18 @@ NxDmeImpl::getEventPropertyValue(const std::string& sInPropName, int* err)
 {
    return "";
 }
+
+unsigned int 
+NxDmeImpl::getPropertyNames(std::vector<std::string>* names)
+{
+   if (names) {
+      names->resize(m_props.size());
+      for (size_t i = 0; i < m_props.size(); i++) {
+         (*names)[i] = m_props[i].first;
+      }
+   }
+   return (unsigned int)m_props.size();
+}
     
 // Implementation for class  
 NxDmeMgrImpl::NxDmeMgrImpl()
@@ -188,4 +214,17 @@ NxDmeMgrHandler*
 NxDmeMgrImpl::getDmeHandler()
 {
    return NULL;
+}
+
+bool 
+NxDmeMgrImpl::setDmeHandler(NxDmeMgrHandler* handler, uint32_t eventMask)
+{
+   m_handlerFilter.setMask(eventMask);
+   return setDmeHandler(handler);
+}
+
+uint64_t 
+NxDmeMgrImpl::getSkippedEventCount(uint32_t events)
+{
+   return m_handlerFilter.skipped(events);
 }
\ No newline at end of file
@@ -9,7 +9,10 @@
 #ifndef __nx_dme_impl_H__
 #define __nx_dme_impl_H__
 
+#include <utility>
+#include <vector>
 #include "nx_dme.h" 
+#include "nx_event_filter.h"
    
 using namespace nxos;
 
@@ -36,6 +39,11 @@ public:
     std::string iterateChildrenDmeDn(bool fromFirst = false);
     bool isModified();
     std::string getEventPropertyValue(const std::string& sInPropName,int *err);
+    unsigned int getPropertyNames(std::vector<std::string> *names);
+
+private:
+    std::vector<std::pair<std::string, std::string> > m_props;  // name, value
+    size_t                                            m_propCursor;  // iterateProperties()
 };
 
 class NxDmeMgrImpl : public NxDmeMgr {
@@ -52,6 +60,11 @@ public:
     bool unwatch(const std::string &sInDn,const std::string &pattern = "");
     bool setDmeHandler(NxDmeMgrHandler *handler);
     NxDmeMgrHandler* getDmeHandler();
+    bool setDmeHandler(NxDmeMgrHandler *handler,uint32_t eventMask);
+    uint64_t getSkippedEventCount(uint32_t events = 0xffffffff);
+
+private:
+    NxEventFilter m_handlerFilter;  // events of the handler
 };
 }
 #endif // __nx_dme_impl_H__ 
\ No newline at end of file
@@ -0,0 +1,56 @@
+/** **********************************************************************
+    * Event mask of a manager handler.
+    *
+    * The events of a handler are bits of a 32 bit mask, set with the
+    * handler. An event out of the mask is dropped before it is built &
+    * counted by its bit. Read & counted without a lock, the event loop
+    * drops events while the App reads the counts.
+    *
+    * Copyright (c) 2017 by cisco Systems, Inc.
+    *
+    * All rights reserved.
+************************************************************************/
+#ifndef __nx_event_filter_H__
+#define __nx_event_filter_H__
+
+#include <stdint.h>
+#include <cstring>
+
+namespace nxos {
+
+class NxEventFilter {
+public:
+    static const unsigned int BITS = 32;
+
+    NxEventFilter() : m_mask(0xffffffff) { memset(m_skipped, 0, sizeof(m_skipped)); }
+
+    void setMask(uint32_t mask) { __atomic_store_n(&m_mask, mask, __ATOMIC_RELAXED); }
+    uint32_t mask() const { return __atomic_load_n(&m_mask, __ATOMIC_RELAXED); }
+
+    /* True if event, a single bit, is in the mask, else count events of
+     * it are skipped. */
+    bool wants(uint32_t event, uint64_t count = 1) {
+        if (mask() & event) return true;
+        __atomic_fetch_add(&m_skipped[__builtin_ctz(event)], count, __ATOMIC_RELAXED);
+        return false;
+    }
+
+    /* Events skipped of all the bits of events. */
+    uint64_t skipped(uint32_t events) const {
+        uint64_t count = 0;
+
+        for (unsigned int bit = 0; bit < BITS; bit++) {
+            if (events & (1U << bit)) {
+                count += __atomic_load_n(&m_skipped[bit], __ATOMIC_RELAXED);
+            }
+        }
+        return count;
+    }
+
+private:
+    uint32_t  m_mask;
+    uint64_t  m_skipped[BITS];
+};
+
+}
+#endif // __nx_event_filter_H__
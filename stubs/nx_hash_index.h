@@ -0,0 +1,112 @@
+/** **********************************************************************
+    * Open addressing hash index shared by the compact tables of the
+    * managers: the interface & string tables of NxIntfMgr & the MAC
+    * table of NxMacMgr.
+    *
+    * Copyright (c) 2017 by cisco Systems, Inc.
+    *
+    * All rights reserved.
+************************************************************************/
+#ifndef __nx_hash_index_H__
+#define __nx_hash_index_H__
+
+#include <stdint.h>
+#include <vector>
+
+namespace nxos {
+
+/*
+ * Open addressing index of non zero 32 bit values, linear probing with
+ * backward shift deletion. The values are ids of the owner, Keys gives
+ * hashOf(value), hashKey(key) & match(value, key) for them.
+ */
+template <class Keys>
+class NxHashIndex {
+public:
+    NxHashIndex() : m_count(0) {}
+
+    /* Value matching key, 0 if none. */
+    template <class Key>
+    uint32_t find(const Keys &keys, const Key &key) const {
+        if (m_slots.empty()) return 0;
+
+        uint32_t mask = (uint32_t)m_slots.size() - 1;
+
+        for (uint32_t i = keys.hashKey(key) & mask; m_slots[i];
+             i = (i + 1) & mask) {
+            if (keys.match(m_slots[i], key)) return m_slots[i];
+        }
+        return 0;
+    }
+
+    void insert(const Keys &keys, uint32_t value);
+    void erase(const Keys &keys, uint32_t value);
+    size_t memUsage() const { return m_slots.capacity() * sizeof(uint32_t); }
+
+private:
+    void place(const Keys &keys, uint32_t value);
+
+    std::vector<uint32_t>  m_slots;  // power of 2, at most half full
+    uint32_t               m_count;
+};
+
+template <class Keys> void
+NxHashIndex<Keys>::place(const Keys &keys, uint32_t value)
+{
+    uint32_t mask = (uint32_t)m_slots.size() - 1;
+    uint32_t i    = keys.hashOf(value) & mask;
+
+    while (m_slots[i]) i = (i + 1) & mask;
+    m_slots[i] = value;
+}
+
+template <class Keys> void
+NxHashIndex<Keys>::insert(const Keys &keys, uint32_t value)
+{
+    if ((m_count + 1) * 2 > m_slots.size()) {
+        std::vector<uint32_t> old;
+
+        old.swap(m_slots);
+        m_slots.assign(old.empty() ? 64 : old.size() * 2, 0);
+        for (size_t i = 0; i < old.size(); i++) {
+            if (old[i]) place(keys, old[i]);
+        }
+    }
+    place(keys, value);
+    m_count++;
+}
+
+template <class Keys> void
+NxHashIndex<Keys>::erase(const Keys &keys, uint32_t value)
+{
+    uint32_t mask, i, j, home;
+
+    if (m_slots.empty()) return;
+
+    mask = (uint32_t)m_slots.size() - 1;
+    for (i = keys.hashOf(value) & mask; m_slots[i] != value;
+         i = (i + 1) & mask) {
+        if (!m_slots[i]) return;
+    }
+
+    // Shift back the values of the cluster that probed past i.
+    m_count--;
+    for (j = i;;) {
+        m_slots[i] = 0;
+        for (;;) {
+            j = (j + 1) & mask;
+            if (!m_slots[j]) return;
+
+            home = keys.hashOf(m_slots[j]) & mask;
+            if ((i <= j) ? ((home <= i) || (home > j)) :
+                           ((home <= i) && (home > j))) {
+                break;
+            }
+        }
+        m_slots[i] = m_slots[j];
+        i = j;
+    }
+}
+
+}
+#endif // __nx_hash_index_H__
@@ -0,0 +1,432 @@
+/** **********************************************************************
+    * Interface counter samples, rates & threshold crossings.
+    *
+    * The event loop copies the counters last read of the sampled
+    * interfaces into a frame of the ring every interval, computes the
+    * rates of all of them from the 2 newest frames & notifies the
+    * interfaces that went over (or) back under the threshold. The App
+    * reads the frames without holding the manager lock.
+    *
+    * Copyright (c) 2017 by cisco Systems, Inc.
+    *
+    * All rights reserved.
+************************************************************************/
+#include <cstring>
+#include "nx_intf_mgr_impl.h"
+
+using namespace std;
+
+namespace nxos {
+
+const uint32_t NxIntfCounterRing::NONE;
+
+double
+nxIntfSpeedBps(uint32_t speed)
+{
+   switch (speed) {
+   case INTF_SPEED_AUTO:
+   case INTF_SPEED_UNKNOWN:
+      return 0;
+   case INTF_SPEED_AUTO_100:
+      return 100e6;
+   case INTF_SPEED_AUTO_100_1000:
+      return 1000e6;
+   default:
+      return speed * 1e6;
+   }
+}
+
+/* Increase from prev to cur, 0 if the counter was cleared. Branchless so
+ * the loops over the ports vectorize. */
+static inline uint64_t
+nxCtrDelta(uint64_t prev, uint64_t cur)
+{
+   return (cur - prev) & -(uint64_t)(cur >= prev);
+}
+
+void
+nxIntfRatesOf(const NxIntfCounters& prev, const NxIntfCounters& cur,
+              double speedBps, NxIntfRates* rates)
+{
+   uint64_t ms    = nxCtrDelta(prev.timeMs, cur.timeMs);
+   double   scale = ms ? (1000.0 / ms) : 0;
+
+   rates->intervalMs = (uint32_t)ms;
+   rates->rxBps      = nxCtrDelta(prev.rxBytes, cur.rxBytes) * 8 * scale;
+   rates->txBps      = nxCtrDelta(prev.txBytes, cur.txBytes) * 8 * scale;
+   rates->rxPps      = nxCtrDelta(prev.rxPackets, cur.rxPackets) * scale;
+   rates->txPps      = nxCtrDelta(prev.txPackets, cur.txPackets) * scale;
+   rates->rxErrorsPs = nxCtrDelta(prev.rxErrors, cur.rxErrors) * scale;
+   rates->txErrorsPs = nxCtrDelta(prev.txErrors, cur.txErrors) * scale;
+   rates->rxDropsPs  = nxCtrDelta(prev.rxDrops, cur.rxDrops) * scale;
+   rates->txDropsPs  = nxCtrDelta(prev.txDrops, cur.txDrops) * scale;
+   rates->rxUtil     = (speedBps > 0) ? (rates->rxBps * 100 / speedBps) : 0;
+   rates->txUtil     = (speedBps > 0) ? (rates->txBps * 100 / speedBps) : 0;
+}
+
+NxIntfCounterRing::NxIntfCounterRing(const vector<uint32_t>& slots,
+                                     uint32_t history)
+   : m_ports((uint32_t)slots.size()), m_history(history), m_slots(slots),
+     m_cur(NX_INTF_CTR_MAX * slots.size(), 0), m_speeds(slots.size(), 0),
+     m_pctPerByte(slots.size(), 0),
+     m_frames(0), m_readers(0)
+{
+   uint32_t frames = 2;
+
+   // One frame more than kept, the one being written.
+   while (frames < history + 1) frames *= 2;
+   m_mask = frames - 1;
+   m_data.assign((size_t)frames * NX_INTF_CTR_MAX * m_ports, 0);
+   m_times.assign(frames, 0);
+   m_gens.assign(frames, 0);
+   m_seqs.assign(frames, 0);
+   for (uint32_t port = 0; port < m_ports; port++) m_portOf[slots[port]] = port;
+}
+
+uint32_t
+NxIntfCounterRing::port(uint32_t slot) const
+{
+   map<uint32_t, uint32_t>::const_iterator it = m_portOf.find(slot);
+
+   return (it == m_portOf.end()) ? NONE : it->second;
+}
+
+void
+NxIntfCounterRing::setCurrent(uint32_t port, const NxIntfCounters& counters)
+{
+   const uint64_t *ctrs = &counters.rxBytes;
+
+   for (int ctr = 0; ctr < NX_INTF_CTR_MAX; ctr++) {
+      m_cur[(ctr * m_ports) + port] = ctrs[ctr];
+   }
+}
+
+void
+NxIntfCounterRing::push(uint64_t timeMs)
+{
+   uint64_t  n   = m_frames;
+   uint32_t  f   = (uint32_t)(n & m_mask);
+   uint32_t *seq = &m_seqs[f];
+
+   __atomic_store_n(seq, *seq + 1, __ATOMIC_RELAXED);
+   __atomic_thread_fence(__ATOMIC_RELEASE);
+   memcpy(&m_data[(size_t)f * m_cur.size()], &m_cur[0],
+          m_cur.size() * sizeof(uint64_t));
+   m_times[f] = timeMs;
+   m_gens[f]  = n;
+   __atomic_store_n(seq, *seq + 1, __ATOMIC_RELEASE);
+   __atomic_store_n(&m_frames, n + 1, __ATOMIC_RELEASE);
+}
+
+uint64_t
+NxIntfCounterRing::frames() const
+{
+   return __atomic_load_n(&m_frames, __ATOMIC_ACQUIRE);
+}
+
+bool
+NxIntfCounterRing::read(uint32_t port, uint64_t n,
+                        NxIntfCounters* counters) const
+{
+   uint64_t *ctrs = &counters->rxBytes;
+   uint32_t  f    = (uint32_t)(n & m_mask);
+   uint32_t  seq;
+   uint64_t  gen;
+
+   if ((port >= m_ports) || (n >= frames())) return false;
+
+   for (;;) {
+      if ((seq = __atomic_load_n(&m_seqs[f], __ATOMIC_ACQUIRE)) & 1) continue;
+
+      gen              = m_gens[f];
+      counters->timeMs = m_times[f];
+      for (int ctr = 0; ctr < NX_INTF_CTR_MAX; ctr++) {
+         ctrs[ctr] = frame(n)[(ctr * m_ports) + port];
+      }
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+      if (__atomic_load_n(&m_seqs[f], __ATOMIC_RELAXED) == seq) break;
+   }
+   return (gen == n);
+}
+
+/*
+ * The counters of a frame are in arrays of all the ports so each rate is
+ * a branchless loop over contiguous arrays, vectorized at -O3 (the
+ * 64 bit counter to double conversion needs AVX-512DQ).
+ */
+bool
+NxIntfCounterRing::rates(vector<double>* perSec, vector<double>* rxUtil,
+                         vector<double>* txUtil, uint32_t* intervalMs) const
+{
+   const uint64_t *cur, *prev;
+   const double   *pctPerByte = &m_pctPerByte[0];
+   const double   *rx, *tx;
+   double         *out, *rxOut, *txOut;
+   uint64_t        ms;
+   double          scale;
+
+   if ((m_frames < 2) || !m_ports) return false;
+
+   cur   = frame(m_frames - 1);
+   prev  = frame(m_frames - 2);
+   ms    = nxCtrDelta(m_times[(m_frames - 2) & m_mask],
+                      m_times[(m_frames - 1) & m_mask]);
+   scale = ms ? (1000.0 / ms) : 0;
+   *intervalMs = (uint32_t)ms;
+
+   perSec->resize(m_cur.size());
+   rxUtil->resize(m_ports);
+   txUtil->resize(m_ports);
+   out = &(*perSec)[0];
+   for (size_t i = 0; i < m_cur.size(); i++) {
+      out[i] = nxCtrDelta(prev[i], cur[i]) * scale;
+   }
+
+   rx    = out + (NX_INTF_CTR_RX_BYTES * m_ports);
+   tx    = out + (NX_INTF_CTR_TX_BYTES * m_ports);
+   rxOut = &(*rxUtil)[0];
+   txOut = &(*txUtil)[0];
+   for (uint32_t p = 0; p < m_ports; p++) {
+      rxOut[p] = rx[p] * pctPerByte[p];
+      txOut[p] = tx[p] * pctPerByte[p];
+   }
+   return true;
+}
+
+bool
+NxIntfMgrImpl::watchIntfCounters(const std::vector<std::string>& names, unsigned int intervalMs, unsigned int history)
+{
+   vector<uint32_t> slots, ifindexes;
+   uint32_t         slot;
+
+   if ((intervalMs < 1000) || (history < 2) || (history > 4096)) return false;
+
+   pthread_mutex_lock(&m_lock);
+   for (size_t i = 0; i < names.size(); i++) {
+      if ((slot = m_store.find(names[i])) == NxIntfStore::NONE) {
+         pthread_mutex_unlock(&m_lock);
+         return false;
+      }
+      slots.push_back(slot);
+      ifindexes.push_back(m_store.rec(slot).ifindex);
+   }
+
+   // The App may still be reading the old ring, freed once it is not.
+   if (m_ctrRing) m_ctrRetired.push_back(m_ctrRing);
+   freeIntfCounterRings();
+   m_ctrRing       = slots.empty() ? NULL :
+                                     new NxIntfCounterRing(slots, history);
+   m_ctrIntervalMs = slots.empty() ? 0 : intervalMs;
+   m_ctrIfindexes.swap(ifindexes);
+   m_ctrExceeded.assign(slots.size(), 0);
+   pthread_mutex_unlock(&m_lock);
+   return true;
+}
+
+bool
+NxIntfMgrImpl::setIntfCounterThreshold(const nxos::NxIntfCounterThreshold& threshold)
+{
+   if ((threshold.utilPct < 0) || (threshold.clearPct < 0) ||
+       (threshold.errorRate < 0) || (threshold.clearPct > threshold.utilPct)) {
+      return false;
+   }
+
+   pthread_mutex_lock(&m_lock);
+   m_ctrThreshold = threshold;
+   if (!m_ctrThreshold.clearPct) m_ctrThreshold.clearPct = threshold.utilPct;
+   m_ctrExceeded.assign(m_ctrExceeded.size(), 0);
+   pthread_mutex_unlock(&m_lock);
+   return true;
+}
+
+void
+NxIntfMgrImpl::freeIntfCounterRings()
+{
+   size_t n = 0;
+
+   for (size_t i = 0; i < m_ctrRetired.size(); i++) {
+      if (m_ctrRetired[i]->held()) {
+         m_ctrRetired[n++] = m_ctrRetired[i];
+      } else {
+         delete m_ctrRetired[i];
+      }
+   }
+   m_ctrRetired.resize(n);
+}
+
+NxIntfCounterRing*
+NxIntfMgrImpl::getIntfCounterPort(const std::string& name, uint32_t* port)
+{
+   uint32_t slot = m_store.find(name);
+
+   if (!m_ctrRing || (slot == NxIntfStore::NONE)) return NULL;
+   if ((*port = m_ctrRing->port(slot)) == NxIntfCounterRing::NONE) return NULL;
+   if (m_ctrIfindexes[*port] != m_store.rec(slot).ifindex) return NULL;
+   m_ctrRing->hold();
+   return m_ctrRing;
+}
+
+bool
+NxIntfMgrImpl::getIntfRates(const std::string& name, nxos::NxIntfRates* rates)
+{
+   NxIntfCounterRing *ring;
+   NxIntfCounters     prev, cur;
+   uint32_t           port;
+   uint64_t           n;
+   double             speed = 0;
+   bool               ok;
+
+   if (!rates) return false;
+
+   pthread_mutex_lock(&m_lock);
+   if ((ring = getIntfCounterPort(name, &port))) speed = ring->speed(port);
+   pthread_mutex_unlock(&m_lock);
+
+   if (!ring) return false;
+
+   ok = ((n = ring->frames()) >= 2) && ring->read(port, n - 2, &prev) &&
+        ring->read(port, n - 1, &cur);
+   ring->release();
+   if (ok) nxIntfRatesOf(prev, cur, speed, rates);
+   return ok;
+}
+
+unsigned int
+NxIntfMgrImpl::getIntfCounters(const std::string& name, std::vector<nxos::NxIntfCounters>* samples)
+{
+   NxIntfCounterRing *ring;
+   NxIntfCounters     counters;
+   uint32_t           port;
+   uint64_t           n, first;
+
+   if (!samples) return 0;
+
+   samples->clear();
+   pthread_mutex_lock(&m_lock);
+   ring = getIntfCounterPort(name, &port);
+   pthread_mutex_unlock(&m_lock);
+   if (!ring) return 0;
+
+   n     = ring->frames();
+   first = (n > ring->history()) ? (n - ring->history()) : 0;
+   for (; first < n; first++) {
+      if (ring->read(port, first, &counters)) samples->push_back(counters);
+   }
+   ring->release();
+   return (unsigned int)samples->size();
+}
+
+void
+NxIntfMgrImpl::postIntfCountersMsg(uint32_t ifindex, const NxIntfCounters& counters)
+{
+   uint32_t slot, port;
+
+   pthread_mutex_lock(&m_lock);
+   slot = m_store.findIfindex(ifindex);
+   if (m_ctrRing && (slot != NxIntfStore::NONE) &&
+       ((port = m_ctrRing->port(slot)) != NxIntfCounterRing::NONE) &&
+       (m_ctrIfindexes[port] == ifindex)) {
+      m_ctrRing->setCurrent(port, counters);
+   }
+   pthread_mutex_unlock(&m_lock);
+}
+
+unsigned int
+NxIntfMgrImpl::getIntfCounterIntervalMs()
+{
+   unsigned int intervalMs;
+
+   pthread_mutex_lock(&m_lock);
+   intervalMs = m_ctrIntervalMs;
+   pthread_mutex_unlock(&m_lock);
+   return intervalMs;
+}
+
+/*
+ * Take a sample of the watched interfaces & notify the ones that crossed
+ * the threshold, the handler is called without the lock.
+ */
+void
+NxIntfMgrImpl::sampleIntfCounters(uint64_t nowMs)
+{
+   const NxIntfCounterThreshold &t = m_ctrThreshold;
+   vector<pair<NxIntf *, NxIntfRates> > crossed;
+   vector<bool>                         exceeded;
+   NxIntfMgrHandler                    *handler;
+   NxIntfRates                          rates;
+   const double                        *perSec;
+   uint32_t                             ports, slot, intervalMs;
+   double                               util, errs;
+   bool                                 over, under;
+
+   if (!nowMs) nowMs = nxIntfNowMs();
+
+   pthread_mutex_lock(&m_lock);
+   if (!m_ctrRetired.empty()) freeIntfCounterRings();
+   if (!m_ctrRing) {
+      pthread_mutex_unlock(&m_lock);
+      return;
+   }
+
+   ports = m_ctrRing->ports();
+   for (uint32_t port = 0; port < ports; port++) {
+      slot = m_ctrRing->slot(port);
+      if (m_store.used(slot) && (m_store.rec(slot).ifindex == m_ctrIfindexes[port])) {
+         m_ctrRing->setSpeed(port, nxIntfSpeedBps(m_store.rec(slot).speed));
+      }
+   }
+   m_ctrRing->push(nowMs);
+
+   if ((t.utilPct || t.errorRate) &&
+       m_ctrRing->rates(&m_ctrRates, &m_ctrRxUtil, &m_ctrTxUtil, &intervalMs)) {
+      perSec = &m_ctrRates[0];
+      for (uint32_t port = 0; port < ports; port++) {
+         util = max(m_ctrRxUtil[port], m_ctrTxUtil[port]);
+         errs = perSec[(NX_INTF_CTR_RX_ERRORS * ports) + port] +
+                perSec[(NX_INTF_CTR_TX_ERRORS * ports) + port] +
+                perSec[(NX_INTF_CTR_RX_DROPS * ports) + port] +
+                perSec[(NX_INTF_CTR_TX_DROPS * ports) + port];
+         over  = ((t.utilPct > 0) && (util >= t.utilPct)) ||
+                 ((t.errorRate > 0) && (errs >= t.errorRate));
+         under = ((t.utilPct <= 0) || (util < t.clearPct)) &&
+                 ((t.errorRate <= 0) || (errs < t.errorRate));
+         if (m_ctrExceeded[port] ? !under : !over) continue;
+
+         slot = m_ctrRing->slot(port);
+         if (!m_store.used(slot) ||
+             (m_store.rec(slot).ifindex != m_ctrIfindexes[port])) {
+            continue;
+         }
+         m_ctrExceeded[port]  = !m_ctrExceeded[port];
+         if (!m_handler || !m_handlerFilter.wants(
+                              NxIntfMgrHandler::EVENT_COUNTER_THRESHOLD)) {
+            continue;
+         }
+         rates.intervalMs     = intervalMs;
+         rates.rxBps          = perSec[(NX_INTF_CTR_RX_BYTES * ports) + port] * 8;
+         rates.txBps          = perSec[(NX_INTF_CTR_TX_BYTES * ports) + port] * 8;
+         rates.rxPps          = perSec[(NX_INTF_CTR_RX_PKTS * ports) + port];
+         rates.txPps          = perSec[(NX_INTF_CTR_TX_PKTS * ports) + port];
+         rates.rxErrorsPs     = perSec[(NX_INTF_CTR_RX_ERRORS * ports) + port];
+         rates.txErrorsPs     = perSec[(NX_INTF_CTR_TX_ERRORS * ports) + port];
+         rates.rxDropsPs      = perSec[(NX_INTF_CTR_RX_DROPS * ports) + port];
+         rates.txDropsPs      = perSec[(NX_INTF_CTR_TX_DROPS * ports) + port];
+         rates.rxUtil         = m_ctrRxUtil[port];
+         rates.txUtil         = m_ctrTxUtil[port];
+         crossed.push_back(make_pair((NxIntf *)getHandle(slot), rates));
+         exceeded.push_back(m_ctrExceeded[port]);
+      }
+   }
+   handler = m_handler;
+   pthread_mutex_unlock(&m_lock);
+
+   for (size_t i = 0; handler && (i < crossed.size()); i++) {
+      try {
+         handler->postIntfCounterThresholdCb(crossed[i].first,
+                                             crossed[i].second, exceeded[i]);
+      } catch (...) {
+      }
+   }
+}
+
+}
@@ -0,0 +1,111 @@
+/** **********************************************************************
+    * Interface counter samples of NxIntfMgr::watchIntfCounters().
+    *
+    * The counters of the sampled interfaces are kept in a ring of frames,
+    * a frame holding each counter of all the interfaces back to back so
+    * the rates of all of them are computed in one pass per counter. The
+    * event loop is the only writer & never waits on the readers, each
+    * frame has a sequence number that is odd while it is written so a
+    * reader retries when its frame was overwritten under it.
+    *
+    * Copyright (c) 2017 by cisco Systems, Inc.
+    *
+    * All rights reserved.
+************************************************************************/
+#ifndef __nx_intf_counters_H__
+#define __nx_intf_counters_H__
+
+#include <stdint.h>
+#include <map>
+#include <vector>
+#include "nx_intf_mgr.h"
+
+namespace nxos {
+
+/* Counters of a frame, in the order of NxIntfCounters. */
+enum {
+    NX_INTF_CTR_RX_BYTES = 0,
+    NX_INTF_CTR_TX_BYTES,
+    NX_INTF_CTR_RX_PKTS,
+    NX_INTF_CTR_TX_PKTS,
+    NX_INTF_CTR_RX_ERRORS,
+    NX_INTF_CTR_TX_ERRORS,
+    NX_INTF_CTR_RX_DROPS,
+    NX_INTF_CTR_TX_DROPS,
+    NX_INTF_CTR_MAX
+};
+
+/* INTF_SPEED_* value to bits per second, 0 if not known. */
+double nxIntfSpeedBps(uint32_t speed);
+
+/* Rates of a port between prev & cur sampled intervalMs apart. */
+void nxIntfRatesOf(const NxIntfCounters &prev, const NxIntfCounters &cur,
+                   double speedBps, NxIntfRates *rates);
+
+/*
+ * Samples of a fixed set of interface slots. The shape never changes,
+ * a new set gets a new ring.
+ */
+class NxIntfCounterRing {
+public:
+    static const uint32_t NONE = 0xffffffff;
+
+    /* Keeps at least history frames of the slots. */
+    NxIntfCounterRing(const std::vector<uint32_t> &slots, uint32_t history);
+
+    uint32_t ports() const { return m_ports; }
+    uint32_t history() const { return m_history; }
+    uint32_t slot(uint32_t port) const { return m_slots[port]; }
+    /* Port of slot, NONE if not sampled. */
+    uint32_t port(uint32_t slot) const;
+
+    /* Counters last read of port, copied into the next frame. */
+    void setCurrent(uint32_t port, const NxIntfCounters &counters);
+    void setSpeed(uint32_t port, double speedBps) {
+        m_speeds[port]     = speedBps;
+        m_pctPerByte[port] = (speedBps > 0) ? (800 / speedBps) : 0;
+    }
+    double speed(uint32_t port) const { return m_speeds[port]; }
+
+    /* Writer: append the current counters as a frame taken at timeMs. */
+    void push(uint64_t timeMs);
+    /* Writer: per second rates of the 2 newest frames, by counter then
+     * port, & utilization percent of rx & tx by port. False if less than
+     * 2 frames. */
+    bool rates(std::vector<double> *perSec, std::vector<double> *rxUtil,
+               std::vector<double> *txUtil, uint32_t *intervalMs) const;
+
+    /* Frames pushed so far. */
+    uint64_t frames() const;
+    /* Reader: frame n of port, false if it is not (or) no longer kept. */
+    bool read(uint32_t port, uint64_t n, NxIntfCounters *counters) const;
+
+    /* Readers of the ring outside the manager lock, held under it. A
+     * replaced ring is freed once no reader holds it. */
+    void hold() { __atomic_add_fetch(&m_readers, 1, __ATOMIC_RELAXED); }
+    void release() { __atomic_sub_fetch(&m_readers, 1, __ATOMIC_RELEASE); }
+    bool held() const { return __atomic_load_n(&m_readers, __ATOMIC_ACQUIRE) != 0; }
+
+private:
+    const uint64_t *frame(uint64_t n) const {
+        return &m_data[(n & m_mask) * NX_INTF_CTR_MAX * m_ports];
+    }
+
+    uint32_t                      m_ports;
+    uint32_t                      m_history;
+    uint32_t                      m_mask;    // frames - 1, power of 2
+    std::vector<uint32_t>         m_slots;   // by port
+    std::map<uint32_t, uint32_t>  m_portOf;  // by slot
+    std::vector<uint64_t>         m_cur;     // by counter then port
+    std::vector<double>           m_speeds;  // by port, bits per second
+    std::vector<double>           m_pctPerByte;  // by port, util of a B/s
+    std::vector<uint64_t>         m_data;    // frames of m_cur
+    std::vector<uint64_t>         m_times;   // by frame, timeMs
+    std::vector<uint64_t>         m_gens;    // by frame, n it holds
+    std::vector<uint32_t>         m_seqs;    // by frame, odd when written
+    uint64_t                      m_frames;
+    uint32_t                      m_readers;
+};
+
+}
+#endif // __nx_intf_counters_H__
@@ -0,0 +1,63 @@
+/** **********************************************************************
+    * Interface dictionary shared by the managers.
+    *
+    * Copyright (c) 2017 by cisco Systems, Inc.
+    *
+    * All rights reserved.
+************************************************************************/
+#include "nx_intf_dict.h"
+
+using namespace std;
+
+namespace nxos {
+
+NxIntfDict::NxIntfDict()
+{
+   pthread_mutex_init(&m_lock, NULL);
+}
+
+NxIntfDict&
+NxIntfDict::get()
+{
+   // Never destroyed, the managers may use it from static destructors.
+   static NxIntfDict *dict = new NxIntfDict();
+
+   return *dict;
+}
+
+uint32_t
+NxIntfDict::ifindex(const string& name, bool create)
+{
+   uint32_t id;
+
+   if (name.empty()) return 0;
+
+   pthread_mutex_lock(&m_lock);
+   if (!(id = m_names.find(name)) && create) id = m_names.intern(name);
+   pthread_mutex_unlock(&m_lock);
+   return id;
+}
+
+string
+NxIntfDict::name(uint32_t ifindex)
+{
+   string name;
+
+   pthread_mutex_lock(&m_lock);
+   if (ifindex && (ifindex < m_names.idEnd())) name = m_names.c_str(ifindex);
+   pthread_mutex_unlock(&m_lock);
+   return name;
+}
+
+size_t
+NxIntfDict::memUsage()
+{
+   size_t bytes;
+
+   pthread_mutex_lock(&m_lock);
+   bytes = m_names.memUsage();
+   pthread_mutex_unlock(&m_lock);
+   return bytes;
+}
+
+}
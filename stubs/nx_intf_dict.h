@@ -0,0 +1,44 @@
+/** **********************************************************************
+    * Interface dictionary shared by the managers.
+    *
+    * Maps an interface name to a stable 32 bit ifindex so the tables of
+    * the managers key & join their interfaces by integer. The names are
+    * interned in a string pool & never released, the ifindex of a name
+    * is its id in the pool: it is dense, never reused & stays the same
+    * when the interface is deleted & created again. 0 is no interface.
+    *
+    * Copyright (c) 2017 by cisco Systems, Inc.
+    *
+    * All rights reserved.
+************************************************************************/
+#ifndef __nx_intf_dict_H__
+#define __nx_intf_dict_H__
+
+#include <stdint.h>
+#include <pthread.h>
+#include <string>
+#include "nx_intf_store.h"
+
+namespace nxos {
+
+class NxIntfDict {
+public:
+    /* The dictionary of the process. */
+    static NxIntfDict &get();
+
+    /* Ifindex of name, added if create is set. 0 if name is empty (or)
+     * not added. */
+    uint32_t ifindex(const std::string &name, bool create = true);
+    /* Name of ifindex, "" if not added. */
+    std::string name(uint32_t ifindex);
+    size_t memUsage();
+
+private:
+    NxIntfDict();
+
+    pthread_mutex_t  m_lock;
+    NxStrPool        m_names;
+};
+
+}
+#endif // __nx_intf_dict_H__
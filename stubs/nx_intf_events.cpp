@@ -0,0 +1,257 @@
+/** **********************************************************************
+    * Dampening & conflation of the interface oper state events.
+    *
+    * The record of an interface always has its latest oper state, only
+    * the postIntfStateCb() calls are held back. Dampening follows the
+    * NX-OS interface dampening: a penalty per change to down that decays
+    * exponentially, suppressing the interface from the suppress threshold
+    * until it decays below the reuse one. Conflation delivers the first
+    * change of an interface at once & the latest of its further changes
+    * at the end of the window. Handlers are called without the lock.
+    *
+    * Copyright (c) 2017 by cisco Systems, Inc.
+    *
+    * All rights reserved.
+************************************************************************/
+#include <cmath>
+#include <cstring>
+#include "nx_intf_mgr_impl.h"
+
+using namespace std;
+using namespace nxos;
+
+/* Decay the penalty of st to nowMs under policy. */
+static void
+nxIntfDecayPenalty(NxIntfEventState* st, const NxIntfDampening& policy,
+                   uint64_t nowMs)
+{
+   if (nowMs > st->penaltyMs) {
+      st->stats.penalty *= pow(0.5, (double)(nowMs - st->penaltyMs) /
+                                    policy.halfLifeMs);
+   }
+   st->penaltyMs = nowMs;
+}
+
+/* Penalty from which an interface stays suppressed maxSuppressMs. */
+static double
+nxIntfMaxPenalty(const NxIntfDampening& policy)
+{
+   return policy.reuse * pow(2.0, (double)policy.maxSuppressMs /
+                                  policy.halfLifeMs);
+}
+
+const NxIntfDampening&
+NxIntfMgrImpl::dampeningOf(uint32_t ifindex)
+{
+   map<uint32_t, NxIntfDampening>::const_iterator it =
+      m_dampPolicies.find(ifindex);
+
+   return (it == m_dampPolicies.end()) ? m_dampDefault : it->second;
+}
+
+void
+NxIntfMgrImpl::deliverIntfState(uint32_t slot, NxIntfEventState* st,
+                                uint64_t nowMs, vector<NxIntf *>* out)
+{
+   st->delivered = m_store.rec(slot).operState;
+   st->pending   = false;
+   if (m_conflateMs) st->windowEndMs = nowMs + m_conflateMs;
+   st->stats.delivered++;
+   m_eventStats.delivered++;
+   out->push_back(getHandle(slot));
+}
+
+void
+NxIntfMgrImpl::notifyIntfState(const vector<NxIntf *>& intfs)
+{
+   for (size_t i = 0; m_handler && (i < intfs.size()); i++) {
+      try {
+         m_handler->postIntfStateCb(intfs[i]);
+      } catch (...) {
+      }
+   }
+}
+
+bool
+NxIntfMgrImpl::setIntfStateDampening(const nxos::NxIntfDampening& policy, const std::string& name)
+{
+   uint32_t slot = NxIntfStore::NONE;
+
+   if (policy.penalty &&
+       (!policy.reuse || (policy.reuse >= policy.suppress) ||
+        !policy.halfLifeMs || !policy.maxSuppressMs)) {
+      return false;
+   }
+
+   pthread_mutex_lock(&m_lock);
+   if (!name.empty() && ((slot = m_store.find(name)) == NxIntfStore::NONE)) {
+      pthread_mutex_unlock(&m_lock);
+      return false;
+   }
+   if (slot == NxIntfStore::NONE) {
+      m_dampDefault = policy;
+   } else {
+      m_dampPolicies[m_store.rec(slot).ifindex] = policy;
+   }
+   pthread_mutex_unlock(&m_lock);
+   return true;
+}
+
+bool
+NxIntfMgrImpl::setIntfStateConflation(unsigned int windowMs)
+{
+   pthread_mutex_lock(&m_lock);
+   m_conflateMs = windowMs;
+   pthread_mutex_unlock(&m_lock);
+   return true;
+}
+
+bool
+NxIntfMgrImpl::getIntfEventStats(nxos::NxIntfEventStats* stats, const std::string& name)
+{
+   map<uint32_t, NxIntfEventState>::iterator it;
+   uint32_t slot;
+   bool     found = true;
+
+   if (!stats) return false;
+
+   pthread_mutex_lock(&m_lock);
+   if (name.empty()) {
+      *stats = m_eventStats;
+   } else if ((slot = m_store.find(name)) == NxIntfStore::NONE) {
+      found = false;
+   } else {
+      const uint32_t ifindex = m_store.rec(slot).ifindex;
+
+      memset(stats, 0, sizeof(*stats));
+      if ((it = m_events.find(ifindex)) != m_events.end()) {
+         NxIntfEventState st = it->second;
+
+         if (dampeningOf(ifindex).penalty) {
+            nxIntfDecayPenalty(&st, dampeningOf(ifindex), nxIntfNowMs());
+         }
+         *stats            = st.stats;
+         stats->suppressed = st.suppressed;
+      }
+   }
+   pthread_mutex_unlock(&m_lock);
+   return found;
+}
+
+void
+NxIntfMgrImpl::postIntfStateMsg(uint32_t ifindex, state_type_e operState, uint64_t nowMs)
+{
+   map<uint32_t, NxIntfEventState>::iterator it;
+   vector<NxIntf *>  out;
+   NxIntfEventState *st;
+   NxIntfRec        *rec;
+   uint32_t          slot;
+
+   if (operState >= S_MAX_TYPE) return;
+   if (!nowMs) nowMs = nxIntfNowMs();
+
+   pthread_mutex_lock(&m_lock);
+   if ((slot = m_store.findIfindex(ifindex)) == NxIntfStore::NONE) {
+      pthread_mutex_unlock(&m_lock);
+      return;
+   }
+
+   rec = &m_store.rec(slot);
+   if (m_handler && !m_handlerFilter.wants(NxIntfMgrHandler::EVENT_STATE)) {
+      // Not dampened nor conflated, no change is delivered.
+      rec->operState = operState;
+      rec->event     = UPDATE;
+      pthread_mutex_unlock(&m_lock);
+      return;
+   }
+   if ((it = m_events.find(ifindex)) == m_events.end()) {
+      it = m_events.insert(make_pair(ifindex, NxIntfEventState())).first;
+      memset(&it->second, 0, sizeof(it->second));
+      it->second.delivered = rec->operState;
+      it->second.penaltyMs = nowMs;
+   }
+   st              = &it->second;
+   rec->operState  = operState;
+   rec->event      = UPDATE;
+   st->stats.received++;
+   m_eventStats.received++;
+
+   const NxIntfDampening &policy = dampeningOf(ifindex);
+
+   if (policy.penalty) {
+      nxIntfDecayPenalty(st, policy, nowMs);
+      if (operState == DOWN) {
+         st->stats.penalty = min(st->stats.penalty + policy.penalty,
+                                 nxIntfMaxPenalty(policy));
+      }
+      if (!st->suppressed && (st->stats.penalty >= policy.suppress)) {
+         st->suppressed = true;
+         st->pending    = false;
+         m_eventStats.suppressed++;
+      }
+   }
+
+   if (st->suppressed) {
+      st->stats.dampened++;
+      m_eventStats.dampened++;
+   } else if (m_conflateMs && (nowMs < st->windowEndMs)) {
+      // The change it replaces is the one conflated.
+      if (st->pending) {
+         st->stats.conflated++;
+         m_eventStats.conflated++;
+      }
+      st->pending = true;
+   } else {
+      deliverIntfState(slot, st, nowMs, &out);
+   }
+   pthread_mutex_unlock(&m_lock);
+
+   notifyIntfState(out);
+}
+
+void
+NxIntfMgrImpl::pollIntfEvents(uint64_t nowMs)
+{
+   map<uint32_t, NxIntfEventState>::iterator it;
+   vector<NxIntf *>  out;
+   NxIntfEventState *st;
+   uint32_t          slot;
+
+   if (!nowMs) nowMs = nxIntfNowMs();
+
+   pthread_mutex_lock(&m_lock);
+   for (it = m_events.begin(); it != m_events.end();) {
+      st = &it->second;
+      if ((slot = m_store.findIfindex(it->first)) == NxIntfStore::NONE) {
+         if (st->suppressed) m_eventStats.suppressed--;
+         m_events.erase(it++);
+         continue;
+      }
+
+      if (st->suppressed) {
+         const NxIntfDampening &policy = dampeningOf(it->first);
+
+         nxIntfDecayPenalty(st, policy, nowMs);
+         if (!policy.penalty || (st->stats.penalty < policy.reuse)) {
+            st->suppressed  = false;
+            st->windowEndMs = 0;
+            m_eventStats.suppressed--;
+            if (m_store.rec(slot).operState != st->delivered) {
+               deliverIntfState(slot, st, nowMs, &out);
+            }
+         }
+      } else if (st->pending && (nowMs >= st->windowEndMs)) {
+         if (m_store.rec(slot).operState != st->delivered) {
+            deliverIntfState(slot, st, nowMs, &out);
+         } else {
+            st->pending = false;
+            st->stats.conflated++;
+            m_eventStats.conflated++;
+         }
+      }
+      ++it;
+   }
+   pthread_mutex_unlock(&m_lock);
+
+   notifyIntfState(out);
+}
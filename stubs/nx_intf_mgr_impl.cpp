@@ -6,16 +6,40 @@
     *
     * All rights reserved.
 ************************************************************************/
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <time.h>
 #include "nx_intf_mgr_impl.h" 
+#include "nx_intf_dict.h"
+#include "nx_exception.h"
    
 using namespace nxos;
 
    
+
+uint64_t
+nxos::nxIntfNowMs()
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ((uint64_t)ts.tv_sec * 1000) + (ts.tv_nsec / 1000000);
+}
     
 // Implementation for class  
 NxIntfImpl::NxIntfImpl()
+   : m_mgr(NULL), m_slot(NxIntfStore::NONE), m_ifindex(0), m_memberCursor(0)
 {
+   for (int af = AF_START; af < MAX_AF; af++) m_scCursor[af] = 0;
+}
 
+NxIntfImpl::NxIntfImpl(NxIntfMgrImpl* mgr, uint32_t slot)
+   : m_mgr(mgr), m_slot(slot), m_ifindex(mgr->m_store.rec(slot).ifindex),
+     m_memberCursor(0)
+{
+   for (int af = AF_START; af < MAX_AF; af++) m_scCursor[af] = 0;
 }
 
 NxIntfImpl::~NxIntfImpl()
@@ -23,106 +47,222 @@ NxIntfImpl::~NxIntfImpl()
 
 }
 
+/*
+ * Whether the interface of the handle is in the store, m_slot is moved
+ * to its record if it was removed & added again. m_lock held.
+ */
+bool
+NxIntfImpl::present()
+{
+   NxIntfStore &store = m_mgr->m_store;
+
+   if (!store.used(m_slot) || (store.rec(m_slot).ifindex != m_ifindex)) {
+      m_slot = store.findIfindex(m_ifindex);
+   }
+   return (m_slot != NxIntfStore::NONE);
+}
+
+std::string
+NxIntfImpl::getStr(uint32_t NxIntfRec::*field)
+{
+   std::string str;
+
+   if (!m_mgr) return str;
+
+   pthread_mutex_lock(&m_mgr->m_lock);
+   if (present()) str = m_mgr->m_store.str(m_mgr->m_store.rec(m_slot).*field);
+   pthread_mutex_unlock(&m_mgr->m_lock);
+   return str;
+}
+
+bool
+NxIntfImpl::setStr(uint32_t NxIntfRec::*field, const std::string& str)
+{
+   bool found;
+
+   if (!m_mgr) return false;
+
+   pthread_mutex_lock(&m_mgr->m_lock);
+   if ((found = present())) {
+      m_mgr->m_store.strs().assign(&(m_mgr->m_store.rec(m_slot).*field), str);
+   }
+   pthread_mutex_unlock(&m_mgr->m_lock);
+   return found;
+}
+
+template <typename T> T
+NxIntfImpl::getField(T NxIntfRec::*field)
+{
+   T value = 0;
+
+   if (!m_mgr) return 0;
+
+   pthread_mutex_lock(&m_mgr->m_lock);
+   if (present()) value = m_mgr->m_store.rec(m_slot).*field;
+   pthread_mutex_unlock(&m_mgr->m_lock);
+   return value;
+}
+
+template <typename T> bool
+NxIntfImpl::setField(T NxIntfRec::*field, T value)
+{
+   bool found;
+
+   if (!m_mgr) return false;
+
+   pthread_mutex_lock(&m_mgr->m_lock);
+   if ((found = present())) m_mgr->m_store.rec(m_slot).*field = value;
+   pthread_mutex_unlock(&m_mgr->m_lock);
+   return found;
+}
+
 std::string 
 NxIntfImpl::getName()
 {
-   return "";
+   return getStr(&NxIntfRec::name);
 }
 
 std::string 
 NxIntfImpl::getLayer()
 {
-   return "";
+   return getStr(&NxIntfRec::layer);
 }
 
 nxos::intf_type_e 
 NxIntfImpl::getType()
 {
-   return (nxos::intf_type_e)0;
+   return (nxos::intf_type_e)getField(&NxIntfRec::type);
 }
 
 std::string 
 NxIntfImpl::getVrf()
 {
-   return "";
+   return getStr(&NxIntfRec::vrf);
 }
 
 std::string 
 NxIntfImpl::getVlan()
 {
-   return "";
+   uint16_t vlanId = getField(&NxIntfRec::vlan);
+   char     vlan[8] = "";
+
+   if (vlanId) snprintf(vlan, sizeof(vlan), "%u", vlanId);
+   return vlan;
 }
 
 std::string 
 NxIntfImpl::getDescription()
 {
-   return "";
+   return getStr(&NxIntfRec::desc);
 }
 
 std::string 
 NxIntfImpl::getL3PrAddr(af_e af)
 {
-   return "";
+   std::string addr;
+
+   if (!m_mgr || (af >= MAX_AF)) return addr;
+
+   pthread_mutex_lock(&m_mgr->m_lock);
+   if (present()) {
+      addr = m_mgr->m_store.str(m_mgr->m_store.rec(m_slot).prAddr[af]);
+   }
+   pthread_mutex_unlock(&m_mgr->m_lock);
+   return addr;
 }
 
 std::string 
 NxIntfImpl::getL3ScAddr(af_e af, bool fromFirst)
 {
-   return "";
+   NxIntfLists *lists;
+   std::string  addr;
+
+   if (!m_mgr || (af >= MAX_AF)) return addr;
+   if (fromFirst) m_scCursor[af] = 0;
+
+   pthread_mutex_lock(&m_mgr->m_lock);
+   lists = present() ? m_mgr->m_store.lists(m_slot, false) : NULL;
+   if (lists && (m_scCursor[af] < lists->scAddrs[af].size())) {
+      addr = m_mgr->m_store.str(lists->scAddrs[af][m_scCursor[af]++]);
+   }
+   pthread_mutex_unlock(&m_mgr->m_lock);
+   return addr;
 }
 
 std::string 
 NxIntfImpl::getL2Address()
 {
-   return "";
+   return getStr(&NxIntfRec::l2Addr);
 }
 
 std::string 
 NxIntfImpl::getL2AddressHW()
 {
-   return "";
+   return getStr(&NxIntfRec::l2AddrHw);
 }
 
 nxos::state_type_e 
 NxIntfImpl::getAdminState()
 {
-   return (nxos::state_type_e)0;
+   return (nxos::state_type_e)getField(&NxIntfRec::adminState);
 }
 
 nxos::state_type_e 
 NxIntfImpl::getOperState()
 {
-   return (nxos::state_type_e)0;
+   return (nxos::state_type_e)getField(&NxIntfRec::operState);
 }
 
 uint32_t 
 NxIntfImpl::getMtu()
 {
-   return (uint32_t)0;
+   return getField(&NxIntfRec::mtu);
 }
 
 uint32_t 
 NxIntfImpl::getSpeed()
 {
-   return (uint32_t)0;
+   return getField(&NxIntfRec::speed);
 }
 
 unsigned int 
 NxIntfImpl::getMemberCount()
 {
-   return (unsigned int)0;
+   NxIntfLists  *lists;
+   unsigned int  count = 0;
+
+   if (!m_mgr) return 0;
+
+   pthread_mutex_lock(&m_mgr->m_lock);
+   if (present() && (lists = m_mgr->m_store.lists(m_slot, false))) {
+      count = (unsigned int)lists->members.size();
+   }
+   pthread_mutex_unlock(&m_mgr->m_lock);
+   return count;
 }
 
 std::string 
 NxIntfImpl::getMembers(bool fromFirst)
 {
-   return "";
+   NxIntfLists *lists;
+   std::string  member;
+
+   if (!m_mgr) return member;
+   if (fromFirst) m_memberCursor = 0;
+
+   pthread_mutex_lock(&m_mgr->m_lock);
+   lists = present() ? m_mgr->m_store.lists(m_slot, false) : NULL;
+   if (lists && (m_memberCursor < lists->members.size())) {
+      member = m_mgr->m_store.str(lists->members[m_memberCursor++]);
+   }
+   pthread_mutex_unlock(&m_mgr->m_lock);
+   return member;
 }
 
 nxos::event_type_e 
 NxIntfImpl::getEvent()
 {
-   return (nxos::event_type_e)0;
+   return (nxos::event_type_e)getField(&NxIntfRec::event);
 }
 
 std::string 
@@ -134,67 +274,137 @@ NxIntfImpl::getLastMod()
 bool 
 NxIntfImpl::setLayer(const std::string& layer)
 {
-   return false;
+   return setStr(&NxIntfRec::layer, layer);
 }
 
 bool 
 NxIntfImpl::setVrf(const std::string& vrf)
 {
-   return false;
+   return setStr(&NxIntfRec::vrf, vrf);
 }
 
 bool 
 NxIntfImpl::setVlan(unsigned int vlan_id)
 {
-   return false;
+   NxVlanSet vlans;
+   bool      found;
+
+   if (!m_mgr || (vlan_id > 4094)) return false;
+   if (vlan_id) vlans.set(vlan_id);
+
+   pthread_mutex_lock(&m_mgr->m_lock);
+   if ((found = present())) m_mgr->setIntfVlans(m_slot, vlans);
+   pthread_mutex_unlock(&m_mgr->m_lock);
+   return found;
 }
 
 bool 
 NxIntfImpl::setDescription(const std::string& desc)
 {
-   return false;
+   return setStr(&NxIntfRec::desc, desc);
 }
 
 bool 
 NxIntfImpl::setL3Address(const std::string& addr, af_e type, bool primary)
 {
-   return false;
+   NxIntfStore *store;
+   NxIntfLists *lists;
+   uint32_t     id;
+   bool         found;
+
+   if (!m_mgr || (type >= MAX_AF) || addr.empty()) return false;
+
+   store = &m_mgr->m_store;
+   pthread_mutex_lock(&m_mgr->m_lock);
+   if ((found = present()) && primary) {
+      store->strs().assign(&store->rec(m_slot).prAddr[type], addr);
+   } else if (found) {
+      lists = store->lists(m_slot, true);
+      id    = store->strs().find(addr);
+      if (!id || (std::find(lists->scAddrs[type].begin(),
+                            lists->scAddrs[type].end(), id) ==
+                  lists->scAddrs[type].end())) {
+         lists->scAddrs[type].push_back(store->strs().intern(addr));
+      }
+   }
+   pthread_mutex_unlock(&m_mgr->m_lock);
+   return found;
 }
 
 bool 
 NxIntfImpl::setL2Address(const std::string& mac)
 {
-   return false;
+   return setStr(&NxIntfRec::l2Addr, mac);
 }
 
 bool 
 NxIntfImpl::setAdminState(nxos::state_type_e state)
 {
-   return false;
+   if (state >= S_MAX_TYPE) return false;
+   return setField(&NxIntfRec::adminState, (int8_t)state);
 }
 
 bool 
 NxIntfImpl::setMtu(uint32_t mtu)
 {
-   return false;
+   return setField(&NxIntfRec::mtu, mtu);
 }
 
 bool 
 NxIntfImpl::setSpeed(uint32_t speed)
 {
-   return false;
+   return setField(&NxIntfRec::speed, speed);
 }
 
 bool 
 NxIntfImpl::addMember(const std::string& intf_name)
 {
-   return false;
+   NxIntfStore *store;
+   NxIntfLists *lists;
+   uint32_t     id;
+   bool         added = false;
+
+   if (!m_mgr || intf_name.empty()) return false;
+
+   store = &m_mgr->m_store;
+   pthread_mutex_lock(&m_mgr->m_lock);
+   if (present()) {
+      lists = store->lists(m_slot, true);
+      id    = store->strs().find(intf_name);
+      if (!id || (std::find(lists->members.begin(), lists->members.end(),
+                            id) == lists->members.end())) {
+         lists->members.push_back(store->strs().intern(intf_name));
+         added = true;
+      }
+   }
+   pthread_mutex_unlock(&m_mgr->m_lock);
+   return added;
 }
 
 bool 
 NxIntfImpl::delMember(const std::string& intf_name)
 {
-   return false;
+   NxIntfStore                     *store;
+   NxIntfLists                     *lists;
+   std::vector<uint32_t>::iterator  it;
+   uint32_t                         id;
+   bool                             deleted = false;
+
+   if (!m_mgr) return false;
+
+   store = &m_mgr->m_store;
+   pthread_mutex_lock(&m_mgr->m_lock);
+   lists = present() ? store->lists(m_slot, false) : NULL;
+   if (lists && (id = store->strs().find(intf_name))) {
+      it = std::find(lists->members.begin(), lists->members.end(), id);
+      if (it != lists->members.end()) {
+         lists->members.erase(it);
+         store->strs().release(id);
+         deleted = true;
+      }
+   }
+   pthread_mutex_unlock(&m_mgr->m_lock);
+   return deleted;
 }
 
 bool 
@@ -214,28 +424,168 @@ NxIntfImpl::equal(NxIntf const& intf_obj) const
 {
    return false;
 }
+
+unsigned int 
+NxIntfImpl::getL3ScAddrs(af_e af, std::vector<std::string>* addrs)
+{
+   NxIntfLists  *lists;
+   unsigned int  count = 0;
+
+   if (addrs) addrs->clear();
+   if (!m_mgr || (af >= MAX_AF)) return 0;
+
+   pthread_mutex_lock(&m_mgr->m_lock);
+   if (present() && (lists = m_mgr->m_store.lists(m_slot, false))) {
+      count = (unsigned int)lists->scAddrs[af].size();
+      for (unsigned int i = 0; addrs && (i < count); i++) {
+         addrs->push_back(m_mgr->m_store.str(lists->scAddrs[af][i]));
+      }
+   }
+   pthread_mutex_unlock(&m_mgr->m_lock);
+   return count;
+}
+
+unsigned int 
+NxIntfImpl::getMemberNames(std::vector<std::string>* members)
+{
+   NxIntfLists  *lists;
+   unsigned int  count = 0;
+
+   if (members) members->clear();
+   if (!m_mgr) return 0;
+
+   pthread_mutex_lock(&m_mgr->m_lock);
+   if (present() && (lists = m_mgr->m_store.lists(m_slot, false))) {
+      count = (unsigned int)lists->members.size();
+      for (unsigned int i = 0; members && (i < count); i++) {
+         members->push_back(m_mgr->m_store.str(lists->members[i]));
+      }
+   }
+   pthread_mutex_unlock(&m_mgr->m_lock);
+   return count;
+}
+
+bool 
+NxIntfImpl::snapshot(NxIntfSnapshot* snap)
+{
+   bool found;
+
+   if (!m_mgr || !snap) return false;
+
+   pthread_mutex_lock(&m_mgr->m_lock);
+   if ((found = present())) {
+      m_mgr->fillSnapshot(m_slot, snap);
+   }
+   pthread_mutex_unlock(&m_mgr->m_lock);
+   return found;
+}
+
+uint32_t 
+NxIntfImpl::getIfindex()
+{
+   // 0 once the interface is removed.
+   return getField(&NxIntfRec::ifindex);
+}
+
+bool 
+NxIntfImpl::getVlanSet(NxVlanSet* vlans)
+{
+   bool found;
+
+   if (!m_mgr || !vlans) return false;
+
+   pthread_mutex_lock(&m_mgr->m_lock);
+   if ((found = present())) {
+      m_mgr->m_store.vlans(m_slot, vlans);
+   }
+   pthread_mutex_unlock(&m_mgr->m_lock);
+   return found;
+}
+
+unsigned int 
+NxIntfImpl::getMemberSet(NxIntfBitmap* members)
+{
+   NxIntfLists  *lists;
+   unsigned int  count = 0;
+
+   if (members) members->clear();
+   if (!m_mgr) return 0;
+
+   pthread_mutex_lock(&m_mgr->m_lock);
+   if (present() && (lists = m_mgr->m_store.lists(m_slot, false))) {
+      count = (unsigned int)lists->members.size();
+      for (unsigned int i = 0; members && (i < count); i++) {
+         members->set(NxIntfDict::get().ifindex(
+                         m_mgr->m_store.strs().c_str(lists->members[i])));
+      }
+   }
+   pthread_mutex_unlock(&m_mgr->m_lock);
+   return count;
+}
     
 // Implementation for class  
 NxIntfMgrImpl::NxIntfMgrImpl()
+   : m_intfCursor(0), m_handler(NULL), m_ctrRing(NULL), m_ctrIntervalMs(0),
+     m_ctrThreshold(), m_conflateMs(0), m_eventStats()
 {
+   // Dampening is off until the App sets a policy.
+   m_dampDefault.penalty = 0;
+   pthread_mutex_init(&m_lock, NULL);
 
 }
 
 NxIntfMgrImpl::~NxIntfMgrImpl()
 {
+   delete m_ctrRing;
+   for (size_t i = 0; i < m_ctrRetired.size(); i++) delete m_ctrRetired[i];
+   pthread_mutex_destroy(&m_lock);
+
+}
+
+/*
+ * Handle of the interface in slot. Handles are kept by ifindex, not by
+ * slot, & stay at the same address: the handle of a removed interface
+ * returns empty values until the same name is added again, it never
+ * follows another interface into the slot.
+ */
+NxIntfImpl* 
+NxIntfMgrImpl::getHandle(uint32_t slot)
+{
+   uint32_t ifindex = m_store.rec(slot).ifindex;
 
+   if (m_handles.size() <= ifindex) m_handles.resize(ifindex + 1);
+   if (!m_handles[ifindex].m_mgr) m_handles[ifindex] = NxIntfImpl(this, slot);
+   m_handles[ifindex].m_slot = slot;
+   return &m_handles[ifindex];
 }
 
 NxIntf* 
 NxIntfMgrImpl::iterateIntf(bool fromFirst)
 {
-   return NULL;
+   NxIntf *intf = NULL;
+
+   pthread_mutex_lock(&m_lock);
+   if (fromFirst) m_intfCursor = 0;
+   while ((m_intfCursor < m_store.size()) && !m_store.used(m_intfCursor)) {
+      m_intfCursor++;
+   }
+   if (m_intfCursor < m_store.size()) intf = getHandle(m_intfCursor++);
+   pthread_mutex_unlock(&m_lock);
+   return intf;
 }
 
 NxIntf* 
 NxIntfMgrImpl::getIntf(std::string name)
 {
-   return NULL;
+   NxIntfImpl *intf = NULL;
+   uint32_t    slot;
+
+   pthread_mutex_lock(&m_lock);
+   if ((slot = m_store.find(name)) != NxIntfStore::NONE) {
+      intf = getHandle(slot);
+   }
+   pthread_mutex_unlock(&m_lock);
+   return intf;
 }
 
 bool 
@@ -253,13 +603,32 @@ NxIntfMgrImpl::closeIntfAll()
 NxIntf* 
 NxIntfMgrImpl::addIntf(std::string name)
 {
-   return NULL;
+   NxIntfImpl *intf = NULL;
+   uint32_t    slot;
+   bool        added;
+
+   pthread_mutex_lock(&m_lock);
+   added = (m_store.find(name) == NxIntfStore::NONE);
+   if ((slot = m_store.add(name)) != NxIntfStore::NONE) {
+      intf = getHandle(slot);
+      if (added) *intf = NxIntfImpl(this, slot);
+   }
+   pthread_mutex_unlock(&m_lock);
+   return intf;
 }
 
 bool 
 NxIntfMgrImpl::removeIntf(std::string name, bool del_sdk)
 {
-   return false;
+   uint32_t slot;
+
+   pthread_mutex_lock(&m_lock);
+   if ((slot = m_store.find(name)) != NxIntfStore::NONE) {
+      setIntfVlans(slot, NxVlanSet());
+      m_store.remove(slot);
+   }
+   pthread_mutex_unlock(&m_lock);
+   return (slot != NxIntfStore::NONE);
 }
 
 bool 
@@ -277,11 +646,335 @@ NxIntfMgrImpl::unWatchIntf(std::string name)
 void 
 NxIntfMgrImpl::setIntfHandler(NxIntfMgrHandler* handler)
 {
-   return;
+   setIntfHandler(handler, NxIntfMgrHandler::EVENT_ALL);
 }
 
 NxIntfMgrHandler* 
 NxIntfMgrImpl::getIntfHandler()
 {
-   return NULL;
+   return m_handler;
+}
+
+unsigned int 
+NxIntfMgrImpl::getIntfs(NxIntf** intfs, unsigned int maxCount)
+{
+   unsigned int count;
+   unsigned int n = 0;
+
+   pthread_mutex_lock(&m_lock);
+   count = m_store.count();
+   for (uint32_t slot = 0; (slot < m_store.size()) && (n < maxCount); slot++) {
+      if (m_store.used(slot)) intfs[n++] = getHandle(slot);
+   }
+   pthread_mutex_unlock(&m_lock);
+   return count;
+}
+
+/* Copy the pooled string id to buf of size len, truncated if longer. */
+static inline void
+nxIntfCopyStr(char *buf, size_t len, const NxStrPool &strs, uint32_t id)
+{
+   strncpy(buf, strs.c_str(id), len - 1);
+   buf[len - 1] = '\0';
+}
+
+void
+NxIntfMgrImpl::fillSnapshot(uint32_t slot, NxIntfSnapshot* snap)
+{
+   const NxIntfRec   &rec   = m_store.rec(slot);
+   const NxStrPool   &strs  = m_store.strs();
+   NxIntfLists       *lists = m_store.lists(slot, false);
+
+   memset(snap, 0, sizeof(*snap));
+   nxIntfCopyStr(snap->name, sizeof(snap->name), strs, rec.name);
+   nxIntfCopyStr(snap->layer, sizeof(snap->layer), strs, rec.layer);
+   nxIntfCopyStr(snap->vrf, sizeof(snap->vrf), strs, rec.vrf);
+   nxIntfCopyStr(snap->description, sizeof(snap->description), strs,
+                 rec.desc);
+   nxIntfCopyStr(snap->l2Address, sizeof(snap->l2Address), strs, rec.l2Addr);
+   nxIntfCopyStr(snap->l2AddressHW, sizeof(snap->l2AddressHW), strs,
+                 rec.l2AddrHw);
+   for (int af = AF_START; af < MAX_AF; af++) {
+      nxIntfCopyStr(snap->l3PrAddr[af], sizeof(snap->l3PrAddr[af]), strs,
+                    rec.prAddr[af]);
+      if (lists) snap->l3ScAddrCount[af] = lists->scAddrs[af].size();
+   }
+   snap->ifindex     = rec.ifindex;
+   snap->type        = (intf_type_e)rec.type;
+   snap->vlan        = rec.vlan;
+   snap->adminState  = (state_type_e)rec.adminState;
+   snap->operState   = (state_type_e)rec.operState;
+   snap->mtu         = rec.mtu;
+   snap->speed       = rec.speed;
+   snap->memberCount = lists ? lists->members.size() : 0;
+   snap->event       = (event_type_e)rec.event;
+}
+
+unsigned int 
+NxIntfMgrImpl::getIntfSnapshots(std::vector<NxIntfSnapshot>* snaps, const NxIntfFilter& filter)
+{
+   uint32_t vrf = 0, layer = 0;
+   bool     none = false;
+
+   if (!snaps) return 0;
+
+   snaps->clear();
+   pthread_mutex_lock(&m_lock);
+
+   // Match the strings by pool id, a string not in the pool matches none.
+   if (!filter.vrf.empty()) none |= !(vrf = m_store.strs().find(filter.vrf));
+   if (!filter.layer.empty()) {
+      none |= !(layer = m_store.strs().find(filter.layer));
+   }
+   if (!none) snaps->reserve(m_store.count());
+   for (uint32_t slot = 0; !none && (slot < m_store.size()); slot++) {
+      if (!m_store.used(slot)) continue;
+
+      const NxIntfRec &rec = m_store.rec(slot);
+
+      if ((filter.type != NX_TYPE_UNKNOWN) && (rec.type != filter.type)) continue;
+      if (vrf && (rec.vrf != vrf)) continue;
+      if (layer && (rec.layer != layer)) continue;
+      if ((filter.operState != UNKNOWN) && (rec.operState != filter.operState)) {
+         continue;
+      }
+      snaps->resize(snaps->size() + 1);
+      fillSnapshot(slot, &snaps->back());
+   }
+   pthread_mutex_unlock(&m_lock);
+   return (unsigned int)snaps->size();
+}
+
+/* True if change is one the NxIntf setter of its attribute accepts. */
+static bool
+nxIntfChangeValid(const NxIntfConfigTxn::Change& change)
+{
+   switch (change.attr) {
+   case NxIntfConfigTxn::LAYER:
+      return change.str.size() < NX_INTF_ATTR_STR_LEN;
+   case NxIntfConfigTxn::VRF:
+      return change.str.size() < NX_VRF_NAME_STR_LEN;
+   case NxIntfConfigTxn::DESCRIPTION:
+      return change.str.size() < NX_INTF_DESC_STR_LEN;
+   case NxIntfConfigTxn::ADMIN_STATE:
+      return change.value < S_MAX_TYPE;
+   case NxIntfConfigTxn::VLAN:
+      return change.value <= 4094;
+   case NxIntfConfigTxn::MTU:
+   case NxIntfConfigTxn::SPEED:
+      return true;
+   }
+   return false;
+}
+
+void
+NxIntfMgrImpl::applyIntfChange(uint32_t slot, const NxIntfConfigTxn::Change& change)
+{
+   NxIntfRec &rec  = m_store.rec(slot);
+   NxStrPool &strs = m_store.strs();
+
+   switch (change.attr) {
+   case NxIntfConfigTxn::LAYER:
+      strs.assign(&rec.layer, change.str);
+      break;
+   case NxIntfConfigTxn::VRF:
+      strs.assign(&rec.vrf, change.str);
+      break;
+   case NxIntfConfigTxn::DESCRIPTION:
+      strs.assign(&rec.desc, change.str);
+      break;
+   case NxIntfConfigTxn::ADMIN_STATE:
+      rec.adminState = (int8_t)change.value;
+      break;
+   case NxIntfConfigTxn::MTU:
+      rec.mtu = change.value;
+      break;
+   case NxIntfConfigTxn::SPEED:
+      rec.speed = change.value;
+      break;
+   case NxIntfConfigTxn::VLAN: {
+      NxVlanSet vlans;
+
+      if (change.value) vlans.set(change.value);
+      setIntfVlans(slot, vlans);
+      break;
+   }
+   }
+}
+
+/*
+ * Validate all the changes first so an interface with an invalid change
+ * is left as it was, then apply the others in one go.
+ */
+bool 
+NxIntfMgrImpl::commitIntfConfig(const nxos::NxIntfConfigTxn& txn, std::vector<nxos::NxIntfConfigResult>* results)
+{
+   const std::vector<NxIntfConfigTxn::Change> &changes = txn.changes;
+   std::vector<NxIntfConfigResult>  myResults;
+   std::vector<NxIntfConfigResult> *res = results ? results : &myResults;
+   std::map<std::string, size_t>    byName;
+   std::vector<size_t>              resOf(changes.size());
+   std::vector<uint32_t>            slots;
+   size_t                           r, applied = 0;
+
+   res->clear();
+   pthread_mutex_lock(&m_lock);
+   for (size_t i = 0; i < changes.size(); i++) {
+      std::map<std::string, size_t>::iterator it =
+         byName.insert(std::make_pair(changes[i].intfName, res->size())).first;
+
+      if ((r = it->second) == res->size()) {
+         res->push_back(NxIntfConfigResult());
+         res->back().intfName = changes[i].intfName;
+         res->back().index    = 0;
+         res->back().errCode  = ERR_ESUCCESS;
+         slots.push_back(m_store.find(changes[i].intfName));
+         if (slots.back() == NxIntfStore::NONE) {
+            res->back().index   = i;
+            res->back().errCode = ERR_NOT_FOUND;
+         }
+      }
+      resOf[i] = r;
+      if (((*res)[r].errCode == ERR_ESUCCESS) && !nxIntfChangeValid(changes[i])) {
+         (*res)[r].index   = i;
+         (*res)[r].errCode = ERR_INVALID;
+      }
+   }
+
+   for (size_t i = 0; i < changes.size(); i++) {
+      if ((*res)[resOf[i]].errCode == ERR_ESUCCESS) {
+         applyIntfChange(slots[resOf[i]], changes[i]);
+      }
+   }
+   pthread_mutex_unlock(&m_lock);
+
+   for (r = 0; r < res->size(); r++) applied += ((*res)[r].errCode == ERR_ESUCCESS);
+   return (applied > 0);
+}
+
+NxIntf* 
+NxIntfMgrImpl::getIntf(uint32_t ifindex)
+{
+   NxIntfImpl *intf = NULL;
+   uint32_t    slot;
+
+   pthread_mutex_lock(&m_lock);
+   if ((slot = m_store.findIfindex(ifindex)) != NxIntfStore::NONE) {
+      intf = getHandle(slot);
+   }
+   pthread_mutex_unlock(&m_lock);
+   return intf;
+}
+
+uint32_t 
+NxIntfMgrImpl::getIfindex(const std::string& name)
+{
+   return NxIntfDict::get().ifindex(name, false);
+}
+
+std::string 
+NxIntfMgrImpl::getIntfName(uint32_t ifindex)
+{
+   return NxIntfDict::get().name(ifindex);
+}
+
+unsigned int 
+NxIntfMgrImpl::getVlanIntfs(unsigned int vlan, NxIntfBitmap* intfs)
+{
+   unsigned int count = 0;
+
+   if (!intfs) return 0;
+
+   intfs->clear();
+   pthread_mutex_lock(&m_lock);
+   if (vlan < m_vlanIntfs.size()) {
+      *intfs = m_vlanIntfs[vlan];
+      count  = intfs->count();
+   }
+   pthread_mutex_unlock(&m_lock);
+   return count;
+}
+
+/*
+ * Only the VLANs that changed touch the index, a trunk allowed one more
+ * VLAN sets one bit.
+ */
+void
+NxIntfMgrImpl::setIntfVlans(uint32_t slot, const NxVlanSet& set)
+{
+   const uint32_t ifindex = m_store.rec(slot).ifindex;
+   NxVlanSet      old, vlans(set);
+   uint64_t       diff;
+   unsigned int   vlan;
+
+   // Only VLANs 1-4094 are valid on an interface.
+   vlans.reset(0);
+   vlans.reset(NX_VLAN_COUNT - 1);
+   m_store.vlans(slot, &old);
+   for (unsigned int w = 0; w < NX_VLAN_COUNT / 64; w++) {
+      for (diff = old.words[w] ^ vlans.words[w]; diff; diff &= diff - 1) {
+         vlan = (w * 64) + __builtin_ctzll(diff);
+         if (m_vlanIntfs.empty()) m_vlanIntfs.resize(NX_VLAN_COUNT);
+         if (vlans.test(vlan)) {
+            m_vlanIntfs[vlan].set(ifindex);
+         } else {
+            m_vlanIntfs[vlan].reset(ifindex);
+         }
+      }
+   }
+   m_store.setVlans(slot, vlans);
+}
+
+void
+NxIntfMgrImpl::postIntfVlanMsg(uint32_t ifindex, const NxVlanSet& vlans)
+{
+   NxIntf  *intf = NULL;
+   uint32_t slot;
+
+   pthread_mutex_lock(&m_lock);
+   if ((slot = m_store.findIfindex(ifindex)) != NxIntfStore::NONE) {
+      setIntfVlans(slot, vlans);
+      m_store.rec(slot).event = UPDATE;
+      if (m_handler && m_handlerFilter.wants(NxIntfMgrHandler::EVENT_VLAN)) {
+         intf = getHandle(slot);
+      }
+   }
+   pthread_mutex_unlock(&m_lock);
+
+   if (intf) {
+      try {
+         m_handler->postIntfVlanCb(intf);
+      } catch (...) {
+      }
+   }
+}
+
+void 
+NxIntfMgrImpl::setIntfHandler(NxIntfMgrHandler* handler, uint32_t eventMask)
+{
+   pthread_mutex_lock(&m_lock);
+   m_handler = handler;
+   m_handlerFilter.setMask(eventMask);
+   pthread_mutex_unlock(&m_lock);
+}
+
+uint64_t 
+NxIntfMgrImpl::getSkippedEventCount(uint32_t events)
+{
+   return m_handlerFilter.skipped(events);
+}
+
+size_t
+NxIntfMgrImpl::memUsage()
+{
+   size_t bytes;
+
+   pthread_mutex_lock(&m_lock);
+   bytes = m_store.memUsage() + (m_handles.size() * sizeof(NxIntfImpl)) +
+           (m_vlanIntfs.capacity() * sizeof(NxIntfBitmap));
+   for (size_t i = 0; i < m_vlanIntfs.size(); i++) {
+      bytes += m_vlanIntfs[i].words.capacity() * sizeof(uint64_t);
+   }
+   pthread_mutex_unlock(&m_lock);
+   return bytes;
 }
\ No newline at end of file
@@ -9,13 +9,38 @@
 #ifndef __nx_intf_mgr_impl_H__
 #define __nx_intf_mgr_impl_H__
 
+#include <pthread.h>
+#include <deque>
+#include <map>
+#include <vector>
 #include "nx_intf_mgr.h" 
+#include "nx_intf_store.h"
+#include "nx_intf_counters.h"
+#include "nx_event_filter.h"
    
 using namespace nxos;
 
    
 namespace nxos {
 
+/* Monotonic time in milliseconds. */
+uint64_t nxIntfNowMs();
+
+class NxIntfMgrImpl;
+
+/*
+ * Oper state event delivery of an interface that had any, refer to
+ * setIntfStateDampening() & setIntfStateConflation().
+ */
+struct NxIntfEventState {
+    NxIntfEventStats  stats;
+    uint64_t          penaltyMs;    // time stats.penalty was decayed to
+    uint64_t          windowEndMs;  // conflation window, 0 if none
+    int8_t            delivered;    // oper state last delivered
+    bool              suppressed;
+    bool              pending;      // a change waits for the window end
+};
+
 class NxIntfImpl : public NxIntf {
 public:
     NxIntfImpl();
@@ -52,6 +77,32 @@ public:
     bool operator==(NxIntf const &intf_obj) const;
     bool operator!=(NxIntf const &intf_obj) const;
     bool equal(NxIntf const &intf_obj) const;
+    unsigned int getL3ScAddrs(af_e af,std::vector<std::string> *addrs);
+    unsigned int getMemberNames(std::vector<std::string> *members);
+    bool snapshot(NxIntfSnapshot *snap);
+    uint32_t getIfindex();
+    bool getVlanSet(NxVlanSet *vlans);
+    unsigned int getMemberSet(NxIntfBitmap *members);
+
+private:
+    friend class NxIntfMgrImpl;
+
+    /* Handle onto the record of slot in the store of mgr. */
+    NxIntfImpl(NxIntfMgrImpl *mgr, uint32_t slot);
+
+    /* Whether its interface is in the store, m_lock held. */
+    bool present();
+
+    std::string getStr(uint32_t NxIntfRec::*field);
+    bool setStr(uint32_t NxIntfRec::*field, const std::string &str);
+    template <typename T> T getField(T NxIntfRec::*field);
+    template <typename T> bool setField(T NxIntfRec::*field, T value);
+
+    NxIntfMgrImpl           *m_mgr;   // NULL if not from a manager
+    uint32_t                 m_slot;
+    uint32_t                 m_ifindex;   // interface of the handle
+    uint32_t                 m_scCursor[MAX_AF];  // getL3ScAddr()
+    uint32_t                 m_memberCursor;      // getMembers()
 };
 
 class NxIntfMgrImpl : public NxIntfMgr {
@@ -68,6 +119,96 @@ public:
     bool unWatchIntf(std::string name);
     void setIntfHandler(NxIntfMgrHandler *handler);
     NxIntfMgrHandler* getIntfHandler();
+    unsigned int getIntfs(NxIntf **intfs,unsigned int maxCount);
+    unsigned int getIntfSnapshots(std::vector<NxIntfSnapshot> *snaps,const NxIntfFilter &filter = NxIntfFilter());
+    bool watchIntfCounters(const std::vector<std::string> &names,unsigned int intervalMs = 30000,unsigned int history = 64);
+    bool setIntfCounterThreshold(const nxos::NxIntfCounterThreshold &threshold);
+    bool getIntfRates(const std::string &name,nxos::NxIntfRates *rates);
+    unsigned int getIntfCounters(const std::string &name,std::vector<nxos::NxIntfCounters> *samples);
+    bool commitIntfConfig(const nxos::NxIntfConfigTxn &txn,std::vector<nxos::NxIntfConfigResult> *results = NULL);
+    bool setIntfStateDampening(const nxos::NxIntfDampening &policy,const std::string &name = "");
+    bool setIntfStateConflation(unsigned int windowMs);
+    bool getIntfEventStats(nxos::NxIntfEventStats *stats,const std::string &name = "");
+    NxIntf* getIntf(uint32_t ifindex);
+    uint32_t getIfindex(const std::string &name);
+    std::string getIntfName(uint32_t ifindex);
+    unsigned int getVlanIntfs(unsigned int vlan,NxIntfBitmap *intfs);
+    void setIntfHandler(NxIntfMgrHandler *handler,uint32_t eventMask);
+    uint64_t getSkippedEventCount(uint32_t events = 0xffffffff);
+
+    /* Called from the event loop as the VLANs of an interface change. */
+    void postIntfVlanMsg(uint32_t ifindex, const NxVlanSet &vlans);
+
+    /* Called from the event loop as the counters of an interface are read. */
+    void postIntfCountersMsg(uint32_t ifindex, const NxIntfCounters &counters);
+    /*
+     * Called from the event loop every watchIntfCounters() interval, 0 if
+     * none. nowMs is the monotonic time of the sample, 0 for now.
+     */
+    void sampleIntfCounters(uint64_t nowMs = 0);
+    unsigned int getIntfCounterIntervalMs();
+
+    /*
+     * Called from the event loop as the oper state of an interface
+     * changes, delivers it through dampening & conflation.
+     */
+    void postIntfStateMsg(uint32_t ifindex, state_type_e operState, uint64_t nowMs = 0);
+    /*
+     * Called from the event loop to deliver the conflated changes due &
+     * the state of the interfaces reused after dampening.
+     */
+    void pollIntfEvents(uint64_t nowMs = 0);
+
+    /* Memory used by the interface table & the handles. */
+    size_t memUsage();
+
+private:
+    friend class NxIntfImpl;
+
+    NxIntfImpl *getHandle(uint32_t slot);
+    /* Copy the record of slot, m_lock held. */
+    void fillSnapshot(uint32_t slot, NxIntfSnapshot *snap);
+    /* Apply change to the record of slot, m_lock held. */
+    void applyIntfChange(uint32_t slot, const NxIntfConfigTxn::Change &change);
+    /* Set the VLANs of slot & update m_vlanIntfs, VLANs 0 & 4095 are
+     * dropped. m_lock held. */
+    void setIntfVlans(uint32_t slot, const NxVlanSet &vlans);
+    /* Dampening policy of ifindex, m_lock held. */
+    const NxIntfDampening &dampeningOf(uint32_t ifindex);
+    /* Deliver the state of slot, m_lock held. Adds it to out. */
+    void deliverIntfState(uint32_t slot, NxIntfEventState *st, uint64_t nowMs, std::vector<NxIntf *> *out);
+    void notifyIntfState(const std::vector<NxIntf *> &intfs);
+    /* Ring & port of a sampled interface, m_lock held. The ring is held
+     * for the caller to release once read. */
+    NxIntfCounterRing *getIntfCounterPort(const std::string &name, uint32_t *port);
+    /* Free the replaced rings no reader holds, m_lock held. */
+    void freeIntfCounterRings();
+
+    pthread_mutex_t           m_lock;        // guards m_store & m_handles
+    NxIntfStore               m_store;       // open interfaces
+    std::deque<NxIntfImpl>    m_handles;     // by ifindex
+    uint32_t                  m_intfCursor;  // iterateIntf()
+    NxIntfMgrHandler         *m_handler;
+    NxEventFilter             m_handlerFilter;  // events of m_handler
+    std::vector<NxIntfBitmap> m_vlanIntfs;   // by VLAN, ifindexes on it
+
+    // watchIntfCounters(), by port of m_ctrRing
+    NxIntfCounterRing        *m_ctrRing;     // NULL if not sampling
+    std::vector<NxIntfCounterRing *> m_ctrRetired;  // replaced, still held
+    unsigned int              m_ctrIntervalMs;
+    NxIntfCounterThreshold    m_ctrThreshold;
+    std::vector<uint32_t>     m_ctrIfindexes;
+    std::vector<uint8_t>      m_ctrExceeded;
+    std::vector<double>       m_ctrRates;    // sampleIntfCounters()
+    std::vector<double>       m_ctrRxUtil;
+    std::vector<double>       m_ctrTxUtil;
+
+    // Oper state event delivery, by ifindex
+    std::map<uint32_t, NxIntfEventState> m_events;
+    std::map<uint32_t, NxIntfDampening>  m_dampPolicies;
+    NxIntfDampening           m_dampDefault;
+    unsigned int              m_conflateMs;
+    NxIntfEventStats          m_eventStats;
 };
 }
 #endif // __nx_intf_mgr_impl_H__ 
\ No newline at end of file
@@ -0,0 +1,279 @@
+/** **********************************************************************
+    * Value types of the NxIntfMgr APIs.
+    *
+    * Copyright (c) 2017 by cisco Systems, Inc.
+    *
+    * All rights reserved.
+************************************************************************/
+#include <algorithm>
+#include <cstring>
+#include "types/nx_intf_mgr.h"
+
+using namespace nxos;
+
+NxIntfFilter::NxIntfFilter()
+   : type(NX_TYPE_UNKNOWN), operState(UNKNOWN)
+{
+
+}
+
+NxIntfDampening::NxIntfDampening()
+   : penalty(1000), suppress(2000), reuse(1000), halfLifeMs(5000),
+     maxSuppressMs(20000)
+{
+
+}
+
+static void
+nxIntfCfgAdd(NxIntfConfigTxn* txn, const std::string& intfName,
+             NxIntfConfigTxn::attr_e attr, const std::string& str,
+             uint32_t value)
+{
+   txn->changes.push_back(NxIntfConfigTxn::Change());
+
+   NxIntfConfigTxn::Change &change = txn->changes.back();
+
+   change.intfName = intfName;
+   change.attr     = attr;
+   change.str      = str;
+   change.value    = value;
+}
+
+void
+NxIntfConfigTxn::setLayer(const std::string& intfName, const std::string& layer)
+{
+   nxIntfCfgAdd(this, intfName, LAYER, layer, 0);
+}
+
+void
+NxIntfConfigTxn::setVrf(const std::string& intfName, const std::string& vrf)
+{
+   nxIntfCfgAdd(this, intfName, VRF, vrf, 0);
+}
+
+void
+NxIntfConfigTxn::setDescription(const std::string& intfName,
+                                const std::string& desc)
+{
+   nxIntfCfgAdd(this, intfName, DESCRIPTION, desc, 0);
+}
+
+void
+NxIntfConfigTxn::setAdminState(const std::string& intfName, state_type_e state)
+{
+   nxIntfCfgAdd(this, intfName, ADMIN_STATE, "", (uint32_t)state);
+}
+
+void
+NxIntfConfigTxn::setMtu(const std::string& intfName, uint32_t mtu)
+{
+   nxIntfCfgAdd(this, intfName, MTU, "", mtu);
+}
+
+void
+NxIntfConfigTxn::setSpeed(const std::string& intfName, uint32_t speed)
+{
+   nxIntfCfgAdd(this, intfName, SPEED, "", speed);
+}
+
+void
+NxIntfConfigTxn::setVlan(const std::string& intfName, unsigned int vlanId)
+{
+   nxIntfCfgAdd(this, intfName, VLAN, "", vlanId);
+}
+
+/*
+ * Set operations of NxVlanSet & NxIntfBitmap over n words. Plain loops
+ * with no early exit so they vectorize, any() & intersects() or all the
+ * words together in place of testing each.
+ */
+static void
+nxBitsAnd(uint64_t* dst, const uint64_t* src, size_t n)
+{
+   for (size_t i = 0; i < n; i++) dst[i] &= src[i];
+}
+
+static void
+nxBitsOr(uint64_t* dst, const uint64_t* src, size_t n)
+{
+   for (size_t i = 0; i < n; i++) dst[i] |= src[i];
+}
+
+static unsigned int
+nxBitsCount(const uint64_t* bits, size_t n)
+{
+   uint64_t count = 0;
+
+   for (size_t i = 0; i < n; i++) count += __builtin_popcountll(bits[i]);
+   return (unsigned int)count;
+}
+
+static bool
+nxBitsAny(const uint64_t* bits, size_t n)
+{
+   uint64_t any = 0;
+
+   for (size_t i = 0; i < n; i++) any |= bits[i];
+   return any != 0;
+}
+
+static bool
+nxBitsIntersect(const uint64_t* bits1, const uint64_t* bits2, size_t n)
+{
+   uint64_t any = 0;
+
+   for (size_t i = 0; i < n; i++) any |= bits1[i] & bits2[i];
+   return any != 0;
+}
+
+/* Lowest bit set from bit on, n * 64 if none. */
+static size_t
+nxBitsNext(const uint64_t* bits, size_t n, size_t bit)
+{
+   size_t   i = bit / 64;
+   uint64_t word;
+
+   if (i >= n) return n * 64;
+   for (word = bits[i] & (~0ULL << (bit % 64)); !word; word = bits[i]) {
+      if (++i == n) return n * 64;
+   }
+   return (i * 64) + __builtin_ctzll(word);
+}
+
+#define NX_VLAN_WORDS (NX_VLAN_COUNT / 64)
+
+NxVlanSet::NxVlanSet()
+{
+   clear();
+}
+
+bool
+NxVlanSet::set(unsigned int vlan)
+{
+   if (vlan >= NX_VLAN_COUNT) return false;
+   words[vlan / 64] |= 1ULL << (vlan % 64);
+   return true;
+}
+
+bool
+NxVlanSet::reset(unsigned int vlan)
+{
+   if (vlan >= NX_VLAN_COUNT) return false;
+   words[vlan / 64] &= ~(1ULL << (vlan % 64));
+   return true;
+}
+
+void
+NxVlanSet::clear()
+{
+   memset(words, 0, sizeof(words));
+}
+
+int
+NxVlanSet::next(unsigned int vlan) const
+{
+   size_t bit = nxBitsNext(words, NX_VLAN_WORDS, vlan);
+
+   return (bit < NX_VLAN_COUNT) ? (int)bit : -1;
+}
+
+unsigned int
+NxVlanSet::count() const
+{
+   return nxBitsCount(words, NX_VLAN_WORDS);
+}
+
+bool
+NxVlanSet::any() const
+{
+   return nxBitsAny(words, NX_VLAN_WORDS);
+}
+
+bool
+NxVlanSet::intersects(const NxVlanSet& vlans) const
+{
+   return nxBitsIntersect(words, vlans.words, NX_VLAN_WORDS);
+}
+
+NxVlanSet&
+NxVlanSet::operator&=(const NxVlanSet& vlans)
+{
+   nxBitsAnd(words, vlans.words, NX_VLAN_WORDS);
+   return *this;
+}
+
+NxVlanSet&
+NxVlanSet::operator|=(const NxVlanSet& vlans)
+{
+   nxBitsOr(words, vlans.words, NX_VLAN_WORDS);
+   return *this;
+}
+
+bool
+NxVlanSet::operator==(const NxVlanSet& vlans) const
+{
+   return !memcmp(words, vlans.words, sizeof(words));
+}
+
+bool
+NxIntfBitmap::set(uint32_t ifindex)
+{
+   if (!ifindex) return false;
+   if ((ifindex / 64) >= words.size()) words.resize((ifindex / 64) + 1, 0);
+   words[ifindex / 64] |= 1ULL << (ifindex % 64);
+   return true;
+}
+
+bool
+NxIntfBitmap::reset(uint32_t ifindex)
+{
+   if (!ifindex) return false;
+   if ((ifindex / 64) < words.size()) {
+      words[ifindex / 64] &= ~(1ULL << (ifindex % 64));
+   }
+   return true;
+}
+
+uint32_t
+NxIntfBitmap::next(uint32_t ifindex) const
+{
+   size_t bit = nxBitsNext(words.data(), words.size(), ifindex ? ifindex : 1);
+
+   return (bit < words.size() * 64) ? (uint32_t)bit : 0;
+}
+
+unsigned int
+NxIntfBitmap::count() const
+{
+   return nxBitsCount(words.data(), words.size());
+}
+
+bool
+NxIntfBitmap::any() const
+{
+   return nxBitsAny(words.data(), words.size());
+}
+
+bool
+NxIntfBitmap::intersects(const NxIntfBitmap& intfs) const
+{
+   return nxBitsIntersect(words.data(), intfs.words.data(),
+                          std::min(words.size(), intfs.words.size()));
+}
+
+NxIntfBitmap&
+NxIntfBitmap::operator&=(const NxIntfBitmap& intfs)
+{
+   // Bits past the end of intfs are 0.
+   if (words.size() > intfs.words.size()) words.resize(intfs.words.size());
+   nxBitsAnd(words.data(), intfs.words.data(), words.size());
+   return *this;
+}
+
+NxIntfBitmap&
+NxIntfBitmap::operator|=(const NxIntfBitmap& intfs)
+{
+   if (words.size() < intfs.words.size()) words.resize(intfs.words.size(), 0);
+   nxBitsOr(words.data(), intfs.words.data(), intfs.words.size());
+   return *this;
+}
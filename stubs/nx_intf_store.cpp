@@ -0,0 +1,311 @@
+/** **********************************************************************
+    * Compact interface table used by NxIntfMgr.
+    *
+    * Copyright (c) 2017 by cisco Systems, Inc.
+    *
+    * All rights reserved.
+************************************************************************/
+#include <algorithm>
+#include <cstring>
+#include "nx_intf_store.h"
+#include "nx_intf_dict.h"
+
+using namespace std;
+
+namespace nxos {
+
+NxStrPool::NxStrPool()
+   : m_garbage(0), m_count(0)
+{
+   // Id 0 is "" at offset 0.
+   m_arena.push_back('\0');
+   m_offs.push_back(0);
+   m_refs.push_back(0);
+}
+
+uint32_t
+NxStrPool::hashKey(const char* str) const
+{
+   uint32_t hash = 2166136261U;
+
+   while (*str) hash = (hash ^ (unsigned char)*str++) * 16777619U;
+   return hash;
+}
+
+bool
+NxStrPool::match(uint32_t id, const char* str) const
+{
+   return !strcmp(c_str(id), str);
+}
+
+uint32_t
+NxStrPool::intern(const string& str)
+{
+   uint32_t id;
+
+   if (str.empty()) return 0;
+
+   if (!(id = m_index.find(*this, str.c_str()))) {
+      if (m_freeIds.empty()) {
+         id = (uint32_t)m_offs.size();
+         m_offs.push_back(0);
+         m_refs.push_back(0);
+      } else {
+         id = m_freeIds.back();
+         m_freeIds.pop_back();
+      }
+      m_offs[id] = (uint32_t)m_arena.size();
+      m_arena.insert(m_arena.end(), str.c_str(), str.c_str() + str.size() + 1);
+      m_index.insert(*this, id);
+      m_count++;
+   }
+   m_refs[id]++;
+   return id;
+}
+
+void
+NxStrPool::release(uint32_t id)
+{
+   if (!id || --m_refs[id]) return;
+
+   m_index.erase(*this, id);
+   m_garbage += strlen(c_str(id)) + 1;
+   m_offs[id] = 0;
+   m_freeIds.push_back(id);
+   m_count--;
+   if ((m_garbage > 4096) && (m_garbage * 2 > m_arena.size())) compact();
+}
+
+/* Copy the live strings to a new arena, ids keep their value. */
+void
+NxStrPool::compact()
+{
+   vector<char> arena;
+
+   arena.reserve(m_arena.size() - m_garbage);
+   arena.push_back('\0');
+   for (uint32_t id = 1; id < m_offs.size(); id++) {
+      if (!m_refs[id]) continue;
+
+      const char *str = c_str(id);
+
+      m_offs[id] = (uint32_t)arena.size();
+      arena.insert(arena.end(), str, str + strlen(str) + 1);
+   }
+   m_arena.swap(arena);
+   m_garbage = 0;
+}
+
+bool
+NxStrPool::assign(uint32_t *id, const string& str)
+{
+   uint32_t newId;
+
+   if (!strcmp(c_str(*id), str.c_str())) return false;
+
+   newId = intern(str);
+   release(*id);
+   *id = newId;
+   return true;
+}
+
+uint32_t
+NxStrPool::find(const string& str) const
+{
+   return str.empty() ? 0 : m_index.find(*this, str.c_str());
+}
+
+size_t
+NxStrPool::memUsage() const
+{
+   return m_arena.capacity() + m_index.memUsage() +
+          ((m_offs.capacity() + m_refs.capacity() + m_freeIds.capacity()) *
+           sizeof(uint32_t));
+}
+
+const uint32_t NxIntfStore::NONE;
+
+NxIntfStore::NxIntfStore()
+   : m_count(0)
+{
+
+}
+
+nxos::intf_type_e
+NxIntfStore::typeOf(const string& name)
+{
+   static const struct {
+      const char        *prefix;
+      nxos::intf_type_e  type;
+   } types[] = {
+      { "Ethernet",     NX_TYPE_ETH },
+      { "port-channel", NX_TYPE_ETH_PC },
+      { "Vlan",         NX_TYPE_SVI },
+      { "loopback",     NX_TYPE_LOOPBACK },
+      { "Tunnel",       NX_TYPE_TUNNEL },
+      { "tunnel",       NX_TYPE_TUNNEL },
+      { "mgmt",         NX_TYPE_MGMT },
+   };
+
+   for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+      if (name.compare(0, strlen(types[i].prefix), types[i].prefix)) continue;
+      if ((types[i].type == NX_TYPE_ETH) || (types[i].type == NX_TYPE_ETH_PC)) {
+         if (name.find('.') != string::npos) return NX_TYPE_SUBINTF;
+      }
+      return types[i].type;
+   }
+   return NX_TYPE_UNKNOWN;
+}
+
+uint32_t
+NxIntfStore::add(const string& name)
+{
+   uint32_t   slot;
+   NxIntfRec *rec;
+
+   if (name.empty()) return NONE;
+   if ((slot = find(name)) != NONE) return slot;
+
+   if (m_freeSlots.empty()) {
+      slot = (uint32_t)m_recs.size();
+      m_recs.push_back(NxIntfRec());
+   } else {
+      slot = m_freeSlots.back();
+      m_freeSlots.pop_back();
+   }
+
+   rec = &m_recs[slot];
+   memset(rec, 0, sizeof(*rec));
+   rec->ifindex = NxIntfDict::get().ifindex(name);
+   rec->name    = m_strs.intern(name);
+   rec->type    = typeOf(name);
+   if (m_byName.size() < m_strs.idEnd()) m_byName.resize(m_strs.idEnd(), NONE);
+   m_byName[rec->name] = slot;
+   m_byIfindex.insert(*this, slot + 1);
+   m_count++;
+   return slot;
+}
+
+void
+NxIntfStore::remove(uint32_t slot)
+{
+   NxIntfRec   *rec;
+   NxIntfLists *l;
+
+   if (!used(slot)) return;
+
+   rec = &m_recs[slot];
+   if ((l = lists(slot, false))) {
+      for (int af = AF_START; af < MAX_AF; af++) {
+         for (size_t i = 0; i < l->scAddrs[af].size(); i++) {
+            m_strs.release(l->scAddrs[af][i]);
+         }
+         l->scAddrs[af].clear();
+      }
+      for (size_t i = 0; i < l->members.size(); i++) {
+         m_strs.release(l->members[i]);
+      }
+      l->members.clear();
+      std::vector<uint64_t>().swap(l->vlans);
+      m_freeLists.push_back(rec->lists - 1);
+   }
+   for (int af = AF_START; af < MAX_AF; af++) m_strs.release(rec->prAddr[af]);
+   m_strs.release(rec->layer);
+   m_strs.release(rec->vrf);
+   m_strs.release(rec->desc);
+   m_strs.release(rec->l2Addr);
+   m_strs.release(rec->l2AddrHw);
+
+   m_byName[rec->name] = NONE;
+   m_byIfindex.erase(*this, slot + 1);
+   m_strs.release(rec->name);
+   memset(rec, 0, sizeof(*rec));
+   m_freeSlots.push_back(slot);
+   m_count--;
+}
+
+uint32_t
+NxIntfStore::find(const string& name) const
+{
+   uint32_t id = m_strs.find(name);
+
+   return (id && (id < m_byName.size())) ? m_byName[id] : NONE;
+}
+
+uint32_t
+NxIntfStore::findIfindex(uint32_t ifindex) const
+{
+   uint32_t value = ifindex ? m_byIfindex.find(*this, ifindex) : 0;
+
+   return value ? (value - 1) : NONE;
+}
+
+NxIntfLists*
+NxIntfStore::lists(uint32_t slot, bool create)
+{
+   NxIntfRec &rec = m_recs[slot];
+
+   if (!rec.lists) {
+      if (!create) return NULL;
+      if (m_freeLists.empty()) {
+         m_lists.push_back(NxIntfLists());
+         rec.lists = (uint32_t)m_lists.size();
+      } else {
+         rec.lists = m_freeLists.back() + 1;
+         m_freeLists.pop_back();
+      }
+   }
+   return &m_lists[rec.lists - 1];
+}
+
+void
+NxIntfStore::vlans(uint32_t slot, NxVlanSet* vlans) const
+{
+   const NxIntfRec &rec = m_recs[slot];
+
+   if (rec.lists && !m_lists[rec.lists - 1].vlans.empty()) {
+      memcpy(vlans->words, &m_lists[rec.lists - 1].vlans[0],
+             sizeof(vlans->words));
+   } else {
+      vlans->clear();
+      if (rec.vlan) vlans->set(rec.vlan);
+   }
+}
+
+void
+NxIntfStore::setVlans(uint32_t slot, const NxVlanSet& vlans)
+{
+   NxIntfRec   &rec   = m_recs[slot];
+   NxIntfLists *l     = lists(slot, false);
+   unsigned int count = vlans.count();
+
+   if (!vlans.test(rec.vlan)) rec.vlan = (uint16_t)max(vlans.next(0), 0);
+   if ((count > 1) || ((count == 1) && !rec.vlan)) {
+      l = lists(slot, true);
+      l->vlans.assign(vlans.words, vlans.words + (NX_VLAN_COUNT / 64));
+   } else if (l) {
+      std::vector<uint64_t>().swap(l->vlans);
+   }
+}
+
+size_t
+NxIntfStore::memUsage() const
+{
+   size_t bytes = m_strs.memUsage() +
+                  (m_recs.capacity() * sizeof(NxIntfRec)) +
+                  ((m_freeSlots.capacity() + m_freeLists.capacity() +
+                    m_byName.capacity()) * sizeof(uint32_t)) +
+                  m_byIfindex.memUsage() +
+                  (m_lists.capacity() * sizeof(NxIntfLists));
+
+   for (size_t i = 0; i < m_lists.size(); i++) {
+      bytes += m_lists[i].members.capacity() * sizeof(uint32_t);
+      bytes += m_lists[i].vlans.capacity() * sizeof(uint64_t);
+      for (int af = AF_START; af < MAX_AF; af++) {
+         bytes += m_lists[i].scAddrs[af].capacity() * sizeof(uint32_t);
+      }
+   }
+   return bytes;
+}
+
+}
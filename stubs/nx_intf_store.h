@@ -0,0 +1,166 @@
+/** **********************************************************************
+    * Compact interface table used by NxIntfMgr.
+    *
+    * The state of an interface is a fixed size record in one array, its
+    * strings (name, VRF, layer, description, addresses, member names)
+    * are interned once in a string pool & referenced by a 32 bit id so
+    * the VRF, layer & description shared by many interfaces are stored
+    * once. The pool keeps the strings NUL terminated back to back in an
+    * arena indexed by an open addressing hash, interfaces are found by
+    * name through the id of their name & by ifindex through a second
+    * hash. NxIntf objects are thin handles onto a record, so a chassis
+    * with tens of thousands of subinterfaces & SVIs costs a couple of
+    * hundred bytes per interface.
+    *
+    * Copyright (c) 2017 by cisco Systems, Inc.
+    *
+    * All rights reserved.
+************************************************************************/
+#ifndef __nx_intf_store_H__
+#define __nx_intf_store_H__
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "nx_intf_mgr.h"
+#include "nx_hash_index.h"
+
+namespace nxos {
+
+/*
+ * Reference counted interned strings, id 0 is "" & is never counted.
+ */
+class NxStrPool {
+public:
+    NxStrPool();
+
+    /* Id of str with one more reference. */
+    uint32_t intern(const std::string &str);
+    /* Drop a reference of id, freed on the last one. */
+    void release(uint32_t id);
+    /* Point id to str, returns false if it was already. */
+    bool assign(uint32_t *id, const std::string &str);
+    /* Id of str if interned, 0 otherwise. */
+    uint32_t find(const std::string &str) const;
+    /* Valid until the next intern(). */
+    const char *c_str(uint32_t id) const { return &m_arena[m_offs[id]]; }
+    std::string str(uint32_t id) const { return c_str(id); }
+    /* Ids are below idEnd(), freed ones are reused. */
+    uint32_t idEnd() const { return (uint32_t)m_offs.size(); }
+    size_t size() const { return m_count; }
+    size_t memUsage() const;
+
+    /* NxHashIndex keys */
+    uint32_t hashOf(uint32_t id) const { return hashKey(c_str(id)); }
+    uint32_t hashKey(const char *str) const;
+    bool match(uint32_t id, const char *str) const;
+
+private:
+    void compact();
+
+    std::vector<char>       m_arena;    // NUL terminated strings
+    std::vector<uint32_t>   m_offs;     // by id, offset in m_arena
+    std::vector<uint32_t>   m_refs;     // by id, 0 if free
+    std::vector<uint32_t>   m_freeIds;
+    NxHashIndex<NxStrPool>  m_index;
+    size_t                  m_garbage;  // arena bytes of freed strings
+    size_t                  m_count;
+};
+
+/*
+ * Secondary addresses, members & VLANs, only allocated for the
+ * interfaces that have any.
+ */
+struct NxIntfLists {
+    std::vector<uint32_t>   scAddrs[MAX_AF];  // pooled strings
+    std::vector<uint32_t>   members;          // pooled names
+    std::vector<uint64_t>   vlans;            // NxVlanSet words, empty if
+                                              // the VLANs are {vlan}
+};
+
+/*
+ * State of an interface, strings are NxStrPool ids.
+ */
+struct NxIntfRec {
+    uint32_t    ifindex;      // 0 if the record is free
+    uint32_t    name;
+    uint32_t    layer;
+    uint32_t    vrf;
+    uint32_t    desc;
+    uint32_t    l2Addr;
+    uint32_t    l2AddrHw;
+    uint32_t    prAddr[MAX_AF];
+    uint32_t    mtu;
+    uint32_t    speed;
+    uint32_t    lists;        // index of its NxIntfLists + 1, 0 if none
+    uint16_t    vlan;
+    uint8_t     type;         // intf_type_e
+    int8_t      adminState;   // state_type_e
+    int8_t      operState;
+    uint8_t     event;        // event_type_e
+};
+
+/*
+ * Interfaces by slot. The stub takes the ifindexes from NxIntfDict,
+ * NX-OS ones are used on the switch.
+ */
+class NxIntfStore {
+public:
+    static const uint32_t NONE = 0xffffffff;
+
+    NxIntfStore();
+
+    /* Slot of name, created if absent. NONE if name is empty. */
+    uint32_t add(const std::string &name);
+    void remove(uint32_t slot);
+    uint32_t find(const std::string &name) const;
+    uint32_t findIfindex(uint32_t ifindex) const;
+
+    /* Slots in use are below size(), free ones have a 0 ifindex. */
+    uint32_t size() const { return (uint32_t)m_recs.size(); }
+    uint32_t count() const { return m_count; }
+    bool used(uint32_t slot) const {
+        return (slot < m_recs.size()) && m_recs[slot].ifindex;
+    }
+    NxIntfRec &rec(uint32_t slot) { return m_recs[slot]; }
+    const NxIntfRec &rec(uint32_t slot) const { return m_recs[slot]; }
+
+    /* Lists of the record, created if create is set, else NULL if none. */
+    NxIntfLists *lists(uint32_t slot, bool create);
+
+    /* VLANs of the record, its vlan alone unless a set was stored. */
+    void vlans(uint32_t slot, NxVlanSet *vlans) const;
+    /* Store the VLANs of the record, its vlan is kept if in vlans else
+     * set to the lowest of them (or) 0. */
+    void setVlans(uint32_t slot, const NxVlanSet &vlans);
+
+    NxStrPool &strs() { return m_strs; }
+    std::string str(uint32_t id) const { return m_strs.str(id); }
+    size_t memUsage() const;
+
+    /* NxHashIndex keys of m_byIfindex, values are slot + 1. */
+    uint32_t hashOf(uint32_t value) const {
+        return hashKey(m_recs[value - 1].ifindex);
+    }
+    uint32_t hashKey(uint32_t ifindex) const {
+        return ifindex * 0x9e3779b1U;
+    }
+    bool match(uint32_t value, uint32_t ifindex) const {
+        return m_recs[value - 1].ifindex == ifindex;
+    }
+
+private:
+    static nxos::intf_type_e typeOf(const std::string &name);
+
+    NxStrPool                    m_strs;
+    std::vector<NxIntfRec>       m_recs;
+    std::vector<uint32_t>        m_freeSlots;
+    std::vector<NxIntfLists>     m_lists;
+    std::vector<uint32_t>        m_freeLists;
+    std::vector<uint32_t>        m_byName;     // by name id, slot or NONE
+    NxHashIndex<NxIntfStore>     m_byIfindex;
+    uint32_t                     m_count;
+};
+
+}
+#endif // __nx_intf_store_H__
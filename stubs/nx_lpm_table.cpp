@@ -0,0 +1,232 @@
+/** **********************************************************************
+    * Longest prefix match table used by the NxRibMgr route cache.
+    *
+    * Copyright (c) 2017 by cisco Systems, Inc.
+    *
+    * All rights reserved.
+************************************************************************/
+#include "nx_lpm_table.h"
+
+using namespace nxos;
+
+static const uint32_t NX_LPM_NO_NODE = ~((uint32_t)0);
+
+const unsigned int NxLpmTable::ROOT_BITS;
+const uint32_t     NxLpmTable::ROOT_SIZE;
+
+NxLpmTable::NxLpmTable(unsigned int addrBits, unsigned int stride)
+   : m_addrBits(addrBits), m_stride(stride), m_fanout(1 << stride)
+{
+   clear();
+}
+
+NxLpmTable::~NxLpmTable()
+{
+
+}
+
+void
+NxLpmTable::clear()
+{
+   Slot empty = { 0, 0 };
+
+   m_slots.assign(ROOT_SIZE, empty);
+   m_plen.assign(ROOT_SIZE, 0);
+   m_use.assign(1, 0);
+   m_freeNodes.clear();
+   m_prefixes.clear();
+}
+
+size_t
+NxLpmTable::size() const
+{
+   return m_prefixes.size();
+}
+
+size_t
+NxLpmTable::memUsage() const
+{
+   // Approximate map node overhead with 4 pointers per entry.
+   return (m_slots.capacity() * sizeof(Slot)) + m_plen.capacity() +
+          (m_use.capacity() * sizeof(uint32_t)) +
+          (m_freeNodes.capacity() * sizeof(uint32_t)) +
+          (m_prefixes.size() * (sizeof(Key) + sizeof(uint32_t) +
+                                4 * sizeof(void *)));
+}
+
+NxLpmTable::Key
+NxLpmTable::makeKey(const unsigned char *addr, unsigned int maskLen) const
+{
+   Key key;
+
+   memset(&key, 0, sizeof(key));
+   memcpy(key.addr, addr, m_addrBits / 8);
+   key.maskLen = maskLen;
+   for (unsigned int i = maskLen; i < m_addrBits; i++) {
+      key.addr[i / 8] &= ~(0x80 >> (i % 8));
+   }
+   return key;
+}
+
+uint32_t&
+NxLpmTable::nodeUse(uint32_t base)
+{
+   return m_use[base ? (1 + (base - ROOT_SIZE) / m_fanout) : 0];
+}
+
+uint32_t
+NxLpmTable::allocNode()
+{
+   uint32_t base;
+   Slot     empty = { 0, 0 };
+
+   if (!m_freeNodes.empty()) {
+      base = m_freeNodes.back();
+      m_freeNodes.pop_back();
+      return base;
+   }
+   base = m_slots.size();
+   m_slots.resize(base + m_fanout, empty);
+   m_plen.resize(base + m_fanout, 0);
+   m_use.push_back(0);
+   return base;
+}
+
+void
+NxLpmTable::freeNode(uint32_t base)
+{
+   // Only empty nodes are freed, so the slots are already zeroed.
+   m_freeNodes.push_back(base);
+}
+
+/*
+ * Walk down to the node of the level maskLen ends in and return its base.
+ * Slots holding the child pointers on the way are appended to path.
+ */
+uint32_t
+NxLpmTable::walk(const unsigned char *addr, unsigned int maskLen, bool create,
+                 std::vector<uint32_t> *path)
+{
+   uint32_t     base = 0, slot, child;
+   unsigned int bit  = ROOT_BITS;
+
+   if (maskLen <= ROOT_BITS) return 0;
+
+   slot = (addr[0] << 8) | addr[1];
+   for (;;) {
+      if (!m_slots[slot].child) {
+         if (!create) return NX_LPM_NO_NODE;
+         child = allocNode();
+         if (!m_slots[slot].value) nodeUse(base)++;
+         m_slots[slot].child = child;
+      }
+      if (path) path->push_back(slot);
+      base = m_slots[slot].child;
+      if (maskLen <= bit + m_stride) return base;
+      slot = base + index(addr, bit);
+      bit += m_stride;
+   }
+}
+
+bool
+NxLpmTable::insert(const unsigned char *addr, unsigned int maskLen,
+                   uint32_t value)
+{
+   Key          key;
+   uint32_t     base, first, count;
+   unsigned int start;
+
+   if (!value || (maskLen > m_addrBits)) return false;
+
+   key = makeKey(addr, maskLen);
+   m_prefixes[key] = value;
+
+   base = walk(key.addr, maskLen, true, NULL);
+   if (maskLen <= ROOT_BITS) {
+      count = 1 << (ROOT_BITS - maskLen);
+      first = ((key.addr[0] << 8) | key.addr[1]) & ~(count - 1);
+   } else {
+      start = ROOT_BITS + ((maskLen - ROOT_BITS - 1) / m_stride) * m_stride;
+      count = 1 << (start + m_stride - maskLen);
+      first = base + (index(key.addr, start) & ~(count - 1));
+   }
+
+   for (uint32_t i = first; i < first + count; i++) {
+      if (m_slots[i].value && (m_plen[i] > maskLen)) continue;
+      if (!m_slots[i].value && !m_slots[i].child) nodeUse(base)++;
+      m_slots[i].value = value;
+      m_plen[i] = maskLen;
+   }
+   return true;
+}
+
+bool
+NxLpmTable::remove(const unsigned char *addr, unsigned int maskLen)
+{
+   Key                               key;
+   std::map<Key, uint32_t>::iterator it;
+   std::vector<uint32_t>             path;
+   uint32_t                          base, first, count, slot;
+   uint32_t                          repl = 0;
+   unsigned int                      start = 0, replLen = 0, len;
+
+   if (maskLen > m_addrBits) return false;
+
+   key = makeKey(addr, maskLen);
+   it  = m_prefixes.find(key);
+   if (it == m_prefixes.end()) return false;
+   m_prefixes.erase(it);
+
+   if (maskLen > ROOT_BITS) {
+      start = ROOT_BITS + ((maskLen - ROOT_BITS - 1) / m_stride) * m_stride;
+   }
+
+   // Next covering prefix ending in the same level takes over the slots.
+   for (len = maskLen; len-- > (start ? start + 1 : 0); ) {
+      it = m_prefixes.find(makeKey(key.addr, len));
+      if (it != m_prefixes.end()) {
+         repl    = it->second;
+         replLen = len;
+         break;
+      }
+   }
+
+   base = walk(key.addr, maskLen, false, &path);
+   if (base == NX_LPM_NO_NODE) return true;
+   if (maskLen <= ROOT_BITS) {
+      count = 1 << (ROOT_BITS - maskLen);
+      first = ((key.addr[0] << 8) | key.addr[1]) & ~(count - 1);
+   } else {
+      count = 1 << (start + m_stride - maskLen);
+      first = base + (index(key.addr, start) & ~(count - 1));
+   }
+
+   for (uint32_t i = first; i < first + count; i++) {
+      if (!m_slots[i].value || (m_plen[i] != maskLen)) continue;
+      m_slots[i].value = repl;
+      m_plen[i] = replLen;
+      if (!repl && !m_slots[i].child) nodeUse(base)--;
+   }
+
+   // Release the nodes left empty on the way back up.
+   while (base && !nodeUse(base)) {
+      slot = path.back();
+      path.pop_back();
+      freeNode(base);
+      m_slots[slot].child = 0;
+      base = path.empty() ? 0 : m_slots[path.back()].child;
+      if (!m_slots[slot].value) nodeUse(base)--;
+   }
+   return true;
+}
+
+uint32_t
+NxLpmTable::find(const unsigned char *addr, unsigned int maskLen) const
+{
+   std::map<Key, uint32_t>::const_iterator it;
+
+   if (maskLen > m_addrBits) return 0;
+
+   it = m_prefixes.find(makeKey(addr, maskLen));
+   return (it == m_prefixes.end()) ? 0 : it->second;
+}
@@ -0,0 +1,102 @@
+/** **********************************************************************
+    * Longest prefix match table used by the NxRibMgr route cache.
+    *
+    * Multibit trie with a 16 bit direct indexed root followed by fixed
+    * stride nodes (DIR-16-8-8 for IPv4 with stride 8, 4 bit strides for
+    * IPv6 to bound the memory of sparse tables). Prefixes are expanded
+    * only inside the level they end in and a lookup keeps the deepest
+    * match on its way down, so updates never touch other levels.
+    *
+    * Copyright (c) 2017 by cisco Systems, Inc.
+    *
+    * All rights reserved.
+************************************************************************/
+#ifndef __nx_lpm_table_H__
+#define __nx_lpm_table_H__
+
+#include <stdint.h>
+#include <cstring>
+#include <map>
+#include <vector>
+
+namespace nxos {
+
+class NxLpmTable {
+public:
+    /* addrBits: 32 or 128. stride: 1, 2, 4 or 8 */
+    NxLpmTable(unsigned int addrBits, unsigned int stride);
+    ~NxLpmTable();
+
+    /* value 0 is reserved for no match */
+    bool insert(const unsigned char *addr, unsigned int maskLen, uint32_t value);
+    bool remove(const unsigned char *addr, unsigned int maskLen);
+    uint32_t find(const unsigned char *addr, unsigned int maskLen) const;
+    uint32_t lookup(const unsigned char *addr) const;
+    size_t size() const;
+    size_t memUsage() const;
+    void clear();
+
+private:
+    static const unsigned int ROOT_BITS = 16;
+    static const uint32_t     ROOT_SIZE = 1 << ROOT_BITS;
+
+    struct Slot {
+        uint32_t child;  // base index of the child node, 0 if none
+        uint32_t value;
+    };
+
+    struct Key {
+        unsigned char addr[16];
+        unsigned char maskLen;
+
+        bool operator<(const Key &key) const {
+            int cmp = memcmp(addr, key.addr, sizeof(addr));
+            return cmp ? (cmp < 0) : (maskLen < key.maskLen);
+        }
+    };
+
+    Key makeKey(const unsigned char *addr, unsigned int maskLen) const;
+    uint32_t index(const unsigned char *addr, unsigned int bit) const;
+    uint32_t allocNode();
+    void freeNode(uint32_t base);
+    uint32_t &nodeUse(uint32_t base);
+    uint32_t walk(const unsigned char *addr, unsigned int maskLen, bool create,
+                  std::vector<uint32_t> *path);
+
+    unsigned int           m_addrBits;
+    unsigned int           m_stride;
+    uint32_t               m_fanout;
+    std::vector<Slot>      m_slots;
+    std::vector<uint8_t>   m_plen;
+    std::vector<uint32_t>  m_use;
+    std::vector<uint32_t>  m_freeNodes;
+    std::map<Key, uint32_t> m_prefixes;
+};
+
+/*
+ * Longest prefix match on the trie. Kept inline as it is the hot path of
+ * the route cache lookups.
+ */
+inline uint32_t
+NxLpmTable::index(const unsigned char *addr, unsigned int bit) const
+{
+    return (addr[bit >> 3] >> (8 - (bit & 7) - m_stride)) & (m_fanout - 1);
+}
+
+inline uint32_t
+NxLpmTable::lookup(const unsigned char *addr) const
+{
+    const Slot   *slot = &m_slots[(addr[0] << 8) | addr[1]];
+    uint32_t      best = 0;
+    unsigned int  bit  = ROOT_BITS;
+
+    for (;;) {
+        if (slot->value) best = slot->value;
+        if (!slot->child || (bit >= m_addrBits)) return best;
+        slot = &m_slots[slot->child + index(addr, bit)];
+        bit += m_stride;
+    }
+}
+
+}
+#endif // __nx_lpm_table_H__
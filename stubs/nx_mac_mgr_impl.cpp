@@ -7,131 +7,396 @@
     * All rights reserved.
 ************************************************************************/
 #include "nx_mac_mgr_impl.h" 
+#include "nx_intf_dict.h"
    
+using namespace std;
 using namespace nxos;
 
    
     
 // Implementation for class  
 NxMacImpl::NxMacImpl()
+   : m_ifindex(0), m_type(TYPE_NO_TYPE), m_event(NO_EVENT), m_mgr(NULL)
 {
 
 }
 
-NxMacImpl::~NxMacImpl()
+NxMacImpl::NxMacImpl(const NxMacRec& rec, NxMacMgrImpl* mgr)
+   : m_ifindex(rec.ifindex), m_type((type_e)rec.type),
+     m_event((event_type_e)rec.event), m_mgr(mgr)
 {
+   m_key.key = rec.key;
+}
 
+NxMacImpl::~NxMacImpl()
+{
+   // Freed by the App, the manager no longer tracks it.
+   if (m_mgr) {
+      pthread_mutex_lock(&m_mgr->m_lock);
+      m_mgr->m_macObjs.erase(this);
+      pthread_mutex_unlock(&m_mgr->m_lock);
+   }
 }
 
 std::string 
 NxMacImpl::getMacAddress()
 {
-   return "";
+   return m_key.key ? m_key.toString() : "";
 }
 
 nxos::type_e 
 NxMacImpl::getType()
 {
-   return (nxos::type_e)0;
+   return m_type;
 }
 
 unsigned int 
 NxMacImpl::getVlan()
 {
-   return (unsigned int)0;
+   return m_key.vlan();
 }
 
 std::string 
 NxMacImpl::getIntfName()
 {
-   return "";
+   return NxIntfDict::get().name(m_ifindex);
 }
 
 nxos::event_type_e 
 NxMacImpl::getEvent()
 {
-   return (nxos::event_type_e)0;
+   return m_event;
 }
 
 bool 
 NxMacImpl::operator==(NxMac const& mac_obj) const
 {
-   return false;
+   return equal(mac_obj);
 }
 
 bool 
 NxMacImpl::operator!=(NxMac const& mac_obj) const
 {
-   return false;
+   return !equal(mac_obj);
 }
 
 bool 
 NxMacImpl::equal(NxMac const& mac_obj) const
 {
-   return false;
+   const NxMacImpl *mac = dynamic_cast<const NxMacImpl *>(&mac_obj);
+
+   return mac && (mac->m_key == m_key);
+}
+
+uint32_t 
+NxMacImpl::getIfindex()
+{
+   return m_ifindex;
+}
+
+nxos::NxMacKey 
+NxMacImpl::getMacKey()
+{
+   return m_key;
 }
     
 // Implementation for class  
 NxMacMgrImpl::NxMacMgrImpl()
+   : m_handler(NULL), m_watchAll(false)
 {
-
+   pthread_mutex_init(&m_lock, NULL);
 }
 
 NxMacMgrImpl::~NxMacMgrImpl()
 {
+   std::set<NxMacImpl *>::iterator it;
 
+   for (it = m_macObjs.begin(); it != m_macObjs.end(); ++it) {
+      (*it)->m_mgr = NULL;
+      delete *it;
+   }
+   pthread_mutex_destroy(&m_lock);
 }
 
 bool 
 NxMacMgrImpl::addStaticMac(const std::string& macAddr, const unsigned int vlan, const std::string& intf_name)
 {
-   return false;
+   NxMacKey key;
+
+   return key.fromString(macAddr, vlan) && !intf_name.empty() &&
+          addStaticMac(key, NxIntfDict::get().ifindex(intf_name, true));
 }
 
 bool 
 NxMacMgrImpl::delStaticMac(const std::string& macAddr, const unsigned int vlan)
 {
-   return false;
+   NxMacKey key;
+
+   return key.fromString(macAddr, vlan) && delStaticMac(key);
 }
 
 NxMac* 
 NxMacMgrImpl::getMac(const std::string& macAddr, const unsigned int vlan, bool clearBuffer)
 {
-   return NULL;
+   NxMacKey key;
+
+   return key.fromString(macAddr, vlan) ? getMac(key, clearBuffer) : NULL;
 }
 
 bool 
 NxMacMgrImpl::watchAllMac(bool download)
 {
-   return false;
+   vector<NxMacRec> recs;
+
+   pthread_mutex_lock(&m_lock);
+   m_watchAll = true;
+   for (uint32_t slot = 0; download && (slot < m_table.size()); slot++) {
+      if (m_table.used(slot)) recs.push_back(m_table.rec(slot));
+   }
+   pthread_mutex_unlock(&m_lock);
+
+   if (download) this->download(0, "", recs);
+   return true;
 }
 
 bool 
 NxMacMgrImpl::unwatchAllMac()
 {
-   return false;
+   pthread_mutex_lock(&m_lock);
+   m_watchAll = false;
+   pthread_mutex_unlock(&m_lock);
+   return true;
 }
 
 bool 
 NxMacMgrImpl::watchMac(const unsigned int vlan, const std::string& macAddr, bool download)
 {
-   return false;
+   vector<NxMacRec> recs;
+   NxMacKey         key;
+
+   if (!macAddr.empty()) {
+      return key.fromString(macAddr, vlan) && watchMac(key, download);
+   }
+   if ((vlan < 1) || (vlan > 4094)) return false;
+
+   pthread_mutex_lock(&m_lock);
+   m_watchVlans.set(vlan);
+   for (uint32_t slot = 0; download && (slot < m_table.size()); slot++) {
+      if (m_table.used(slot) && ((m_table.rec(slot).key >> 48) == vlan)) {
+         recs.push_back(m_table.rec(slot));
+      }
+   }
+   pthread_mutex_unlock(&m_lock);
+
+   if (download) this->download(vlan, "", recs);
+   return true;
 }
 
 bool 
 NxMacMgrImpl::unwatchMac(const unsigned int vlan, const std::string& macAddr)
 {
-   return false;
+   NxMacKey key;
+
+   if (!macAddr.empty()) {
+      return key.fromString(macAddr, vlan) && unwatchMac(key);
+   }
+
+   pthread_mutex_lock(&m_lock);
+   bool valid = m_watchVlans.reset(vlan);
+   pthread_mutex_unlock(&m_lock);
+   return valid;
 }
 
 void 
 NxMacMgrImpl::setMacMgrHandler(NxMacMgrHandler* handler)
 {
-   return;
+   pthread_mutex_lock(&m_lock);
+   m_handler = handler;
+   pthread_mutex_unlock(&m_lock);
 }
 
 NxMacMgrHandler* 
 NxMacMgrImpl::getMacMgrHandler()
 {
-   return NULL;
+   return m_handler;
+}
+
+bool 
+NxMacMgrImpl::addStaticMac(const std::string& macAddr, const unsigned int vlan, uint32_t ifindex)
+{
+   NxMacKey key;
+
+   return key.fromString(macAddr, vlan) && addStaticMac(key, ifindex);
+}
+
+void 
+NxMacMgrImpl::setMacMgrHandler(NxMacMgrHandler* handler, uint32_t eventMask)
+{
+   m_handlerFilter.setMask(eventMask);
+   setMacMgrHandler(handler);
+}
+
+uint64_t 
+NxMacMgrImpl::getSkippedEventCount(uint32_t events)
+{
+   return m_handlerFilter.skipped(events);
+}
+
+NxMac* 
+NxMacMgrImpl::getMac(const nxos::NxMacKey& key, bool clearBuffer)
+{
+   std::set<NxMacImpl *>::iterator it;
+   std::set<NxMacImpl *>           freed;
+   NxMacImpl                      *mac = NULL;
+   uint32_t                        slot;
+
+   pthread_mutex_lock(&m_lock);
+   if (clearBuffer) freed.swap(m_macObjs);
+   if ((slot = m_table.find(key.key)) != NxMacTable::NONE) {
+      mac = new NxMacImpl(m_table.rec(slot), this);
+      m_macObjs.insert(mac);
+   }
+   pthread_mutex_unlock(&m_lock);
+
+   // The objects the App did not free, as set by clearBuffer.
+   for (it = freed.begin(); it != freed.end(); ++it) {
+      (*it)->m_mgr = NULL;
+      delete *it;
+   }
+   return mac;
+}
+
+bool 
+NxMacMgrImpl::watchMac(const nxos::NxMacKey& key, bool download)
+{
+   vector<NxMacRec> recs;
+   uint32_t         slot;
+
+   if (!key.valid()) return false;
+
+   pthread_mutex_lock(&m_lock);
+   m_watchKeys.insert(key.key);
+   if (download && ((slot = m_table.find(key.key)) != NxMacTable::NONE)) {
+      recs.push_back(m_table.rec(slot));
+   }
+   pthread_mutex_unlock(&m_lock);
+
+   if (download) this->download(key.vlan(), key.toString(), recs);
+   return true;
+}
+
+bool 
+NxMacMgrImpl::unwatchMac(const nxos::NxMacKey& key)
+{
+   pthread_mutex_lock(&m_lock);
+   bool watched = m_watchKeys.erase(key.key) > 0;
+   pthread_mutex_unlock(&m_lock);
+   return watched;
+}
+
+bool 
+NxMacMgrImpl::addStaticMac(const nxos::NxMacKey& key, uint32_t ifindex)
+{
+   if (NxIntfDict::get().name(ifindex).empty()) return false;
+
+   return postMacMsg(key, ifindex, TYPE_STATIC, ADD);
+}
+
+bool 
+NxMacMgrImpl::delStaticMac(const nxos::NxMacKey& key)
+{
+   return postMacMsg(key, 0, TYPE_STATIC, DELETE);
+}
+
+bool 
+NxMacMgrImpl::watched(uint64_t key) const
+{
+   return m_watchAll || m_watchVlans.test((unsigned int)(key >> 48)) ||
+          (!m_watchKeys.empty() && m_watchKeys.count(key));
+}
+
+void 
+NxMacMgrImpl::download(unsigned int id, const std::string& macAddr, const vector<NxMacRec>& recs)
+{
+   NxMacMgrHandler *handler = m_handler;
+
+   if (!handler) return;
+
+   if (!recs.empty() && m_handlerFilter.wants(NxMacMgrHandler::EVENT_MAC, recs.size())) {
+      for (size_t i = 0; i < recs.size(); i++) {
+         NxMacRec rec = recs[i];
+
+         rec.event = DOWNLOAD;
+         NxMacImpl mac(rec);
+         try {
+            handler->postMacHandlerCb(&mac);
+         } catch (...) {
+         }
+      }
+   }
+   if (m_handlerFilter.wants(NxMacMgrHandler::EVENT_MAC_DOWNLOAD)) {
+      try {
+         handler->postMacHandlerDownloadCb(id, macAddr);
+      } catch (...) {
+      }
+   }
+}
+
+bool 
+NxMacMgrImpl::postMacMsg(const nxos::NxMacKey& key, uint32_t ifindex, nxos::type_e type, nxos::event_type_e event)
+{
+   NxMacMgrHandler *handler = NULL;
+   NxMacRec         rec;
+   uint32_t         slot;
+
+   pthread_mutex_lock(&m_lock);
+   if (event == DELETE) {
+      // A static MAC is only deleted by delStaticMac().
+      if (((slot = m_table.find(key.key)) == NxMacTable::NONE) ||
+          ((m_table.rec(slot).type == TYPE_STATIC) != (type == TYPE_STATIC))) {
+         pthread_mutex_unlock(&m_lock);
+         return false;
+      }
+      rec       = m_table.rec(slot);
+      rec.event = DELETE;
+      m_table.remove(slot);
+   } else {
+      bool created;
+
+      // A learn does not replace a static MAC, only addStaticMac() does.
+      if (((slot = m_table.add(key.key, &created)) == NxMacTable::NONE) ||
+          (!created && (m_table.rec(slot).type == TYPE_STATIC) &&
+           (type != TYPE_STATIC))) {
+         pthread_mutex_unlock(&m_lock);
+         return false;
+      }
+      m_table.rec(slot).ifindex = ifindex;
+      m_table.rec(slot).type    = type;
+      m_table.rec(slot).event   = created ? ADD : UPDATE;
+      rec = m_table.rec(slot);
+   }
+   if (m_handler && watched(key.key) &&
+       m_handlerFilter.wants(NxMacMgrHandler::EVENT_MAC)) {
+      handler = m_handler;
+   }
+   pthread_mutex_unlock(&m_lock);
+
+   if (handler) {
+      NxMacImpl mac(rec);
+
+      try {
+         handler->postMacHandlerCb(&mac);
+      } catch (...) {
+      }
+   }
+   return true;
+}
+
+size_t 
+NxMacMgrImpl::memUsage()
+{
+   pthread_mutex_lock(&m_lock);
+   size_t bytes = m_table.memUsage();
+   pthread_mutex_unlock(&m_lock);
+   return bytes;
 }
\ No newline at end of file
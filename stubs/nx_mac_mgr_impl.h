@@ -9,16 +9,25 @@
 #ifndef __nx_mac_mgr_impl_H__
 #define __nx_mac_mgr_impl_H__
 
+#include <pthread.h>
+#include <set>
+#include <vector>
 #include "nx_mac_mgr.h" 
+#include "types/nx_intf_mgr.h"
+#include "nx_event_filter.h"
+#include "nx_mac_table.h"
    
 using namespace nxos;
 
    
 namespace nxos {
 
+class NxMacMgrImpl;
+
 class NxMacImpl : public NxMac {
 public:
     NxMacImpl();
+    NxMacImpl(const NxMacRec &rec,NxMacMgrImpl *mgr = NULL);
     virtual ~NxMacImpl();
     std::string getMacAddress();
     nxos::type_e getType();
@@ -28,6 +37,18 @@ public:
     bool operator==(NxMac const &mac_obj) const;
     bool operator!=(NxMac const &mac_obj) const;
     bool equal(NxMac const &mac_obj) const;
+    uint32_t getIfindex();
+    nxos::NxMacKey getMacKey();
+
+private:
+    // Copy of the table entry, the object outlives it.
+    nxos::NxMacKey      m_key;
+    uint32_t            m_ifindex;
+    nxos::type_e        m_type;
+    nxos::event_type_e  m_event;
+    NxMacMgrImpl       *m_mgr;  // tracking the object, NULL if none
+
+    friend class NxMacMgrImpl;
 };
 
 class NxMacMgrImpl : public NxMacMgr {
@@ -43,6 +64,34 @@ public:
     bool unwatchMac(const unsigned int vlan,const std::string &macAddr = "");
     void setMacMgrHandler(NxMacMgrHandler *handler);
     NxMacMgrHandler* getMacMgrHandler();
+    bool addStaticMac(const std::string &macAddr,const unsigned int vlan,uint32_t ifindex);
+    void setMacMgrHandler(NxMacMgrHandler *handler,uint32_t eventMask);
+    uint64_t getSkippedEventCount(uint32_t events = 0xffffffff);
+    NxMac* getMac(const nxos::NxMacKey &key,bool clearBuffer = false);
+    bool watchMac(const nxos::NxMacKey &key,bool download = true);
+    bool unwatchMac(const nxos::NxMacKey &key);
+    bool addStaticMac(const nxos::NxMacKey &key,uint32_t ifindex);
+    bool delStaticMac(const nxos::NxMacKey &key);
+
+    /* MAC table update from the event loop, false if it is dropped. A
+     * static MAC is only updated (or) deleted as a static one. */
+    bool postMacMsg(const nxos::NxMacKey &key,uint32_t ifindex,nxos::type_e type,nxos::event_type_e event);
+    size_t memUsage();
+
+private:
+    bool watched(uint64_t key) const;
+    void download(unsigned int id,const std::string &macAddr,const std::vector<NxMacRec> &recs);
+
+    pthread_mutex_t      m_lock;
+    NxMacTable           m_table;
+    NxMacMgrHandler     *m_handler;
+    NxEventFilter        m_handlerFilter;  // events of the handler
+    bool                 m_watchAll;
+    NxVlanSet            m_watchVlans;
+    std::set<uint64_t>   m_watchKeys;
+    std::set<NxMacImpl *> m_macObjs;  // returned by getMac(), not freed
+
+    friend class NxMacImpl;
 };
 }
 #endif // __nx_mac_mgr_impl_H__ 
\ No newline at end of file
@@ -0,0 +1,108 @@
+/** **********************************************************************
+    * Value types of the NxMacMgr APIs.
+    *
+    * Copyright (c) 2017 by cisco Systems, Inc.
+    *
+    * All rights reserved.
+************************************************************************/
+#include <cstdio>
+#include <cstring>
+#include "types/nx_mac_mgr.h"
+
+using namespace nxos;
+
+static int
+nxHexDigit(char c)
+{
+   if ((c >= '0') && (c <= '9')) return c - '0';
+   if ((c >= 'a') && (c <= 'f')) return c - 'a' + 10;
+   if ((c >= 'A') && (c <= 'F')) return c - 'A' + 10;
+   return -1;
+}
+
+/*
+ * Parse len bytes of str as groups of 1 to maxDigits hex digits split by
+ * sep, the 48 bits of the MAC in groups of 48 / groups bits.
+ */
+static bool
+nxMacParseGroups(const char *str, size_t len, char sep, unsigned int groups,
+                 unsigned int maxDigits, uint64_t *mac)
+{
+   unsigned int group = 0, digits = 0;
+   uint64_t     value = 0, word = 0;
+   int          d;
+
+   for (size_t i = 0; i <= len; i++) {
+      if ((i == len) || (str[i] == sep)) {
+         if (!digits || (++group > groups)) return false;
+         value  = (value << (48 / groups)) | word;
+         word   = 0;
+         digits = 0;
+      } else if (((d = nxHexDigit(str[i])) < 0) || (++digits > maxDigits)) {
+         return false;
+      } else {
+         word = (word << 4) | d;
+      }
+   }
+   if (group != groups) return false;
+
+   *mac = value;
+   return true;
+}
+
+static bool
+nxMacParse(const char *str, size_t len, unsigned int vlan, NxMacKey *key)
+{
+   uint64_t mac;
+   bool     ok;
+
+   if (memchr(str, '.', len)) {
+      ok = nxMacParseGroups(str, len, '.', 3, 4, &mac);
+   } else {
+      ok = nxMacParseGroups(str, len, memchr(str, '-', len) ? '-' : ':', 6,
+                            2, &mac);
+   }
+   if (!ok) return false;
+
+   *key = NxMacKey(mac, vlan);
+   return key->valid() && (key->vlan() == vlan);
+}
+
+NxMacKey::NxMacKey(uint64_t mac, unsigned int vlan)
+   : key((mac & 0xffffffffffffULL) | ((uint64_t)(vlan & 0xfff) << 48))
+{
+
+}
+
+bool
+NxMacKey::fromString(const char *macAddr, unsigned int vlan)
+{
+   return macAddr && nxMacParse(macAddr, strlen(macAddr), vlan, this);
+}
+
+bool
+NxMacKey::fromString(const std::string &macAddr, unsigned int vlan)
+{
+   return nxMacParse(macAddr.data(), macAddr.size(), vlan, this);
+}
+
+size_t
+NxMacKey::toString(char *buf, size_t len) const
+{
+   uint64_t m = mac();
+
+   if (len < NX_MAC_ADDR_STR_LEN) return 0;
+
+   return snprintf(buf, len, "%04x.%04x.%04x", (unsigned int)(m >> 32),
+                   (unsigned int)(m >> 16) & 0xffff,
+                   (unsigned int)m & 0xffff);
+}
+
+std::string
+NxMacKey::toString() const
+{
+   char buf[NX_MAC_ADDR_STR_LEN];
+   size_t n = toString(buf, sizeof(buf));
+
+   return std::string(buf, n);
+}
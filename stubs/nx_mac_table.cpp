@@ -0,0 +1,66 @@
+/** **********************************************************************
+    * Compact MAC table used by NxMacMgr.
+    *
+    * Copyright (c) 2017 by cisco Systems, Inc.
+    *
+    * All rights reserved.
+************************************************************************/
+#include <cstring>
+#include "nx_mac_table.h"
+
+namespace nxos {
+
+NxMacTable::NxMacTable()
+   : m_count(0)
+{
+
+}
+
+uint32_t
+NxMacTable::add(uint64_t key, bool* created)
+{
+   NxMacKey  macKey;
+   uint32_t  slot;
+   NxMacRec *rec;
+
+   if (created) *created = false;
+   macKey.key = key;
+   if (!macKey.valid() || (key >> 60)) return NONE;
+   if ((slot = find(key)) != NONE) return slot;
+
+   if (m_freeSlots.empty()) {
+      slot = (uint32_t)m_recs.size();
+      m_recs.push_back(NxMacRec());
+   } else {
+      slot = m_freeSlots.back();
+      m_freeSlots.pop_back();
+   }
+
+   rec = &m_recs[slot];
+   memset(rec, 0, sizeof(*rec));
+   rec->key = key;
+   m_index.insert(*this, slot + 1);
+   m_count++;
+   if (created) *created = true;
+   return slot;
+}
+
+void
+NxMacTable::remove(uint32_t slot)
+{
+   if (!used(slot)) return;
+
+   m_index.erase(*this, slot + 1);
+   m_recs[slot].key = 0;
+   m_freeSlots.push_back(slot);
+   m_count--;
+}
+
+size_t
+NxMacTable::memUsage() const
+{
+   return (m_recs.capacity() * sizeof(NxMacRec)) +
+          (m_freeSlots.capacity() * sizeof(uint32_t)) + m_index.memUsage();
+}
+
+}
@@ -0,0 +1,79 @@
+/** **********************************************************************
+    * Compact MAC table used by NxMacMgr.
+    *
+    * A MAC entry is a 16 byte record keyed by its MAC address & VLAN
+    * packed in 64 bits (NxMacKey) with the ifindex of its interface, so
+    * no entry holds a string. The records are in one array, found by
+    * key through an open addressing hash of their slots, & freed slots
+    * are reused. A million MACs take about 24MB.
+    *
+    * Copyright (c) 2017 by cisco Systems, Inc.
+    *
+    * All rights reserved.
+************************************************************************/
+#ifndef __nx_mac_table_H__
+#define __nx_mac_table_H__
+
+#include <stdint.h>
+#include <vector>
+#include "nx_mac_mgr.h"
+#include "nx_hash_index.h"
+
+namespace nxos {
+
+/*
+ * MAC entry.
+ */
+struct NxMacRec {
+    uint64_t    key;          // NxMacKey, 0 if the record is free
+    uint32_t    ifindex;
+    uint8_t     type;         // type_e
+    uint8_t     event;        // event_type_e
+    uint16_t    pad;
+};
+
+class NxMacTable {
+public:
+    static const uint32_t NONE = 0xffffffff;
+
+    NxMacTable();
+
+    /* Slot of key, created if absent. NONE if key is not valid. */
+    uint32_t add(uint64_t key, bool *created = NULL);
+    void remove(uint32_t slot);
+    uint32_t find(uint64_t key) const {
+        uint32_t value = key ? m_index.find(*this, key) : 0;
+
+        return value ? (value - 1) : NONE;
+    }
+
+    /* Slots in use are below size(), free ones have a 0 key. */
+    uint32_t size() const { return (uint32_t)m_recs.size(); }
+    uint32_t count() const { return m_count; }
+    bool used(uint32_t slot) const {
+        return (slot < m_recs.size()) && m_recs[slot].key;
+    }
+    NxMacRec &rec(uint32_t slot) { return m_recs[slot]; }
+    const NxMacRec &rec(uint32_t slot) const { return m_recs[slot]; }
+    size_t memUsage() const;
+
+    /* NxHashIndex keys, values are slot + 1. */
+    uint32_t hashOf(uint32_t value) const {
+        return hashKey(m_recs[value - 1].key);
+    }
+    uint32_t hashKey(uint64_t key) const {
+        return (uint32_t)((key * 0x9e3779b97f4a7c15ULL) >> 32);
+    }
+    bool match(uint32_t value, uint64_t key) const {
+        return m_recs[value - 1].key == key;
+    }
+
+private:
+    std::vector<NxMacRec>        m_recs;
+    std::vector<uint32_t>        m_freeSlots;
+    NxHashIndex<NxMacTable>      m_index;
+    uint32_t                     m_count;
+};
+
+}
+#endif // __nx_mac_table_H__
@@ -0,0 +1,350 @@
+/** **********************************************************************
+    * Asynchronous route requests of the App.
+    *
+    * Requests are queued in the order they are made & completed from the
+    * event loop as RIB acknowledges them, so the App keeps many of them in
+    * flight instead of waiting a round trip per call. Bulk requests keep a
+    * copy of their records, a send takes the pending operations of the
+    * App route tables at the time of the call.
+    *
+    * When paced, requests are sent through a token bucket filled at the
+    * install rate. The rate is adjusted AIMD on the commit latency of each
+    * request & its failures. Withdrawals are queued ahead of the adds of
+    * other prefixes & sent regardless of the tokens left.
+    *
+    * Copyright (c) 2017 by cisco Systems, Inc.
+    *
+    * All rights reserved.
+************************************************************************/
+#include <algorithm>
+#include <cstring>
+#include "nx_rib_mgr_impl.h"
+#include "nx_exception.h"
+
+using namespace std;
+using namespace nxos;
+
+static bool
+nxRecPrefix(const nx_l3_route_rec& rec, NxPrefix* prefix)
+{
+   return nxL3ApiPrefix(std::string(rec.address,
+                                    strnlen(rec.address, sizeof(rec.address))),
+                        rec.maskLen, prefix);
+}
+
+/* True if any of routes is for a prefix in prefixes. */
+static bool
+nxRecsOverlap(const std::vector<nx_l3_route_rec>& routes,
+              const std::set<NxPrefix>& prefixes)
+{
+   NxPrefix prefix;
+
+   for (size_t i = 0; i < routes.size(); i++) {
+      if (nxRecPrefix(routes[i], &prefix) && prefixes.count(prefix)) {
+         return true;
+      }
+   }
+   return false;
+}
+
+/* A request bigger than the route limit still goes alone. */
+bool
+NxRibMgrImpl::hasL3RouteAsyncRoom(size_t count) const
+{
+   if (m_asyncReqs.empty()) return true;
+   if (m_asyncReqs.size() >= m_asyncMaxReqs) return false;
+   return !m_asyncMaxRoutes || (m_asyncRoutes + count <= m_asyncMaxRoutes);
+}
+
+/*
+ * Paced withdrawals go ahead of the queued adds of the same VRF & AF not
+ * touching their prefixes & of any other VRF (or) AF, behind the older
+ * withdrawals & sends.
+ */
+uint64_t
+NxRibMgrImpl::queueL3RouteAsync(NxL3RouteAsyncReq* req)
+{
+   std::deque<NxL3RouteAsyncReq *>::iterator it = m_asyncReqs.end();
+   std::set<NxPrefix>                        prefixes;
+   NxPrefix                                  prefix;
+
+   req->id = ++m_asyncId;
+   m_asyncRoutes += req->count;
+
+   if (m_paceMaxRate && (req->op == DELETE)) {
+      req->urgent = true;
+      for (size_t i = 0; i < req->routes.size(); i++) {
+         if (nxRecPrefix(req->routes[i], &prefix)) prefixes.insert(prefix);
+      }
+      while (it != m_asyncReqs.begin()) {
+         const NxL3RouteAsyncReq *prev = *(it - 1);
+
+         if ((prev->op != ADD) ||
+             ((prev->vrfName == req->vrfName) && (prev->af == req->af) &&
+              nxRecsOverlap(prev->routes, prefixes))) {
+            break;
+         }
+         --it;
+      }
+      if (it != m_asyncReqs.end()) m_paceStats.urgentRequests++;
+   }
+   m_asyncReqs.insert(it, req);
+   return req->id;
+}
+
+/*
+ * Take the pending operations of the App routes of af, count of them.
+ * Deleted routes leave the table now, adding one again is a new route.
+ */
+NxRibMgrImpl::NxL3RouteAsyncReq*
+NxRibMgrImpl::takeMyL3RouteOps(nxos::af_e af, size_t count)
+{
+   NxMyL3RouteVrfTbl::iterator  vit;
+   NxL3RouteTbl::iterator       rit;
+   NxL3RouteAsyncReq           *req = new NxL3RouteAsyncReq;
+
+   req->op    = UPDATE;
+   req->af    = af;
+   req->count = count;
+   for (vit = m_myRoutes[af].begin(); vit != m_myRoutes[af].end(); ++vit) {
+      NxMyL3RouteTbl& tbl = vit->second;
+
+      if (tbl.pendingAdd.empty() && tbl.pendingDel.empty()) continue;
+
+      req->sends.push_back(NxL3RouteAsyncSend());
+      NxL3RouteAsyncSend& send = req->sends.back();
+      send.vrfName = vit->first;
+      send.adds.swap(tbl.pendingAdd);
+      for (std::set<NxPrefix>::iterator it = tbl.pendingDel.begin();
+           it != tbl.pendingDel.end(); ++it) {
+         rit = tbl.routes.find(*it);
+         if (rit == tbl.routes.end()) continue;
+         send.dels.push_back(rit->second);
+         tbl.routes.erase(rit);
+      }
+      tbl.pendingDel.clear();
+   }
+   return req;
+}
+
+/* Commit the pending operations taken by sendMyL3RoutesToRibAsync(). */
+bool
+NxRibMgrImpl::commitL3RouteAsyncSend(NxL3RouteAsyncReq* req)
+{
+   NxL3RouteTbl::iterator rit;
+
+   for (size_t s = 0; s < req->sends.size(); s++) {
+      NxL3RouteAsyncSend& send = req->sends[s];
+      NxMyL3RouteTbl&     tbl = m_myRoutes[req->af][send.vrfName];
+
+      for (size_t d = 0; d < send.dels.size(); d++) {
+         notifyMyL3Route(send.dels[d], DELETE);
+         delete send.dels[d];
+      }
+      send.dels.clear();
+      for (std::set<NxPrefix>::iterator it = send.adds.begin();
+           it != send.adds.end(); ++it) {
+         rit = tbl.routes.find(*it);
+         if (rit != tbl.routes.end()) notifyMyL3Route(rit->second, ADD);
+      }
+   }
+   m_commitCount++;
+   m_snapDirty = true;
+   return true;
+}
+
+uint64_t
+NxRibMgrImpl::addL3RoutesAsync(const std::vector<nxos::nx_l3_route_rec>& routes, const std::string& vrfName, nxos::af_e af)
+{
+   NxL3RouteAsyncReq *req;
+
+   if (!validVrfName(vrfName) || (af >= MAX_AF) ||
+       !hasL3RouteAsyncRoom(routes.size())) {
+      return 0;
+   }
+
+   req = new NxL3RouteAsyncReq;
+   req->op      = ADD;
+   req->vrfName = vrfName;
+   req->af      = af;
+   req->routes  = routes;
+   req->count   = routes.size();
+   return queueL3RouteAsync(req);
+}
+
+uint64_t
+NxRibMgrImpl::delL3RoutesAsync(const std::vector<nxos::nx_l3_route_rec>& routes, const std::string& vrfName, nxos::af_e af)
+{
+   NxL3RouteAsyncReq *req;
+
+   if (!validVrfName(vrfName) || (af >= MAX_AF) ||
+       !hasL3RouteAsyncRoom(routes.size())) {
+      return 0;
+   }
+
+   req = new NxL3RouteAsyncReq;
+   req->op      = DELETE;
+   req->vrfName = vrfName;
+   req->af      = af;
+   req->routes  = routes;
+   req->count   = routes.size();
+   return queueL3RouteAsync(req);
+}
+
+uint64_t
+NxRibMgrImpl::sendMyL3RoutesToRibAsync(nxos::af_e af)
+{
+   NxMyL3RouteVrfTbl::iterator  vit;
+   size_t                       count = 0;
+
+   if (af >= MAX_AF) return 0;
+
+   for (vit = m_myRoutes[af].begin(); vit != m_myRoutes[af].end(); ++vit) {
+      count += vit->second.pendingAdd.size() + vit->second.pendingDel.size();
+   }
+   if (!count || !hasL3RouteAsyncRoom(count)) return 0;
+
+   return queueL3RouteAsync(takeMyL3RouteOps(af, count));
+}
+
+bool
+NxRibMgrImpl::setL3RouteAsyncLimit(unsigned int maxRequests, unsigned int maxRoutes)
+{
+   if (!maxRequests) return false;
+
+   m_asyncMaxReqs   = maxRequests;
+   m_asyncMaxRoutes = maxRoutes;
+   return true;
+}
+
+unsigned int
+NxRibMgrImpl::getL3RouteAsyncInFlight()
+{
+   return (unsigned int)m_asyncReqs.size();
+}
+
+void
+NxRibMgrImpl::pollL3RouteAsync(unsigned int maxRequests)
+{
+   size_t due = m_asyncReqs.size();
+
+   if (maxRequests && (maxRequests < due)) due = maxRequests;
+   if (m_paceMaxRate) refillL3RoutePacing();
+   completeL3RouteAsync(due, m_paceMaxRate != 0);
+}
+
+/* Send & complete the oldest due requests, within the tokens if paced. */
+void
+NxRibMgrImpl::completeL3RouteAsync(size_t due, bool paced)
+{
+   std::vector<nx_l3_route_rec_err>  errs;
+   NxL3RouteAsyncReq                *req;
+   uint64_t                          startUs;
+   bool                              result = false, failed;
+
+   // Synchronous calls made from the completions do not wait on it.
+   if (m_asyncBusy) return;
+
+   // Requests made from the completions wait for the next poll.
+   m_asyncBusy = true;
+   for (size_t i = 0; (i < due) && !m_asyncReqs.empty(); i++) {
+      req = m_asyncReqs.front();
+      if (paced && !req->urgent && (m_paceTokens <= 0)) break;
+
+      m_asyncReqs.pop_front();
+      m_asyncRoutes -= req->count;
+
+      errs.clear();
+      startUs = nxRibNowUs();
+      if (req->op == ADD) {
+         result = addL3Routes(req->routes, req->vrfName, req->af, &errs);
+      } else if (req->op == DELETE) {
+         result = delL3Routes(req->routes, req->vrfName, req->af, &errs);
+      } else {
+         result = commitL3RouteAsyncSend(req);
+      }
+
+      if (paced) {
+         // Bad records are the App's, only RIB failing slows down.
+         failed = !result && !req->routes.empty() &&
+                  (errs.size() < req->routes.size());
+         for (size_t e = 0; !failed && (e < errs.size()); e++) {
+            failed = (errs[e].errCode != ERR_INVALID) &&
+                     (errs[e].errCode != ERR_NOT_FOUND);
+         }
+         m_paceTokens -= req->count;
+         m_paceStats.sentRoutes += req->count;
+         updateL3RoutePacing(nxRibNowUs() - startUs, failed);
+      }
+      if (m_handler &&
+          m_handlerFilter.wants(NxRibMgrHandler::EVENT_L3_ROUTE_ASYNC)) {
+         m_handler->postL3RouteAsyncCb(req->id, result, errs);
+      }
+      delete req;
+   }
+   m_asyncBusy = false;
+}
+
+/* Tokens accrue at the current rate, up to 100ms worth. */
+void
+NxRibMgrImpl::refillL3RoutePacing()
+{
+   uint64_t nowUs = nxRibNowUs();
+   double   burst = std::max(m_paceRate / 10, 1.0);
+
+   m_paceTokens += m_paceRate * (nowUs - m_paceRefillUs) / 1e6;
+   if (m_paceTokens > burst) m_paceTokens = burst;
+   m_paceRefillUs = nowUs;
+}
+
+void
+NxRibMgrImpl::updateL3RoutePacing(uint64_t latencyUs, bool failed)
+{
+   m_paceStats.lastCommitUs = (latencyUs > 0xffffffffULL) ?
+                              0xffffffffU : (uint32_t)latencyUs;
+   if (failed || (latencyUs > m_paceTargetUs)) {
+      m_paceRate = std::max(m_paceRate / 2, (double)m_paceMinRate);
+      m_paceStats.backoffs++;
+   } else if (m_paceRate < m_paceMaxRate) {
+      m_paceRate = std::min(m_paceRate + std::max(m_paceMaxRate / 20U, 1U),
+                            (double)m_paceMaxRate);
+      m_paceStats.increases++;
+   }
+}
+
+bool
+NxRibMgrImpl::enableL3RoutePacing(unsigned int maxRate, unsigned int minRate, unsigned int targetLatencyMs, bool enable)
+{
+   if (!enable) {
+      m_paceMaxRate = 0;
+      pollL3RouteAsync();
+      return true;
+   }
+   if (!minRate) minRate = std::max(maxRate / 10, 1U);
+   if (!maxRate || (minRate > maxRate)) return false;
+
+   if (!m_paceMaxRate) {
+      // Start half way, the first commits show how RIB copes.
+      m_paceRate     = std::max(maxRate / 2, minRate);
+      m_paceTokens   = 0;
+      m_paceRefillUs = nxRibNowUs();
+   }
+   m_paceMaxRate  = maxRate;
+   m_paceMinRate  = minRate;
+   m_paceTargetUs = targetLatencyMs * 1000;
+   m_paceRate     = std::min(std::max(m_paceRate, (double)minRate),
+                             (double)maxRate);
+   return true;
+}
+
+bool
+NxRibMgrImpl::getL3RoutePacingStats(nxos::NxL3RoutePacingStats* stats)
+{
+   if (!stats) return false;
+
+   *stats = m_paceStats;
+   stats->rate           = m_paceMaxRate ? (uint32_t)m_paceRate : 0;
+   stats->queuedRequests = m_asyncReqs.size();
+   stats->queuedRoutes   = m_asyncRoutes;
+   return m_paceMaxRate != 0;
+}
@@ -6,10 +6,145 @@
     *
     * All rights reserved.
 ************************************************************************/
+#include <pthread.h>
+#include <time.h>
+#include <algorithm>
+#include <cstring>
+#include <sstream>
 #include "nx_rib_mgr_impl.h" 
+#include "nx_intf_dict.h"
+#include "nx_exception.h" 
    
 using namespace nxos;
 
+bool
+nxos::nxL3ApiPrefix(const std::string& addr, unsigned int maskLen,
+                    NxPrefix* prefix)
+{
+   NxIpAddr ip;
+
+   if (!ip.fromString(addr)) return false;
+
+   // APIs take maskLen 0 as a host route.
+   return prefix->set(ip, maskLen ? maskLen : ip.addrBits());
+}
+
+uint64_t
+nxos::nxRibNowMs()
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ((uint64_t)ts.tv_sec * 1000) + (ts.tv_nsec / 1000000);
+}
+
+uint64_t
+nxos::nxRibNowUs()
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ((uint64_t)ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+}
+
+/* Fill up to maxCount of nextHops into buf, returns the full count. */
+static unsigned int
+nxCopyL3NextHops(const std::vector<NxL3NextHopImpl *>& nextHops,
+                 NxL3NextHop** buf, unsigned int maxCount)
+{
+   size_t count = std::min((size_t)maxCount, nextHops.size());
+
+   for (size_t i = 0; i < count; i++) {
+      buf[i] = nextHops[i];
+   }
+   return (unsigned int)nextHops.size();
+}
+
+/* FNV-1a */
+uint64_t
+nxos::nxRibHashBytes(uint64_t hash, const void* data, size_t len)
+{
+   const unsigned char *p = (const unsigned char *)data;
+
+   for (size_t i = 0; i < len; i++) {
+      hash = (hash ^ p[i]) * 0x100000001b3ULL;
+   }
+   return hash;
+}
+
+/*
+ * VRF & owner names of the next-hops, never freed as next-hops outlive
+ * the mgr & the names are few. Names are the keys of the map, they stay
+ * put.
+ */
+static pthread_mutex_t nxRibNamesLock = PTHREAD_MUTEX_INITIALIZER;
+static std::map<std::string, uint32_t>  *nxRibNameIds;
+static std::vector<const std::string *> *nxRibNames;
+
+uint32_t
+nxos::nxRibNameId(const std::string& name)
+{
+   std::map<std::string, uint32_t>::iterator it;
+   uint32_t                                  id;
+
+   pthread_mutex_lock(&nxRibNamesLock);
+   if (!nxRibNameIds) {
+      nxRibNameIds = new std::map<std::string, uint32_t>();
+      nxRibNames   = new std::vector<const std::string *>();
+      it = nxRibNameIds->insert(std::make_pair(std::string(), 0)).first;
+      nxRibNames->push_back(&it->first);
+   }
+   it = nxRibNameIds->find(name);
+   if (it == nxRibNameIds->end()) {
+      it = nxRibNameIds->insert(std::make_pair(name,
+                                (uint32_t)nxRibNames->size())).first;
+      nxRibNames->push_back(&it->first);
+   }
+   id = it->second;
+   pthread_mutex_unlock(&nxRibNamesLock);
+   return id;
+}
+
+const std::string&
+nxos::nxRibName(uint32_t id)
+{
+   static const std::string none;
+   const std::string       *name = &none;
+
+   pthread_mutex_lock(&nxRibNamesLock);
+   if (nxRibNames && (id < nxRibNames->size())) name = (*nxRibNames)[id];
+   pthread_mutex_unlock(&nxRibNamesLock);
+   return *name;
+}
+
+static uint64_t
+nxHashL3NextHops(const std::vector<NxL3NextHopImpl *>& nextHops)
+{
+   uint64_t hash = 0xcbf29ce484222325ULL;
+
+   for (size_t i = 0; i < nextHops.size(); i++) {
+      hash = nextHops[i]->hash(hash);
+   }
+   return hash;
+}
+
+static bool
+nxSameL3NextHops(const std::vector<NxL3NextHopImpl *>& nextHops1,
+                 const std::vector<NxL3NextHopImpl *>& nextHops2)
+{
+   if (nextHops1.size() != nextHops2.size()) return false;
+   for (size_t i = 0; i < nextHops1.size(); i++) {
+      if (!nextHops1[i]->sameAs(*nextHops2[i])) return false;
+   }
+   return true;
+}
+
+/* Record strings are fixed size and need not be NUL terminated. */
+static std::string
+nxRecStr(const char* buf, size_t len)
+{
+   return std::string(buf, strnlen(buf, len));
+}
    
     
 // Implementation for class  
@@ -73,6 +208,21 @@ NxVrfImpl::equal(NxVrf const& vrf_obj) const
     
 // Implementation for class  
 NxL3NextHopImpl::NxL3NextHopImpl()
+   : m_ip(), m_ifindex(0), m_vrfId(0), m_ownerId(0), m_preference(0),
+     m_metric(0), m_tag(0), m_segmentId(0), m_tunnelId(0), m_encapType(NONE),
+     m_type(ATTACHED)
+{
+
+}
+
+NxL3NextHopImpl::NxL3NextHopImpl(const NxIpAddr& address,
+                                 const std::string& intfName,
+                                 const std::string& vrfName,
+                                 unsigned int preference, nh_types_e type)
+   : m_ip(address), m_ifindex(NxIntfDict::get().ifindex(intfName)),
+     m_vrfId(nxRibNameId(vrfName)), m_ownerId(0),
+     m_preference(preference), m_metric(0), m_tag(0), m_segmentId(0),
+     m_tunnelId(0), m_encapType(NONE), m_type(type)
 {
 
 }
@@ -85,173 +235,978 @@ NxL3NextHopImpl::~NxL3NextHopImpl()
 std::string 
 NxL3NextHopImpl::getAddress()
 {
-   return "";
+   return m_ip.toString();
 }
 
 std::string 
 NxL3NextHopImpl::getOutInterface()
 {
-   return "";
+   return NxIntfDict::get().name(m_ifindex);
+}
+
+uint32_t 
+NxL3NextHopImpl::getOutIfindex()
+{
+   return m_ifindex;
 }
 
 std::string 
 NxL3NextHopImpl::getVrfName()
 {
-   return "";
+   return nxRibName(m_vrfId);
 }
 
 std::string 
 NxL3NextHopImpl::getOwner()
 {
-   return "";
+   return nxRibName(m_ownerId);
 }
 
 unsigned int 
 NxL3NextHopImpl::getPreference()
 {
-   return (unsigned int)0;
+   return m_preference;
 }
 
 unsigned int 
 NxL3NextHopImpl::getMetric()
 {
-   return (unsigned int)0;
+   return m_metric;
 }
 
 unsigned int 
 NxL3NextHopImpl::getTag()
 {
-   return (unsigned int)0;
+   return m_tag;
 }
 
 unsigned int 
 NxL3NextHopImpl::getSegmentId()
 {
-   return (unsigned int)0;
+   return m_segmentId;
 }
 
 unsigned int 
 NxL3NextHopImpl::getTunnelId()
 {
-   return (unsigned int)0;
+   return m_tunnelId;
 }
 
 nxos::encap_type_e 
 NxL3NextHopImpl::getEncapType()
 {
-   return (nxos::encap_type_e)0;
+   return m_encapType;
 }
 
 bool 
 NxL3NextHopImpl::checkType(nh_types_e type)
 {
-   return false;
+   return (m_type == type);
+}
+
+nxos::NxIpAddr 
+NxL3NextHopImpl::getIpAddr()
+{
+   return m_ip;
+}
+
+bool
+NxL3NextHopImpl::sameAs(const NxL3NextHopImpl& nh) const
+{
+   return (m_ip == nh.m_ip) && (m_type == nh.m_type) &&
+          (m_preference == nh.m_preference) && (m_metric == nh.m_metric) &&
+          (m_tag == nh.m_tag) && (m_segmentId == nh.m_segmentId) &&
+          (m_tunnelId == nh.m_tunnelId) && (m_encapType == nh.m_encapType) &&
+          (m_ifindex == nh.m_ifindex) && (m_vrfId == nh.m_vrfId) &&
+          (m_ownerId == nh.m_ownerId);
+}
+
+uint64_t
+NxL3NextHopImpl::hash(uint64_t seed) const
+{
+   uint32_t vals[15] = { m_preference, m_metric, m_tag, m_segmentId,
+                         m_tunnelId, (uint32_t)m_encapType, (uint32_t)m_type,
+                         m_ifindex, m_vrfId, m_ownerId, m_ip.af };
+
+   memcpy(&vals[11], m_ip.addr, sizeof(m_ip.addr));
+   // FNV-1a by 32 bit word, all of a next-hop is integers.
+   for (size_t i = 0; i < sizeof(vals) / sizeof(vals[0]); i++) {
+      seed = (seed ^ vals[i]) * 0x100000001b3ULL;
+   }
+   return seed;
+}
+
+bool
+NxL3NextHopImpl::lessThan(const NxL3NextHopImpl* nh1, const NxL3NextHopImpl* nh2)
+{
+   if (nh1->m_ip != nh2->m_ip) return (nh1->m_ip < nh2->m_ip);
+   return (nh1->m_ifindex < nh2->m_ifindex);
+}
+    
+// Implementation for class  
+NxL3NextHopGroupImpl::NxL3NextHopGroupImpl(NxRibMgrImpl* ribMgr, uint32_t id)
+   : m_ribMgr(ribMgr), m_id(id), m_refCount(0), m_hash(0), m_nhCursor(0),
+     m_event(NO_EVENT)
+{
+
+}
+
+NxL3NextHopGroupImpl::~NxL3NextHopGroupImpl()
+{
+   for (size_t i = 0; i < m_nextHops.size(); i++) {
+      delete m_nextHops[i];
+   }
+}
+
+uint32_t 
+NxL3NextHopGroupImpl::getId()
+{
+   return m_id;
+}
+
+unsigned int 
+NxL3NextHopGroupImpl::getL3NextHopCount()
+{
+   return (unsigned int)m_nextHops.size();
+}
+
+NxL3NextHop* 
+NxL3NextHopGroupImpl::getL3NextHop(bool fromFirst)
+{
+   if (fromFirst) m_nhCursor = 0;
+   if (m_nhCursor >= m_nextHops.size()) return NULL;
+   return m_nextHops[m_nhCursor++];
+}
+
+unsigned int 
+NxL3NextHopGroupImpl::getL3NextHops(NxL3NextHop** nextHops, unsigned int maxCount)
+{
+   return nxCopyL3NextHops(m_nextHops, nextHops, maxCount);
+}
+
+unsigned int 
+NxL3NextHopGroupImpl::getRouteCount()
+{
+   return m_refCount;
+}
+
+nxos::event_type_e 
+NxL3NextHopGroupImpl::getEvent()
+{
+   return m_event;
 }
     
 // Implementation for class  
 NxL3RouteImpl::NxL3RouteImpl()
+   : m_prefix(), m_event(NO_EVENT), m_nhGroup(NULL), m_nhCursor(0),
+     m_batchId(0), m_stale(false), m_stats(NULL), m_ribMgr(NULL)
 {
 
 }
 
+NxL3RouteImpl::NxL3RouteImpl(const std::string& vrfName,
+                             const NxPrefix& prefix)
+   : m_vrfName(vrfName), m_prefix(prefix), m_event(NO_EVENT), m_nhGroup(NULL),
+     m_nhCursor(0), m_batchId(0), m_stale(false), m_stats(NULL), m_ribMgr(NULL)
+{
+
+}
+
+NxL3RouteImpl::NxL3RouteImpl(const NxL3RouteImpl& route)
+   : NxL3Route(), m_vrfName(route.m_vrfName), m_prefix(route.m_prefix),
+     m_event(route.m_event), m_nhGroup(NULL), m_nhCursor(0), m_batchId(0),
+     m_stale(false), m_stats(NULL), m_ribMgr(NULL)
+{
+   copyL3NextHops(route);
+}
+
 NxL3RouteImpl::~NxL3RouteImpl()
 {
+   // Freed by the App, the manager no longer tracks it.
+   if (m_ribMgr) m_ribMgr->untrackL3Route(this);
+   clearL3NextHops();
+}
+
+void
+NxL3RouteImpl::clearL3NextHops()
+{
+   setL3NextHopGroup(NULL);
+   for (size_t i = 0; i < m_nextHops.size(); i++) {
+      delete m_nextHops[i];
+   }
+   m_nextHops.clear();
+   m_nhCursor = 0;
+}
+
+void
+NxL3RouteImpl::setL3NextHopGroup(NxL3NextHopGroupImpl* group)
+{
+   NxL3NextHopGroupImpl *old = m_nhGroup;
+
+   if (group) group->m_refCount++;
+   m_nhGroup  = group;
+   m_nhCursor = 0;
+   if (!old) return;
+
+   if (old->m_ribMgr) {
+      old->m_ribMgr->releaseL3NextHopGroup(old);
+   } else if (!--old->m_refCount) {
+      delete old;
+   }
+}
+
+/*
+ * Replace the next-hops of the route by the ones of route. Shared
+ * next-hops are immutable, only the reference is copied.
+ */
+void
+NxL3RouteImpl::copyL3NextHops(const NxL3RouteImpl& route)
+{
+   setL3NextHopGroup(route.m_nhGroup);
+   for (size_t i = 0; i < m_nextHops.size(); i++) {
+      delete m_nextHops[i];
+   }
+   m_nextHops.clear();
+   for (size_t i = 0; i < route.m_nextHops.size(); i++) {
+      m_nextHops.push_back(new NxL3NextHopImpl(*route.m_nextHops[i]));
+   }
+}
+
+/*
+ * Copy the shared next-hops into the route before changing them.
+ */
+void
+NxL3RouteImpl::unshareL3NextHops()
+{
+   if (!m_nhGroup) return;
 
+   for (size_t i = 0; i < m_nhGroup->m_nextHops.size(); i++) {
+      m_nextHops.push_back(new NxL3NextHopImpl(*m_nhGroup->m_nextHops[i]));
+   }
+   setL3NextHopGroup(NULL);
 }
 
 std::string 
 NxL3RouteImpl::getVrfName()
 {
-   return "";
+   return m_vrfName;
 }
 
 std::string 
 NxL3RouteImpl::getAddress()
 {
-   return "";
+   return m_prefix.ip.toString();
 }
 
 unsigned int 
 NxL3RouteImpl::getMaskLen()
 {
-   return (unsigned int)0;
+   return m_prefix.maskLen;
 }
 
 unsigned int 
 NxL3RouteImpl::getL3NextHopCount()
 {
-   return (unsigned int)0;
+   return (unsigned int)l3NextHops().size();
 }
 
 NxL3NextHop* 
 NxL3RouteImpl::getL3NextHop(const std::string& address, const std::string& intfName)
 {
-   return NULL;
+   NxIpAddr ip;
+
+   if (!ip.fromString(address)) return NULL;
+   return getL3NextHop(ip, intfName);
 }
 
 NxL3NextHop* 
 NxL3RouteImpl::getL3NextHop(bool fromFirst)
 {
-   return NULL;
+   const std::vector<NxL3NextHopImpl *>& nextHops = l3NextHops();
+
+   if (fromFirst) m_nhCursor = 0;
+   if (m_nhCursor >= nextHops.size()) return NULL;
+   return nextHops[m_nhCursor++];
 }
 
 nxos::event_type_e 
 NxL3RouteImpl::getEvent()
 {
-   return (nxos::event_type_e)0;
+   return m_event;
 }
 
 bool 
 NxL3RouteImpl::operator==(NxL3Route const& route_obj) const
 {
-   return false;
+   return equal(route_obj);
 }
 
 bool 
 NxL3RouteImpl::operator!=(NxL3Route const& route_obj) const
 {
-   return false;
+   return !equal(route_obj);
 }
 
 bool 
 NxL3RouteImpl::equal(NxL3Route const& route_obj) const
 {
-   return false;
+   const NxL3RouteImpl *route = dynamic_cast<const NxL3RouteImpl *>(&route_obj);
+
+   return route && (m_prefix == route->m_prefix) &&
+          (m_vrfName == route->m_vrfName);
 }
 
 NxL3NextHop* 
 NxL3RouteImpl::addL3DirectNextHop(const std::string& nextHopAddr, const std::string& intfName, uint8_t preference)
 {
-   return NULL;
+   NxIpAddr ip;
+
+   if (!ip.fromString(nextHopAddr)) return NULL;
+   return addL3DirectNextHop(ip, intfName, preference);
 }
 
 NxL3NextHop* 
 NxL3RouteImpl::addL3RecursiveNextHop(const std::string& nextHopAddr, uint8_t preference)
 {
-   return NULL;
+   NxIpAddr ip;
+
+   if (!ip.fromString(nextHopAddr)) return NULL;
+   return addL3RecursiveNextHop(ip, preference);
 }
 
 bool 
 NxL3RouteImpl::delL3NextHop(const std::string& nexHopAddress, const std::string& intfName)
 {
-   return false;
+   NxIpAddr ip;
+
+   if (!ip.fromString(nexHopAddress)) return false;
+   return delL3NextHop(ip, intfName);
 }
 
 std::string 
 NxL3RouteImpl::getL3Prefix() const
 {
-   return "";
+   return m_prefix.toString();
+}
+
+nxos::NxPrefix 
+NxL3RouteImpl::getPrefix() const
+{
+   return m_prefix;
+}
+
+NxL3NextHop* 
+NxL3RouteImpl::getL3NextHop(const nxos::NxIpAddr& address, const std::string& intfName)
+{
+   const std::vector<NxL3NextHopImpl *>& nextHops = l3NextHops();
+   uint32_t ifindex = NxIntfDict::get().ifindex(intfName, false);
+
+   // A next-hop interface is always in the dictionary.
+   if (!intfName.empty() && !ifindex) return NULL;
+   for (size_t i = 0; i < nextHops.size(); i++) {
+      if ((nextHops[i]->m_ip == address) &&
+          (!ifindex || (nextHops[i]->m_ifindex == ifindex))) {
+         return nextHops[i];
+      }
+   }
+   return NULL;
+}
+
+NxL3NextHop* 
+NxL3RouteImpl::addL3DirectNextHop(const nxos::NxIpAddr& nextHopAddr, const std::string& intfName, uint8_t preference)
+{
+   NxL3NextHopImpl *nh;
+
+   if (intfName.empty() || (nextHopAddr.af != m_prefix.ip.af)) return NULL;
+
+   unshareL3NextHops();
+   nh = (NxL3NextHopImpl *)getL3NextHop(nextHopAddr, intfName);
+   if (nh) {
+      nh->m_preference = preference;
+      return nh;
+   }
+   nh = new NxL3NextHopImpl(nextHopAddr, intfName, m_vrfName, preference,
+                            NxL3NextHop::DIRECT);
+   m_nextHops.push_back(nh);
+   return nh;
+}
+
+NxL3NextHop* 
+NxL3RouteImpl::addL3RecursiveNextHop(const nxos::NxIpAddr& nextHopAddr, uint8_t preference)
+{
+   NxL3NextHopImpl *nh;
+
+   if (nextHopAddr.af != m_prefix.ip.af) return NULL;
+
+   unshareL3NextHops();
+   for (size_t i = 0; i < m_nextHops.size(); i++) {
+      nh = m_nextHops[i];
+      if ((nh->m_type == NxL3NextHop::RECURSIVE) &&
+          (nh->m_ip == nextHopAddr)) {
+         nh->m_preference = preference;
+         return nh;
+      }
+   }
+   nh = new NxL3NextHopImpl(nextHopAddr, "", m_vrfName, preference,
+                            NxL3NextHop::RECURSIVE);
+   m_nextHops.push_back(nh);
+   return nh;
+}
+
+bool 
+NxL3RouteImpl::delL3NextHop(const nxos::NxIpAddr& nextHopAddr, const std::string& intfName)
+{
+   uint32_t ifindex = NxIntfDict::get().ifindex(intfName, false);
+
+   if (!getL3NextHop(nextHopAddr, intfName)) return false;
+
+   unshareL3NextHops();
+   for (size_t i = 0; i < m_nextHops.size(); i++) {
+      if ((m_nextHops[i]->m_ip == nextHopAddr) &&
+          (!ifindex || (m_nextHops[i]->m_ifindex == ifindex))) {
+         delete m_nextHops[i];
+         m_nextHops.erase(m_nextHops.begin() + i);
+         m_nhCursor = 0;
+         return true;
+      }
+   }
+   return false;
+}
+
+uint32_t 
+NxL3RouteImpl::getL3NextHopGroupId()
+{
+   return m_nhGroup ? m_nhGroup->m_id : 0;
+}
+
+unsigned int 
+NxL3RouteImpl::getL3NextHops(NxL3NextHop** nextHops, unsigned int maxCount)
+{
+   return nxCopyL3NextHops(l3NextHops(), nextHops, maxCount);
 }
     
 // Implementation for class  
 NxRibMgrImpl::NxRibMgrImpl()
+   : m_handler(NULL), m_batchId(0), m_commitCount(0), m_batchMaxRoutes(0),
+     m_batchMaxDelayMs(0), m_batchStartMs(0), m_msgVrfId(0), m_msgOwnerId(0),
+     m_msgRoute(NULL),
+     m_snapIntervalSec(0), m_snapDirty(false), m_snapSavedMs(0), m_asyncId(0),
+     m_asyncMaxReqs(64), m_asyncMaxRoutes(0), m_asyncRoutes(0),
+     m_asyncBusy(false), m_paceMaxRate(0), m_paceMinRate(0), m_paceTargetUs(0),
+     m_paceRate(0), m_paceTokens(0), m_paceRefillUs(0)
 {
-
+   memset(&m_paceStats, 0, sizeof(m_paceStats));
 }
 
 NxRibMgrImpl::~NxRibMgrImpl()
 {
+   NxMyL3RouteVrfTbl::iterator    vit;
+   NxL3RouteVrfTbl::iterator      wit;
+   NxL3RouteTbl::iterator         rit;
+   NxL3RouteCacheVrfTbl::iterator cit;
+
+   // No callbacks while tearing down.
+   m_handler = NULL;
+   delete m_msgRoute;
+   // Route copies of the App outlive the mgr, freed by the App.
+   for (std::set<NxL3RouteImpl *>::iterator it = m_routeObjs.begin();
+        it != m_routeObjs.end(); ++it) {
+      (*it)->m_ribMgr = NULL;
+   }
+   for (size_t i = 0; i < m_routeBatch.size(); i++) {
+      delete m_routeBatch[i];
+   }
+   for (size_t i = 0; i < m_asyncReqs.size(); i++) {
+      for (size_t s = 0; s < m_asyncReqs[i]->sends.size(); s++) {
+         const NxL3RouteAsyncSend& send = m_asyncReqs[i]->sends[s];
+
+         for (size_t d = 0; d < send.dels.size(); d++) delete send.dels[d];
+      }
+      delete m_asyncReqs[i];
+   }
+   for (int af = AF_START; af < MAX_AF; af++) {
+      for (vit = m_myRoutes[af].begin(); vit != m_myRoutes[af].end(); ++vit) {
+         for (rit = vit->second.routes.begin();
+              rit != vit->second.routes.end(); ++rit) {
+            delete rit->second;
+         }
+      }
+      for (wit = m_ribRoutes[af].begin(); wit != m_ribRoutes[af].end();
+           ++wit) {
+         for (rit = wit->second.begin(); rit != wit->second.end(); ++rit) {
+            delete rit->second;
+         }
+      }
+      for (cit = m_routeCache[af].begin(); cit != m_routeCache[af].end();
+           ++cit) {
+         delete cit->second;
+      }
+   }
+
+   // Groups still used by route copies of the App go with the last one.
+   for (size_t i = 0; i < m_nhGroups.size(); i++) {
+      if (m_nhGroups[i]) m_nhGroups[i]->m_ribMgr = NULL;
+   }
+   for (size_t i = 0; i < m_watches.size(); i++) {
+      delete m_watches[i].matcher;
+   }
+}
+
+NxRibMgrImpl::NxL3RouteCache::NxL3RouteCache(nxos::af_e af)
+   : lpm((af == AF_IPV4) ? 32 : 128, (af == AF_IPV4) ? 8 : 4), routes(1, NULL)
+{
+
+}
+
+NxRibMgrImpl::NxL3RouteCache::~NxL3RouteCache()
+{
+
+}
+
+bool
+NxRibMgrImpl::validVrfName(const std::string& vrfName)
+{
+   return !vrfName.empty() && (vrfName != "all");
+}
+
+void
+NxRibMgrImpl::notifyMyL3Route(NxL3RouteImpl* route, nxos::event_type_e event)
+{
+   if (m_handler && m_handlerFilter.wants(NxRibMgrHandler::EVENT_MY_L3_ROUTE)) {
+      route->m_event = event;
+      m_handler->postMyL3RouteCb(route);
+      route->m_event = NO_EVENT;
+   }
+   trackL3RouteRnhs(route, event != DELETE);
+}
+
+/*
+ * Commit all pending operations of the table to RIB in one transaction.
+ */
+void
+NxRibMgrImpl::commitMyL3Routes(NxMyL3RouteTbl& tbl)
+{
+   std::set<NxPrefix>::iterator     it;
+   NxL3RouteTbl::iterator           rit;
 
+   for (it = tbl.pendingDel.begin(); it != tbl.pendingDel.end(); ++it) {
+      rit = tbl.routes.find(*it);
+      if (rit == tbl.routes.end()) continue;
+      notifyMyL3Route(rit->second, DELETE);
+      delete rit->second;
+      tbl.routes.erase(rit);
+   }
+   for (it = tbl.pendingAdd.begin(); it != tbl.pendingAdd.end(); ++it) {
+      rit = tbl.routes.find(*it);
+      if (rit != tbl.routes.end()) notifyMyL3Route(rit->second, ADD);
+   }
+   tbl.pendingDel.clear();
+   tbl.pendingAdd.clear();
+   m_commitCount++;
+   m_snapDirty = true;
+}
+
+NxRibMgrImpl::NxL3RouteCache*
+NxRibMgrImpl::getL3RouteCache(nxos::af_e af, const std::string& vrfName)
+{
+   NxL3RouteCacheVrfTbl::iterator cit;
+
+   if (af >= MAX_AF) return NULL;
+
+   cit = m_routeCache[af].find(vrfName);
+   return (cit == m_routeCache[af].end()) ? NULL : cit->second;
+}
+
+/*
+ * Index route under prefix in the cache of its VRF & AF, if any. NULL
+ * route removes prefix.
+ */
+void
+NxRibMgrImpl::updateL3RouteCache(const NxPrefix& prefix,
+                                 const std::string& vrfName,
+                                 NxL3RouteImpl* route)
+{
+   NxL3RouteCache *cache = getL3RouteCache((af_e)prefix.ip.af, vrfName);
+   uint32_t        id;
+
+   if (!cache) return;
+
+   id = cache->lpm.find(prefix.ip.addr, prefix.maskLen);
+   if (!route) {
+      if (!id) return;
+      cache->lpm.remove(prefix.ip.addr, prefix.maskLen);
+      cache->routes[id] = NULL;
+      cache->freeIds.push_back(id);
+      return;
+   }
+
+   if (!id) {
+      if (!cache->freeIds.empty()) {
+         id = cache->freeIds.back();
+         cache->freeIds.pop_back();
+      } else {
+         id = cache->routes.size();
+         cache->routes.push_back(NULL);
+      }
+      cache->lpm.insert(prefix.ip.addr, prefix.maskLen, id);
+   }
+   cache->routes[id] = route;
+}
+
+/*
+ * Apply a route update to the table of watched routes. Returns false if
+ * the update only refreshes a route restored from the snapshot & is not
+ * to be delivered. A route in the table is updated in place, only an
+ * added route is allocated.
+ */
+bool
+NxRibMgrImpl::updateL3RouteTbl(NxL3RouteImpl* route)
+{
+   const NxPrefix&           prefix = route->m_prefix;
+   NxL3RouteTbl&             tbl    = m_ribRoutes[prefix.ip.af][route->m_vrfName];
+   NxL3RouteTbl::iterator    rit    = tbl.find(prefix);
+   NxL3RouteImpl            *old    = (rit == tbl.end()) ? NULL : rit->second;
+   NxL3RouteImpl            *cur    = NULL;
+   bool                      nhChanged = true;
+
+   if (old && old->m_stale) {
+      old->m_stale = false;
+      if ((route->m_event != DELETE) && (old->m_nhGroup == route->m_nhGroup) &&
+          old->m_nextHops.empty() && route->m_nextHops.empty()) {
+         return false;
+      }
+   }
+   m_snapDirty = true;
+   if (old) delL3RouteStats(old);
+   if (route->m_event == DELETE) {
+      if (!old) return true;
+      tbl.erase(rit);
+   } else if (old) {
+      cur       = old;
+      nhChanged = (cur->m_nhGroup != route->m_nhGroup);
+      cur->copyL3NextHops(*route);
+      addL3RouteStats(cur, cur);
+   } else {
+      cur = new NxL3RouteImpl(*route);
+      cur->m_event = NO_EVENT;
+      addL3RouteStats(cur, NULL);
+      tbl.insert(std::make_pair(prefix, cur));
+   }
+   updateL3RouteCache(prefix, route->m_vrfName, cur);
+   updateL3RouteRnhs(prefix, route->m_vrfName,
+                     !old ? ADD : (cur ? UPDATE : DELETE), nhChanged);
+   if (old != cur) delete old;
+   return true;
+}
+
+/* Group of the sorted nextHops of hash, NULL if none. */
+NxL3NextHopGroupImpl*
+NxRibMgrImpl::findL3NextHopGroup(const std::vector<NxL3NextHopImpl *>& nextHops,
+                                 uint64_t hash)
+{
+   std::pair<NxL3NextHopGroupIdx::iterator, NxL3NextHopGroupIdx::iterator>
+      range = m_nhGroupIdx.equal_range(hash);
+
+   for (NxL3NextHopGroupIdx::iterator it = range.first; it != range.second;
+        ++it) {
+      if (nxSameL3NextHops(it->second->m_nextHops, nextHops)) {
+         return it->second;
+      }
+   }
+   return NULL;
+}
+
+/*
+ * Decode the next-hops of msg into m_msgNextHops, reused from message to
+ * message, & return the group that has them. Only the next-hops of a
+ * group yet to be created are allocated, by the caller. The VRF & owner
+ * are kept as ids, named on access.
+ */
+NxL3NextHopGroupImpl*
+NxRibMgrImpl::decodeL3NextHops(const NxL3RouteMsg& msg)
+{
+   // Most messages have the VRF & owner of the last one.
+   if (m_msgVrfName != msg.vrfName) {
+      m_msgVrfName.assign(msg.vrfName);
+      m_msgVrfId = nxRibNameId(m_msgVrfName);
+   }
+   m_msgName.assign(msg.protocol);
+   if (msg.tag[0]) m_msgName.append("-").append(msg.tag);
+   if (m_msgName != m_msgOwner) {
+      m_msgOwner.swap(m_msgName);
+      m_msgOwnerId = nxRibNameId(m_msgOwner);
+   }
+
+   if (m_msgNextHops.size() < msg.nhCount) m_msgNextHops.resize(msg.nhCount);
+   m_msgNhOrder.resize(msg.nhCount);
+   for (unsigned int i = 0; i < msg.nhCount; i++) {
+      const NxL3RouteMsgNh& rec = msg.nextHops[i];
+      NxL3NextHopImpl&      nh  = m_msgNextHops[i];
+
+      nh.m_ip         = rec.ip;
+      nh.m_ifindex    = NxIntfDict::get().ifindex(rec.intfName);
+      nh.m_vrfId      = m_msgVrfId;
+      nh.m_ownerId    = m_msgOwnerId;
+      nh.m_preference = rec.preference;
+      nh.m_metric     = rec.metric;
+      nh.m_type       = rec.type;
+      m_msgNhOrder[i] = &nh;
+   }
+   std::sort(m_msgNhOrder.begin(), m_msgNhOrder.end(),
+             NxL3NextHopImpl::lessThan);
+   return findL3NextHopGroup(m_msgNhOrder, nxHashL3NextHops(m_msgNhOrder));
+}
+
+/*
+ * Move the next-hops of route into the group of the same next-hops,
+ * creating the group if it is the first route using them.
+ */
+void
+NxRibMgrImpl::internL3NextHops(NxL3RouteImpl* route)
+{
+   std::vector<NxL3NextHopImpl *>& nextHops = route->m_nextHops;
+   NxL3NextHopGroupImpl           *group;
+   uint64_t                        hash;
+   uint32_t                        id;
+
+   if (route->m_nhGroup || nextHops.empty()) return;
+
+   std::sort(nextHops.begin(), nextHops.end(), NxL3NextHopImpl::lessThan);
+   hash = nxHashL3NextHops(nextHops);
+
+   if ((group = findL3NextHopGroup(nextHops, hash))) {
+      route->clearL3NextHops();
+      route->setL3NextHopGroup(group);
+      return;
+   }
+
+   if (!m_nhGroupFreeIds.empty()) {
+      id = m_nhGroupFreeIds.back();
+      m_nhGroupFreeIds.pop_back();
+   } else {
+      // Id 0 is reserved for no group.
+      if (m_nhGroups.empty()) m_nhGroups.push_back(NULL);
+      id = m_nhGroups.size();
+      m_nhGroups.push_back(NULL);
+   }
+   group = new NxL3NextHopGroupImpl(this, id);
+   group->m_hash = hash;
+   group->m_nextHops.swap(nextHops);
+   m_nhGroups[id] = group;
+   indexL3NextHopGroup(group, true);
+   route->setL3NextHopGroup(group);
+   notifyL3NextHopGroup(group, ADD);
+}
+
+void
+NxRibMgrImpl::indexL3NextHopGroup(NxL3NextHopGroupImpl* group, bool add)
+{
+   std::pair<NxL3NextHopGroupIdx::iterator, NxL3NextHopGroupIdx::iterator>
+      range;
+
+   if (add) {
+      m_nhGroupIdx.insert(std::make_pair(group->m_hash, group));
+      return;
+   }
+   range = m_nhGroupIdx.equal_range(group->m_hash);
+   for (NxL3NextHopGroupIdx::iterator it = range.first; it != range.second;
+        ++it) {
+      if (it->second == group) {
+         m_nhGroupIdx.erase(it);
+         return;
+      }
+   }
+}
+
+void
+NxRibMgrImpl::notifyL3NextHopGroup(NxL3NextHopGroupImpl* group,
+                                   nxos::event_type_e event)
+{
+   if (!m_handler ||
+       !m_handlerFilter.wants(NxRibMgrHandler::EVENT_L3_NEXT_HOP_GROUP)) {
+      return;
+   }
+
+   group->m_event    = event;
+   group->m_nhCursor = 0;
+   m_handler->postL3NextHopGroupCb(group);
+   group->m_event    = NO_EVENT;
+}
+
+void
+NxRibMgrImpl::releaseL3NextHopGroup(NxL3NextHopGroupImpl* group)
+{
+   if (--group->m_refCount) return;
+
+   notifyL3NextHopGroup(group, DELETE);
+   indexL3NextHopGroup(group, false);
+   m_nhGroups[group->m_id] = NULL;
+   m_nhGroupFreeIds.push_back(group->m_id);
+   delete group;
+}
+
+/*
+ * group lost next-hops & now has the ones of into. Its routes are moved
+ * to into & sent as route updates, group goes with its last route.
+ */
+void
+NxRibMgrImpl::mergeL3NextHopGroup(NxL3NextHopGroupImpl* group,
+                                  NxL3NextHopGroupImpl* into)
+{
+   std::map<NxL3RouteStatsEntry *, uint32_t>::iterator sit;
+   std::set<NxL3RouteImpl *>::iterator                 oit;
+   std::vector<NxL3RouteImpl *>                        moved;
+   NxL3RouteVrfTbl::iterator                           wit;
+   NxL3RouteTbl::iterator                              rit;
+   NxL3RouteImpl                                      *route;
+
+   for (sit = group->m_statsRefs.begin(); sit != group->m_statsRefs.end();
+        ++sit) {
+      into->m_statsRefs[sit->first] += sit->second;
+   }
+   group->m_statsRefs.clear();
+
+   // Held till all its routes are moved.
+   group->m_refCount++;
+   for (int af = AF_START; af < MAX_AF; af++) {
+      for (wit = m_ribRoutes[af].begin(); wit != m_ribRoutes[af].end();
+           ++wit) {
+         for (rit = wit->second.begin(); rit != wit->second.end(); ++rit) {
+            if (rit->second->m_nhGroup != group) continue;
+            rit->second->setL3NextHopGroup(into);
+            moved.push_back(rit->second);
+         }
+      }
+   }
+   for (oit = m_routeObjs.begin(); oit != m_routeObjs.end(); ++oit) {
+      if ((*oit)->m_nhGroup == group) (*oit)->setL3NextHopGroup(into);
+   }
+   for (size_t i = 0; i < m_routeBatch.size(); i++) {
+      route = (NxL3RouteImpl *)m_routeBatch[i];
+      if (route->m_nhGroup == group) route->setL3NextHopGroup(into);
+   }
+
+   if (m_handler && m_handlerFilter.wants(NxRibMgrHandler::EVENT_L3_ROUTE)) {
+      for (size_t i = 0; i < moved.size(); i++) {
+         moved[i]->m_event = UPDATE;
+         m_handler->postL3RouteCb(moved[i]);
+         moved[i]->m_event = NO_EVENT;
+      }
+   }
+   releaseL3NextHopGroup(group);
+}
+
+void
+NxRibMgrImpl::postL3NextHopDown(const NxIpAddr& address,
+                                const std::string& intfName)
+{
+   NxL3NextHopGroupImpl *group, *same;
+   NxL3NextHopImpl      *nh;
+   bool                  changed;
+   size_t                oldCount;
+   uint32_t              ifindex = NxIntfDict::get().ifindex(intfName, false);
+
+   if (!intfName.empty() && !ifindex) return;
+   for (size_t id = 1; id < m_nhGroups.size(); id++) {
+      if (!(group = m_nhGroups[id])) continue;
+
+      changed  = false;
+      oldCount = group->m_nextHops.size();
+      for (size_t i = 0; i < group->m_nextHops.size(); ) {
+         nh = group->m_nextHops[i];
+         if ((nh->m_ip == address) &&
+             (!ifindex || (nh->m_ifindex == ifindex))) {
+            delete nh;
+            group->m_nextHops.erase(group->m_nextHops.begin() + i);
+            changed = true;
+         } else {
+            i++;
+         }
+      }
+      if (!changed) continue;
+
+      indexL3NextHopGroup(group, false);
+      group->m_hash = nxHashL3NextHops(group->m_nextHops);
+      updateL3GroupStats(group, oldCount);
+      if ((same = findL3NextHopGroup(group->m_nextHops, group->m_hash))) {
+         // One group per set of next-hops, the routes move to the other.
+         updateL3GroupRnhs(group);
+         mergeL3NextHopGroup(group, same);
+         continue;
+      }
+
+      // Keeps its Id, all the routes using it see the new next-hops.
+      indexL3NextHopGroup(group, true);
+      notifyL3NextHopGroup(group, UPDATE);
+      updateL3GroupRnhs(group);
+   }
+}
+
+NxL3RouteImpl*
+NxRibMgrImpl::lookupL3RouteCache(const NxIpAddr& address,
+                                 const std::string& vrfName)
+{
+   NxL3RouteCache *cache = getL3RouteCache((af_e)address.af, vrfName);
+
+   if (!cache) return NULL;
+   return cache->routes[cache->lpm.lookup(address.addr)];
+}
+
+void
+NxRibMgrImpl::postL3RouteEvent(NxL3RouteImpl* route)
+{
+   if (!deliverL3RouteEvent(route)) delete route;
+}
+
+/*
+ * Apply route to the table & deliver it. Returns true if route was queued
+ * to the batch, which then owns it.
+ */
+bool
+NxRibMgrImpl::deliverL3RouteEvent(NxL3RouteImpl* route)
+{
+   if (route->m_event != DELETE) internL3NextHops(route);
+   if (!updateL3RouteTbl(route) || !m_handler ||
+       !m_handlerFilter.wants(NxRibMgrHandler::EVENT_L3_ROUTE)) {
+      return false;
+   }
+   if (m_batchMaxRoutes <= 1) {
+      m_handler->postL3RouteCb(route);
+      return false;
+   }
+
+   if (m_routeBatch.empty()) m_batchStartMs = nxRibNowMs();
+   m_routeBatch.push_back(route);
+   if (m_routeBatch.size() >= m_batchMaxRoutes) {
+      flushL3RouteBatch();
+   } else {
+      pollL3RouteBatch();
+   }
+   return true;
+}
+
+void
+NxRibMgrImpl::pollL3RouteBatch()
+{
+   if (!m_routeBatch.empty() &&
+       (nxRibNowMs() - m_batchStartMs >= m_batchMaxDelayMs)) {
+      flushL3RouteBatch();
+   }
+}
+
+void
+NxRibMgrImpl::flushL3RouteBatch()
+{
+   std::vector<NxL3Route *> batch;
+
+   if (m_routeBatch.empty()) return;
+
+   // Swap out first, the handler may cause more updates to be queued.
+   batch.swap(m_routeBatch);
+   if (m_handler) m_handler->postL3RouteBatchCb(batch);
+   for (size_t i = 0; i < batch.size(); i++) {
+      delete batch[i];
+   }
 }
 
 NxVrf* 
@@ -275,59 +1230,501 @@ NxRibMgrImpl::unwatchVrf(std::string vrfName)
 void 
 NxRibMgrImpl::setRibMgrHandler(NxRibMgrHandler* handler)
 {
-   return;
+   setRibMgrHandler(handler, NxRibMgrHandler::EVENT_ALL);
+}
+
+void 
+NxRibMgrImpl::setRibMgrHandler(NxRibMgrHandler* handler, uint32_t eventMask)
+{
+   flushL3RouteBatch();
+   m_handler = handler;
+   m_handlerFilter.setMask(eventMask);
+}
+
+uint64_t 
+NxRibMgrImpl::getSkippedEventCount(uint32_t events)
+{
+   return m_handlerFilter.skipped(events);
 }
 
 NxRibMgrHandler* 
 NxRibMgrImpl::getRibMgrHandler()
 {
-   return NULL;
+   return m_handler;
 }
 
 NxL3Route* 
 NxRibMgrImpl::getL3Route(std::string routeAddr, unsigned char maskLen, std::string vrfName, bool clearBuffer)
 {
-   return NULL;
+   NxPrefix prefix;
+
+   if (!nxL3ApiPrefix(routeAddr, maskLen, &prefix)) return NULL;
+   return getL3Route(prefix, vrfName, clearBuffer);
 }
 
 bool 
 NxRibMgrImpl::watchL3Route(std::string protocol, std::string tag, std::string vrfName, nxos::af_e af)
 {
-   return false;
+   return watchL3Route(protocol, tag, vrfName, af, NxL3RouteFilter());
 }
 
 void 
 NxRibMgrImpl::unwatchL3Route(std::string protocol, std::string tag, std::string vrfName, nxos::af_e af)
 {
-   return;
+   for (size_t i = 0; i < m_watches.size(); i++) {
+      NxL3RouteWatch& watch = m_watches[i];
+
+      if ((watch.protocol == protocol) && (watch.tag == tag) &&
+          (watch.vrfName == vrfName) && (watch.af == af)) {
+         delete watch.matcher;
+         m_watches.erase(m_watches.begin() + i);
+         return;
+      }
+   }
 }
 
 NxL3Route* 
 NxRibMgrImpl::getL3RouteDetail(const std::string& routeAddr, unsigned int maskLen, const std::string& vrfName)
 {
-   return NULL;
+   NxPrefix prefix;
+
+   if (!nxL3ApiPrefix(routeAddr, maskLen, &prefix)) return NULL;
+   return getL3RouteDetail(prefix, vrfName);
 }
 
 NxL3Route* 
 NxRibMgrImpl::addL3Route(const std::string& routeAddr, unsigned char maskLen, const std::string& vrfName)
 {
-   return NULL;
+   NxPrefix prefix;
+
+   if (!nxL3ApiPrefix(routeAddr, maskLen, &prefix)) return NULL;
+   return addL3Route(prefix, vrfName);
 }
 
 bool 
 NxRibMgrImpl::delL3Route(const std::string& routePrefix, unsigned char maskLen, const std::string& vrfName)
 {
-   return false;
+   NxPrefix prefix;
+
+   if (!nxL3ApiPrefix(routePrefix, maskLen, &prefix)) return false;
+   return delL3Route(prefix, vrfName);
 }
 
 bool 
 NxRibMgrImpl::sendMyL3RoutesToRib(nxos::af_e af)
 {
-   return false;
+   NxMyL3RouteVrfTbl::iterator vit;
+
+   if (af >= MAX_AF) return false;
+
+   completeL3RouteAsync(m_asyncReqs.size(), false);
+   for (vit = m_myRoutes[af].begin(); vit != m_myRoutes[af].end(); ++vit) {
+      if (vit->second.pendingAdd.empty() && vit->second.pendingDel.empty()) {
+         continue;
+      }
+      commitMyL3Routes(vit->second);
+   }
+   return true;
 }
 
 bool 
 NxRibMgrImpl::converged(nxos::af_e af, const std::string& vrfName)
 {
+   NxMyL3RouteVrfTbl::iterator  vit;
+   NxL3RouteTbl::iterator       rit;
+
+   if (af >= MAX_AF) return false;
+
+   // Routes restored from the snapshot & not repopulated are withdrawn.
+   for (vit = m_myRoutes[af].begin(); vit != m_myRoutes[af].end(); ++vit) {
+      if ((vrfName != "all") && (vit->first != vrfName)) continue;
+
+      NxMyL3RouteTbl& tbl = vit->second;
+      for (rit = tbl.routes.begin(); rit != tbl.routes.end();) {
+         if (!rit->second->m_stale) {
+            ++rit;
+            continue;
+         }
+         tbl.pendingAdd.erase(rit->first);
+         tbl.pendingDel.erase(rit->first);
+         notifyMyL3Route(rit->second, DELETE);
+         delete rit->second;
+         tbl.routes.erase(rit++);
+         m_snapDirty = true;
+      }
+   }
+   return true;
+}
+
+bool 
+NxRibMgrImpl::addL3Routes(const std::vector<nxos::nx_l3_route_rec>& routes, const std::string& vrfName, nxos::af_e af, std::vector<nxos::nx_l3_route_rec_err>* errs)
+{
+   NxPrefix                     key;
+   NxIpAddr                     nhAddr;
+   NxL3RouteImpl               *route;
+   NxL3RouteTbl::iterator       rit;
+   std::vector<NxL3RouteImpl *> batch;
+   std::string                  intfName;
+
+   if (errs) errs->clear();
+   if (!validVrfName(vrfName) || (af >= MAX_AF)) return false;
+
+   completeL3RouteAsync(m_asyncReqs.size(), false);
+   NxMyL3RouteTbl& tbl = m_myRoutes[af][vrfName];
+   m_batchId++;
+   for (size_t i = 0; i < routes.size(); i++) {
+      const nx_l3_route_rec& rec = routes[i];
+
+      intfName = nxRecStr(rec.intfName, sizeof(rec.intfName));
+      if (!nxL3ApiPrefix(nxRecStr(rec.address, sizeof(rec.address)),
+                         rec.maskLen, &key) || (key.ip.af != af) ||
+          !nhAddr.fromString(nxRecStr(rec.nextHopAddr,
+                                      sizeof(rec.nextHopAddr))) ||
+          (nhAddr.af != af)) {
+         if (errs) {
+            nx_l3_route_rec_err err = { (unsigned int)i, ERR_INVALID };
+            errs->push_back(err);
+         }
+         continue;
+      }
+
+      rit = tbl.routes.find(key);
+      if (rit != tbl.routes.end()) {
+         route = rit->second;
+      } else {
+         route = new NxL3RouteImpl(vrfName, key);
+         tbl.routes.insert(std::make_pair(key, route));
+      }
+
+      // First record of this prefix in the batch replaces its next-hops.
+      if (route->m_batchId != m_batchId) {
+         route->m_batchId = m_batchId;
+         route->m_stale   = false;
+         route->clearL3NextHops();
+         tbl.pendingAdd.erase(key);
+         tbl.pendingDel.erase(key);
+         batch.push_back(route);
+      }
+      if (intfName.empty()) {
+         route->addL3RecursiveNextHop(nhAddr, rec.preference);
+      } else {
+         route->addL3DirectNextHop(nhAddr, intfName, rec.preference);
+      }
+   }
+
+   if (batch.empty()) return routes.empty();
+
+   for (size_t i = 0; i < batch.size(); i++) {
+      notifyMyL3Route(batch[i], ADD);
+   }
+   m_commitCount++;
+   m_snapDirty = true;
+   return true;
+}
+
+bool 
+NxRibMgrImpl::delL3Routes(const std::vector<nxos::nx_l3_route_rec>& routes, const std::string& vrfName, nxos::af_e af, std::vector<nxos::nx_l3_route_rec_err>* errs)
+{
+   NxPrefix                     key;
+   NxL3RouteTbl::iterator       rit;
+   std::vector<NxL3RouteImpl *> batch;
+   std::set<NxPrefix>           deleted;
+
+   if (errs) errs->clear();
+   if (!validVrfName(vrfName) || (af >= MAX_AF)) return false;
+
+   completeL3RouteAsync(m_asyncReqs.size(), false);
+   NxMyL3RouteTbl& tbl = m_myRoutes[af][vrfName];
+   for (size_t i = 0; i < routes.size(); i++) {
+      const nx_l3_route_rec& rec = routes[i];
+      unsigned long          errCode = ERR_ESUCCESS;
+
+      if (!nxL3ApiPrefix(nxRecStr(rec.address, sizeof(rec.address)),
+                         rec.maskLen, &key) || (key.ip.af != af)) {
+         errCode = ERR_INVALID;
+      } else if (deleted.count(key)) {
+         // Another next-hop record of a prefix already in the batch.
+         continue;
+      } else if ((rit = tbl.routes.find(key)) == tbl.routes.end()) {
+         errCode = ERR_NOT_FOUND;
+      }
+      if (errCode != ERR_ESUCCESS) {
+         if (errs) {
+            nx_l3_route_rec_err err = { (unsigned int)i, errCode };
+            errs->push_back(err);
+         }
+         continue;
+      }
+      tbl.pendingAdd.erase(key);
+      tbl.pendingDel.erase(key);
+      deleted.insert(key);
+      batch.push_back(rit->second);
+      tbl.routes.erase(rit);
+   }
+
+   if (batch.empty()) return routes.empty();
+
+   for (size_t i = 0; i < batch.size(); i++) {
+      notifyMyL3Route(batch[i], DELETE);
+      delete batch[i];
+   }
+   m_commitCount++;
+   m_snapDirty = true;
+   return true;
+}
+
+bool 
+NxRibMgrImpl::enableL3RouteCache(nxos::af_e af, const std::string& vrfName, bool enable)
+{
+   NxL3RouteCache *cache;
+
+   if (!validVrfName(vrfName) || (af >= MAX_AF)) return false;
+
+   cache = getL3RouteCache(af, vrfName);
+   if (enable) {
+      if (cache) return true;
+
+      m_routeCache[af][vrfName] = new NxL3RouteCache(af);
+      NxL3RouteVrfTbl::iterator wit = m_ribRoutes[af].find(vrfName);
+      if (wit == m_ribRoutes[af].end()) return true;
+      for (NxL3RouteTbl::iterator rit = wit->second.begin();
+           rit != wit->second.end(); ++rit) {
+         updateL3RouteCache(rit->first, vrfName, rit->second);
+      }
+   } else if (cache) {
+      delete cache;
+      m_routeCache[af].erase(vrfName);
+   }
+   return true;
+}
+
+NxL3Route* 
+NxRibMgrImpl::lookupL3Route(const std::string& address, const std::string& vrfName)
+{
+   NxIpAddr ip;
+
+   if (!ip.fromString(address)) return NULL;
+   return lookupL3RouteCache(ip, vrfName);
+}
+
+bool 
+NxRibMgrImpl::setL3RouteBatch(unsigned int maxRoutes, unsigned int maxDelayMs)
+{
+   m_batchMaxRoutes  = maxRoutes;
+   m_batchMaxDelayMs = maxDelayMs;
+   if (maxRoutes <= 1) flushL3RouteBatch();
+   return true;
+}
+
+NxL3Route* 
+NxRibMgrImpl::getL3Route(const nxos::NxPrefix& prefix, const std::string& vrfName, bool clearBuffer)
+{
+   std::set<NxL3RouteImpl *>           freed;
+   std::set<NxL3RouteImpl *>::iterator it;
+   NxL3RouteImpl                      *route = NULL;
+
+   // The objects the App did not free, as set by clearBuffer.
+   if (clearBuffer) freed.swap(m_routeObjs);
+   for (it = freed.begin(); it != freed.end(); ++it) {
+      (*it)->m_ribMgr = NULL;
+      delete *it;
+   }
+
+   if ((prefix.maskLen == prefix.ip.addrBits()) &&
+       (route = lookupL3RouteCache(prefix.ip, vrfName))) {
+      route = new NxL3RouteImpl(*route);
+      route->m_ribMgr = this;
+      m_routeObjs.insert(route);
+   }
+   return route;
+}
+
+NxL3Route* 
+NxRibMgrImpl::getL3RouteDetail(const nxos::NxPrefix& prefix, const std::string& vrfName)
+{
+   return NULL;
+}
+
+NxL3Route* 
+NxRibMgrImpl::addL3Route(const nxos::NxPrefix& prefix, const std::string& vrfName)
+{
+   NxL3RouteImpl         *route;
+   NxL3RouteTbl::iterator rit;
+
+   if (!validVrfName(vrfName) || (prefix.ip.af >= MAX_AF)) return NULL;
+
+   NxMyL3RouteTbl& tbl = m_myRoutes[prefix.ip.af][vrfName];
+   rit = tbl.routes.find(prefix);
+   if (rit != tbl.routes.end()) {
+      route = rit->second;
+      if (route->m_stale) {
+         // Repopulated after a restart, next-hops are added again.
+         route->m_stale = false;
+         route->clearL3NextHops();
+      }
+   } else {
+      route = new NxL3RouteImpl(vrfName, prefix);
+      tbl.routes[prefix] = route;
+   }
+   tbl.pendingDel.erase(prefix);
+   tbl.pendingAdd.insert(prefix);
+   return route;
+}
+
+bool 
+NxRibMgrImpl::delL3Route(const nxos::NxPrefix& prefix, const std::string& vrfName)
+{
+   NxMyL3RouteVrfTbl::iterator vit;
+
+   if (!validVrfName(vrfName) || (prefix.ip.af >= MAX_AF)) return false;
+
+   vit = m_myRoutes[prefix.ip.af].find(vrfName);
+   if ((vit == m_myRoutes[prefix.ip.af].end()) ||
+       !vit->second.routes.count(prefix)) {
+      return false;
+   }
+   vit->second.pendingAdd.erase(prefix);
+   vit->second.pendingDel.insert(prefix);
+   return true;
+}
+
+NxL3Route* 
+NxRibMgrImpl::lookupL3Route(const nxos::NxIpAddr& address, const std::string& vrfName)
+{
+   return lookupL3RouteCache(address, vrfName);
+}
+
+NxL3NextHopGroup* 
+NxRibMgrImpl::getL3NextHopGroup(uint32_t groupId)
+{
+   return (groupId < m_nhGroups.size()) ? m_nhGroups[groupId] : NULL;
+}
+
+bool 
+NxRibMgrImpl::watchL3Route(const std::string& protocol, const std::string& tag, const std::string& vrfName, nxos::af_e af, const nxos::NxL3RouteFilter& filter)
+{
+   NxL3RouteWatch watch;
+
+   if (vrfName.empty() || !NxL3RouteMatcher::valid(filter)) return false;
+
+   unwatchL3Route(protocol, tag, vrfName, af);
+   watch.protocol = protocol;
+   watch.tag      = tag;
+   watch.vrfName  = vrfName;
+   watch.af       = af;
+   watch.matcher  = (filter.prefixRanges.empty() && filter.anyNextHop()) ?
+                    NULL : new NxL3RouteMatcher(filter);
+   m_watches.push_back(watch);
+
+   // RIB downloads the routes of the new watch.
+   for (int a = 0; a < MAX_AF; a++) {
+      if ((af == MAX_AF) || (af == a)) startL3RouteDownload((af_e)a, vrfName);
+   }
+   return true;
+}
+
+bool
+NxRibMgrImpl::matchL3RouteWatch(const NxL3RouteMsg& msg) const
+{
+   for (size_t i = 0; i < m_watches.size(); i++) {
+      const NxL3RouteWatch& watch = m_watches[i];
+
+      if ((watch.protocol != msg.protocol) ||
+          (!watch.tag.empty() && (watch.tag != msg.tag)) ||
+          ((watch.vrfName != "all") && (watch.vrfName != msg.vrfName)) ||
+          ((watch.af != MAX_AF) && (watch.af != msg.prefix.ip.af))) {
+         continue;
+      }
+      if (!watch.matcher || watch.matcher->match(msg)) return true;
+   }
    return false;
+}
+
+void
+NxRibMgrImpl::postL3RouteMsg(const NxL3RouteMsg& msg)
+{
+   NxL3RouteImpl            *route;
+   NxL3NextHopGroupImpl     *group;
+   NxL3RouteVrfTbl::iterator wit;
+   event_type_e              event = msg.event;
+
+   if (msg.prefix.ip.af >= MAX_AF) return;
+
+   if ((event == DELETE) || !matchL3RouteWatch(msg)) {
+      // Only a route the App has is deleted, others are dropped unbuilt.
+      wit = m_ribRoutes[msg.prefix.ip.af].find(msg.vrfName);
+      if ((wit == m_ribRoutes[msg.prefix.ip.af].end()) ||
+          !wit->second.count(msg.prefix)) {
+         return;
+      }
+      event = DELETE;
+   }
+   if (event == DOWNLOAD) {
+      NxRibConvergence& timing = m_downloads[msg.prefix.ip.af][msg.vrfName];
+
+      timing.lastRouteMs = nxRibNowMs();
+      if (!timing.routes++) {
+         timing.firstRouteMs = timing.lastRouteMs;
+         if (!timing.downloadStartMs) {
+            startL3RouteDownload((af_e)msg.prefix.ip.af, msg.vrfName);
+         }
+      }
+   }
+
+   // The event is reused unless it is kept by a batch (or) in use by a
+   // handler posting another route.
+   if ((route = m_msgRoute)) {
+      m_msgRoute = NULL;
+      route->m_vrfName.assign(msg.vrfName);
+      route->m_prefix = msg.prefix;
+      route->m_stats  = NULL;
+   } else {
+      route = new NxL3RouteImpl(msg.vrfName, msg.prefix);
+   }
+   if ((event != DELETE) && msg.nhCount) {
+      // Most updates reuse a group, their next-hops are never allocated.
+      if ((group = decodeL3NextHops(msg))) {
+         route->setL3NextHopGroup(group);
+      } else {
+         for (unsigned int i = 0; i < msg.nhCount; i++) {
+            route->m_nextHops.push_back(new NxL3NextHopImpl(*m_msgNhOrder[i]));
+         }
+      }
+   }
+   route->setEvent(event);
+   if (deliverL3RouteEvent(route)) return;
+
+   route->clearL3NextHops();
+   if (m_msgRoute) {
+      delete route;
+   } else {
+      m_msgRoute = route;
+   }
+}
+
+/*
+ * A download of the routes of vrfName is pending. One of a VRF started by
+ * the watch of all the VRFs has the start of that watch.
+ */
+void
+NxRibMgrImpl::startL3RouteDownload(nxos::af_e af, const std::string& vrfName)
+{
+   std::map<std::string, NxRibConvergence>::iterator it;
+   NxRibConvergence& timing = m_downloads[af][vrfName];
+
+   if (timing.downloadStartMs) return;
+
+   it = m_downloads[af].find("all");
+   timing.downloadStartMs = ((vrfName != "all") && (it != m_downloads[af].end())) ?
+                            it->second.downloadStartMs : nxRibNowMs();
+}
+
+void
+NxRibMgrImpl::notifyRibConverged(nxos::af_e af, const std::string& vrfName,
+                                 NxRibConvergence& timing, uint64_t now)
+{
+   timing.convergedMs = now;
+   if (m_handler && m_handlerFilter.wants(NxRibMgrHandler::EVENT_RIB_CONVERGED)) {
+      m_handler->postRibConvergedCb(af, vrfName, timing);
+   }
 }
\ No newline at end of file
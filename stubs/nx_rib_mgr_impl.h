@@ -9,13 +9,54 @@
 #ifndef __nx_rib_mgr_impl_H__
 #define __nx_rib_mgr_impl_H__
 
+#include <deque>
+#include <map>
+#include <set>
+#include <vector>
 #include "nx_rib_mgr.h" 
+#include "nx_lpm_table.h"
+#include "nx_route_filter.h"
+#include "nx_event_filter.h"
    
 using namespace nxos;
 
    
 namespace nxos {
 
+/*
+ * Parse the address & maskLen of the string APIs into prefix. maskLen 0
+ * picks a host route.
+ */
+bool nxL3ApiPrefix(const std::string &addr, unsigned int maskLen,
+                   NxPrefix *prefix);
+
+/* FNV-1a of data continuing from hash. */
+uint64_t nxRibHashBytes(uint64_t hash, const void *data, size_t len);
+
+/* Id of a next-hop VRF (or) owner name, interned for the process. 0 is
+ * "". */
+uint32_t nxRibNameId(const std::string &name);
+/* Name of id, valid for the process. */
+const std::string &nxRibName(uint32_t id);
+
+/* Monotonic clock in milliseconds. */
+uint64_t nxRibNowMs();
+
+/* Monotonic clock in microseconds. */
+uint64_t nxRibNowUs();
+
+class NxRibMgrImpl;
+class NxRibSnapReader;
+
+/*
+ * Statistics of the watched routes of an AF, VRF & owner. The ones of a
+ * VRF & owner point to the aggregates they add to.
+ */
+struct NxL3RouteStatsEntry {
+    NxL3RouteStats        stats;
+    NxL3RouteStatsEntry  *up[3];  // (vrf, all), (all, owner), (all, all)
+};
+
 class NxVrfImpl : public NxVrf {
 public:
     NxVrfImpl();
@@ -33,6 +74,9 @@ public:
 class NxL3NextHopImpl : public NxL3NextHop {
 public:
     NxL3NextHopImpl();
+    NxL3NextHopImpl(const NxIpAddr &address, const std::string &intfName,
+                    const std::string &vrfName, unsigned int preference,
+                    nh_types_e type);
     virtual ~NxL3NextHopImpl();
     std::string getAddress();
     std::string getOutInterface();
@@ -45,11 +89,66 @@ public:
     unsigned int getTunnelId();
     nxos::encap_type_e getEncapType();
     bool checkType(nh_types_e type);
+    nxos::NxIpAddr getIpAddr();
+    uint32_t getOutIfindex();
+
+    bool sameAs(const NxL3NextHopImpl &nh) const;
+    uint64_t hash(uint64_t seed) const;
+    static bool lessThan(const NxL3NextHopImpl *nh1, const NxL3NextHopImpl *nh2);
+
+private:
+    friend class NxL3RouteImpl;
+    friend class NxRibMgrImpl;
+    friend class NxRibSnapWriter;
+
+    nxos::NxIpAddr     m_ip;
+    uint32_t           m_ifindex;    // out interface, named by NxIntfDict
+    uint32_t           m_vrfId;      // named by nxRibName()
+    uint32_t           m_ownerId;    // named by nxRibName()
+    unsigned int       m_preference;
+    unsigned int       m_metric;
+    unsigned int       m_tag;
+    unsigned int       m_segmentId;
+    unsigned int       m_tunnelId;
+    nxos::encap_type_e m_encapType;
+    nh_types_e         m_type;
+};
+
+/*
+ * Interned set of next-hops shared by the watched routes. Next-hops are
+ * kept sorted so that the same set always hashes the same. Owned by
+ * NxRibMgrImpl and freed once the last route using it is gone.
+ */
+class NxL3NextHopGroupImpl : public NxL3NextHopGroup {
+public:
+    NxL3NextHopGroupImpl(NxRibMgrImpl *ribMgr, uint32_t id);
+    virtual ~NxL3NextHopGroupImpl();
+    uint32_t getId();
+    unsigned int getL3NextHopCount();
+    NxL3NextHop* getL3NextHop(bool fromFirst = false);
+    unsigned int getRouteCount();
+    nxos::event_type_e getEvent();
+    unsigned int getL3NextHops(NxL3NextHop **nextHops,unsigned int maxCount);
+
+private:
+    friend class NxL3RouteImpl;
+    friend class NxRibMgrImpl;
+
+    NxRibMgrImpl                  *m_ribMgr;  // NULL once the mgr is gone
+    uint32_t                       m_id;
+    uint32_t                       m_refCount;
+    uint64_t                       m_hash;
+    std::vector<NxL3NextHopImpl *> m_nextHops;
+    size_t                         m_nhCursor;
+    nxos::event_type_e             m_event;
+    std::map<NxL3RouteStatsEntry *, uint32_t> m_statsRefs;  // watched routes using it
 };
 
 class NxL3RouteImpl : public NxL3Route {
 public:
     NxL3RouteImpl();
+    NxL3RouteImpl(const std::string &vrfName, const NxPrefix &prefix);
+    NxL3RouteImpl(const NxL3RouteImpl &route);
     virtual ~NxL3RouteImpl();
     std::string getVrfName();
     std::string getAddress();
@@ -65,6 +164,39 @@ public:
     NxL3NextHop* addL3RecursiveNextHop(const std::string &nextHopAddr,uint8_t preference);
     bool delL3NextHop(const std::string &nexHopAddress,const std::string &intfName="");
     std::string getL3Prefix() const;
+    nxos::NxPrefix getPrefix() const;
+    NxL3NextHop* getL3NextHop(const nxos::NxIpAddr &address,const std::string &intfName="");
+    NxL3NextHop* addL3DirectNextHop(const nxos::NxIpAddr &nextHopAddr,const std::string &intfName,uint8_t preference);
+    NxL3NextHop* addL3RecursiveNextHop(const nxos::NxIpAddr &nextHopAddr,uint8_t preference);
+    bool delL3NextHop(const nxos::NxIpAddr &nextHopAddr,const std::string &intfName="");
+    uint32_t getL3NextHopGroupId();
+    unsigned int getL3NextHops(NxL3NextHop **nextHops,unsigned int maxCount);
+
+    void clearL3NextHops();
+    void setEvent(nxos::event_type_e event) { m_event = event; }
+
+private:
+    friend class NxRibMgrImpl;
+    friend class NxRibSnapWriter;
+
+    std::string                    m_vrfName;
+    nxos::NxPrefix                 m_prefix;
+    nxos::event_type_e             m_event;
+    std::vector<NxL3NextHopImpl *> m_nextHops;  // unused if m_nhGroup is set
+    NxL3NextHopGroupImpl          *m_nhGroup;
+    size_t                         m_nhCursor;
+    unsigned long                  m_batchId;
+    bool                           m_stale;  // loaded from the snapshot
+    NxL3RouteStatsEntry           *m_stats;  // watched route only
+    NxRibMgrImpl                  *m_ribMgr; // tracking the copy, NULL if none
+
+    const std::vector<NxL3NextHopImpl *> &l3NextHops() const {
+        return m_nhGroup ? m_nhGroup->m_nextHops : m_nextHops;
+    }
+    void setL3NextHopGroup(NxL3NextHopGroupImpl *group);
+    void copyL3NextHops(const NxL3RouteImpl &route);
+    void unshareL3NextHops();
+    NxL3RouteImpl &operator=(const NxL3RouteImpl &route);
 };
 
 class NxRibMgrImpl : public NxRibMgr {
@@ -84,6 +216,262 @@ public:
     bool delL3Route(const std::string &routePrefix,unsigned char maskLen =0,const std::string &vrfName ="default");
     bool sendMyL3RoutesToRib(nxos::af_e af=nxos::AF_IPV4);
     bool converged(nxos::af_e af=nxos::AF_IPV4,const std::string &vrfName="all");
+    bool addL3Routes(const std::vector<nxos::nx_l3_route_rec> &routes,const std::string &vrfName = "default",nxos::af_e af = nxos::AF_IPV4,std::vector<nxos::nx_l3_route_rec_err> *errs = NULL);
+    bool delL3Routes(const std::vector<nxos::nx_l3_route_rec> &routes,const std::string &vrfName = "default",nxos::af_e af = nxos::AF_IPV4,std::vector<nxos::nx_l3_route_rec_err> *errs = NULL);
+    bool enableL3RouteCache(nxos::af_e af = nxos::AF_IPV4,const std::string &vrfName = "default",bool enable = true);
+    NxL3Route* lookupL3Route(const std::string &address,const std::string &vrfName = "default");
+    bool setL3RouteBatch(unsigned int maxRoutes,unsigned int maxDelayMs = 100);
+    NxL3Route* getL3Route(const nxos::NxPrefix &prefix,const std::string &vrfName = "default",bool clearBuffer = false);
+    NxL3Route* getL3RouteDetail(const nxos::NxPrefix &prefix,const std::string &vrfName = "default");
+    NxL3Route* addL3Route(const nxos::NxPrefix &prefix,const std::string &vrfName = "default");
+    bool delL3Route(const nxos::NxPrefix &prefix,const std::string &vrfName = "default");
+    NxL3Route* lookupL3Route(const nxos::NxIpAddr &address,const std::string &vrfName = "default");
+    NxL3NextHopGroup* getL3NextHopGroup(uint32_t groupId);
+    bool enableL3RouteSnapshot(const std::string &path,unsigned int intervalSec = 60,bool enable = true);
+    bool saveL3RouteSnapshot();
+    bool watchL3Route(const std::string &protocol,const std::string &tag,const std::string &vrfName,nxos::af_e af,const nxos::NxL3RouteFilter &filter);
+    unsigned int getL3RecursiveNextHopRoutes(const nxos::NxPrefix &prefix,const std::string &vrfName = "default",std::vector<nxos::NxPrefix> *routes = NULL);
+    uint64_t addL3RoutesAsync(const std::vector<nxos::nx_l3_route_rec> &routes,const std::string &vrfName = "default",nxos::af_e af = nxos::AF_IPV4);
+    uint64_t delL3RoutesAsync(const std::vector<nxos::nx_l3_route_rec> &routes,const std::string &vrfName = "default",nxos::af_e af = nxos::AF_IPV4);
+    uint64_t sendMyL3RoutesToRibAsync(nxos::af_e af = nxos::AF_IPV4);
+    bool setL3RouteAsyncLimit(unsigned int maxRequests,unsigned int maxRoutes = 0);
+    unsigned int getL3RouteAsyncInFlight();
+    bool enableL3RoutePacing(unsigned int maxRate,unsigned int minRate = 0,unsigned int targetLatencyMs = 100,bool enable = true);
+    bool getL3RoutePacingStats(nxos::NxL3RoutePacingStats *stats);
+    bool getL3RouteStats(nxos::NxL3RouteStats *stats,nxos::af_e af = nxos::AF_IPV4,const std::string &vrfName = "all",const std::string &owner = "all");
+    unsigned int forEachMoreSpecific(const nxos::NxPrefix &prefix,NxL3RouteVisitor *visitor,const std::string &vrfName = "default",bool inclusive = true);
+    unsigned int forEachLessSpecific(const nxos::NxPrefix &prefix,NxL3RouteVisitor *visitor,const std::string &vrfName = "default",bool inclusive = true);
+    unsigned int forEachInRange(const nxos::NxIpAddr &first,const nxos::NxIpAddr &last,NxL3RouteVisitor *visitor,const std::string &vrfName = "default");
+    void setRibMgrHandler(NxRibMgrHandler *handler,uint32_t eventMask);
+    uint64_t getSkippedEventCount(uint32_t events = 0xffffffff);
+
+    /*
+     * Entry point of the route updates received for the watched routes.
+     * Takes ownership of route.
+     */
+    void postL3RouteEvent(NxL3RouteImpl *route);
+
+    /* Called from the event loop to deliver a batch that is due. */
+    void pollL3RouteBatch();
+
+    /*
+     * Entry point of a next-hop going down, updates the groups using it.
+     * A group left with the next-hops of another group is merged into
+     * it. A group left with none is kept for its routes till RIB updates
+     * (or) withdraws them, the routes left without next-hops share one.
+     */
+    void postL3NextHopDown(const NxIpAddr &address,
+                           const std::string &intfName = "");
+
+    /*
+     * Route update from RIB, filtered by the watches before the route is
+     * built & posted.
+     */
+    void postL3RouteMsg(const NxL3RouteMsg &msg);
+
+    /* End of a route download from RIB, deletes the stale routes left. */
+    void postL3RouteDownloadDone(nxos::af_e af,
+                                 const std::string &vrfName = "all");
+
+    /* Called from the event loop to save the snapshot when due. */
+    void pollL3RouteSnapshot();
+
+    /*
+     * Called from the event loop as RIB acknowledges the async requests,
+     * completes the oldest maxRequests of them, 0 for all outstanding.
+     * When paced, only as many as the install rate allows.
+     */
+    void pollL3RouteAsync(unsigned int maxRequests = 0);
+
+    /* Output of the auto-generated "show <app> nxsdk rib-stats". */
+    std::string showL3RouteStats();
+
+    /* Drop a route reference to group, frees it on the last one. */
+    void releaseL3NextHopGroup(NxL3NextHopGroupImpl *group);
+
+    /* Stop tracking a getL3Route() copy freed by the App. */
+    void untrackL3Route(NxL3RouteImpl *route) { m_routeObjs.erase(route); }
+
+private:
+    typedef std::map<NxPrefix, NxL3RouteImpl *> NxL3RouteTbl;
+
+    /* Routes added by the App in a VRF & AF, pending till committed. */
+    struct NxMyL3RouteTbl {
+        NxL3RouteTbl           routes;
+        std::set<NxPrefix>     pendingAdd;
+        std::set<NxPrefix>     pendingDel;
+    };
+    typedef std::map<std::string, NxMyL3RouteTbl> NxMyL3RouteVrfTbl;
+
+    /* Watched routes of a VRF & AF as last received from RIB. */
+    typedef std::map<std::string, NxL3RouteTbl> NxL3RouteVrfTbl;
+    typedef std::multimap<uint64_t, NxL3NextHopGroupImpl *> NxL3NextHopGroupIdx;
+
+    /* Local LPM index of the watched routes of a VRF & AF. */
+    struct NxL3RouteCache {
+        NxLpmTable                   lpm;
+        std::vector<NxL3RouteImpl *> routes;   // indexed by lpm value, not owned
+        std::vector<uint32_t>        freeIds;
+
+        NxL3RouteCache(nxos::af_e af);
+        ~NxL3RouteCache();
+    };
+    typedef std::map<std::string, NxL3RouteCache *> NxL3RouteCacheVrfTbl;
+
+    /* Recursive next-hop of the App routes & the watched route it
+     * resolves through. */
+    struct NxL3Rnh {
+        bool                   resolved;
+        NxPrefix               resolvedBy;
+        std::set<NxPrefix>     routes;      // App routes using it
+    };
+
+    /* Recursive next-hop dependency index of a VRF & AF. */
+    struct NxL3RnhTbl {
+        std::map<NxIpAddr, NxL3Rnh>                rnhs;
+        std::map<NxPrefix, std::set<NxIpAddr> >    dependents;  // by resolving prefix
+        std::map<NxPrefix, std::vector<NxIpAddr> > routeRnhs;   // by App route
+        uint32_t                                   lenCount[129];  // watched routes per maskLen
+    };
+    typedef std::map<std::string, NxL3RnhTbl> NxL3RnhVrfTbl;
+
+    /* Route statistics of an AF by VRF & owner, "all" for aggregates. */
+    typedef std::map<std::pair<std::string, std::string>,
+                     NxL3RouteStatsEntry> NxL3RouteStatsTbl;
+
+    /* watchL3Route() registration, NULL matcher passes all the routes. */
+    struct NxL3RouteWatch {
+        std::string                  protocol;
+        std::string                  tag;
+        std::string                  vrfName;
+        nxos::af_e                   af;
+        NxL3RouteMatcher            *matcher;
+    };
+
+    /* Pending operations of a VRF taken by sendMyL3RoutesToRibAsync(). */
+    struct NxL3RouteAsyncSend {
+        std::string                   vrfName;
+        std::set<NxPrefix>            adds;
+        std::vector<NxL3RouteImpl *>  dels;   // out of the table, owned
+    };
+
+    /* Outstanding async request, op is ADD, DELETE (or) UPDATE for a
+     * send. */
+    struct NxL3RouteAsyncReq {
+        uint64_t                            id;
+        nxos::event_type_e                  op;
+        std::string                         vrfName;
+        nxos::af_e                          af;
+        std::vector<nxos::nx_l3_route_rec>  routes;
+        std::vector<NxL3RouteAsyncSend>     sends;
+        size_t                              count;  // records (or) routes
+        bool                                urgent;  // paced withdrawal
+
+        NxL3RouteAsyncReq()
+            : id(0), op(nxos::NO_EVENT), af(nxos::AF_IPV4), count(0),
+              urgent(false) {}
+    };
+
+    static bool validVrfName(const std::string &vrfName);
+    void notifyMyL3Route(NxL3RouteImpl *route, nxos::event_type_e event);
+    void commitMyL3Routes(NxMyL3RouteTbl &tbl);
+    NxL3RouteCache *getL3RouteCache(nxos::af_e af, const std::string &vrfName);
+    bool deliverL3RouteEvent(NxL3RouteImpl *route);
+    bool updateL3RouteTbl(NxL3RouteImpl *route);
+    void updateL3RouteCache(const NxPrefix &prefix, const std::string &vrfName,
+                            NxL3RouteImpl *route);
+    NxL3RouteImpl *lookupL3RouteCache(const NxIpAddr &address,
+                                      const std::string &vrfName);
+    void flushL3RouteBatch();
+    NxL3NextHopGroupImpl *findL3NextHopGroup(
+                             const std::vector<NxL3NextHopImpl *> &nextHops,
+                             uint64_t hash);
+    NxL3NextHopGroupImpl *decodeL3NextHops(const NxL3RouteMsg &msg);
+    void internL3NextHops(NxL3RouteImpl *route);
+    void indexL3NextHopGroup(NxL3NextHopGroupImpl *group, bool add);
+    void mergeL3NextHopGroup(NxL3NextHopGroupImpl *group,
+                             NxL3NextHopGroupImpl *into);
+    void notifyL3NextHopGroup(NxL3NextHopGroupImpl *group,
+                              nxos::event_type_e event);
+    bool loadL3RouteSnapshot();
+    bool matchL3RouteWatch(const NxL3RouteMsg &msg) const;
+    NxL3RnhTbl *getL3RnhTbl(nxos::af_e af, const std::string &vrfName,
+                            bool create);
+    bool resolveL3Rnh(const NxL3RnhTbl &tbl, nxos::af_e af,
+                      const std::string &vrfName, const NxIpAddr &address,
+                      NxPrefix *resolvedBy);
+    void setL3RnhResolution(NxL3RnhTbl &tbl, const NxIpAddr &address,
+                            NxL3Rnh &rnh, const NxPrefix *resolvedBy,
+                            std::set<NxPrefix> *notify);
+    void trackL3RouteRnhs(NxL3RouteImpl *route, bool add);
+    void updateL3RouteRnhs(const NxPrefix &prefix, const std::string &vrfName,
+                           nxos::event_type_e event, bool nhChanged);
+    void updateL3GroupRnhs(NxL3NextHopGroupImpl *group);
+    void notifyL3Rnhs(nxos::af_e af, const std::string &vrfName,
+                      NxL3RnhTbl &tbl, const std::set<NxPrefix> &routes);
+    void loadL3NextHops(const NxRibSnapReader &snap, uint32_t nhSet,
+                        NxL3RouteImpl *route);
+    bool hasL3RouteAsyncRoom(size_t count) const;
+    uint64_t queueL3RouteAsync(NxL3RouteAsyncReq *req);
+    NxL3RouteAsyncReq *takeMyL3RouteOps(nxos::af_e af, size_t count);
+    bool commitL3RouteAsyncSend(NxL3RouteAsyncReq *req);
+    void completeL3RouteAsync(size_t due, bool paced);
+    NxL3RouteStatsEntry *getL3RouteStatsEntry(nxos::af_e af,
+                                              const std::string &vrfName,
+                                              const std::string &owner);
+    void addL3RouteStats(NxL3RouteImpl *route, NxL3RouteImpl *old);
+    void delL3RouteStats(NxL3RouteImpl *route);
+    void updateL3GroupStats(NxL3NextHopGroupImpl *group, size_t oldCount);
+    void startL3RouteDownload(nxos::af_e af, const std::string &vrfName);
+    void notifyRibConverged(nxos::af_e af, const std::string &vrfName,
+                            NxRibConvergence &timing, uint64_t now);
+    void refillL3RoutePacing();
+    void updateL3RoutePacing(uint64_t latencyUs, bool failed);
+
+    NxRibMgrHandler   *m_handler;
+    NxEventFilter      m_handlerFilter;  // events of m_handler
+    NxMyL3RouteVrfTbl  m_myRoutes[nxos::MAX_AF];
+    NxL3RouteVrfTbl    m_ribRoutes[nxos::MAX_AF];
+    NxL3RouteCacheVrfTbl m_routeCache[nxos::MAX_AF];
+    unsigned long      m_batchId;
+    unsigned long      m_commitCount;
+    std::vector<NxL3Route *> m_routeBatch;
+    unsigned int       m_batchMaxRoutes;
+    unsigned int       m_batchMaxDelayMs;
+    uint64_t           m_batchStartMs;
+    std::vector<NxL3NextHopGroupImpl *> m_nhGroups;  // indexed by id
+    std::vector<NxL3NextHopImpl> m_msgNextHops;      // decodeL3NextHops()
+    std::vector<NxL3NextHopImpl *> m_msgNhOrder;
+    std::string        m_msgVrfName; // of the last message decoded,
+    std::string        m_msgOwner;   // with their ids
+    std::string        m_msgName;
+    uint32_t           m_msgVrfId;
+    uint32_t           m_msgOwnerId;
+    NxL3RouteImpl     *m_msgRoute;   // event of postL3RouteMsg(), reused
+    std::set<NxL3RouteImpl *> m_routeObjs;  // of getL3Route(), till clearBuffer
+    std::vector<uint32_t> m_nhGroupFreeIds;
+    NxL3NextHopGroupIdx m_nhGroupIdx;                // by next-hops hash
+    std::string        m_snapPath;
+    unsigned int       m_snapIntervalSec;
+    bool               m_snapDirty;
+    uint64_t           m_snapSavedMs;
+    std::vector<NxL3RouteWatch> m_watches;
+    NxL3RnhVrfTbl      m_rnhs[nxos::MAX_AF];
+    std::deque<NxL3RouteAsyncReq *> m_asyncReqs;  // oldest first
+    uint64_t           m_asyncId;
+    unsigned int       m_asyncMaxReqs;
+    unsigned int       m_asyncMaxRoutes;
+    size_t             m_asyncRoutes;   // count of m_asyncReqs
+    bool               m_asyncBusy;     // completing, no re-entry
+    unsigned int       m_paceMaxRate;   // 0: not paced
+    unsigned int       m_paceMinRate;
+    unsigned int       m_paceTargetUs;
+    double             m_paceRate;
+    double             m_paceTokens;
+    uint64_t           m_paceRefillUs;
+    NxL3RoutePacingStats m_paceStats;
+    NxL3RouteStatsTbl  m_routeStats[nxos::MAX_AF];
+    std::map<std::string, NxRibConvergence> m_downloads[nxos::MAX_AF];  // pending by VRF
 };
 }
 #endif // __nx_rib_mgr_impl_H__ 
\ No newline at end of file
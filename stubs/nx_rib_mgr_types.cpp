@@ -0,0 +1,281 @@
+/** **********************************************************************
+    * Binary address & prefix types of the NxRibMgr APIs.
+    *
+    * IPv4 text is converted by hand as it is the bulk of the routes,
+    * IPv6 goes through inet_pton/inet_ntop.
+    *
+    * Copyright (c) 2017 by cisco Systems, Inc.
+    *
+    * All rights reserved.
+************************************************************************/
+#include <arpa/inet.h>
+#include <cstring>
+#include "types/nx_rib_mgr.h"
+
+using namespace nxos;
+
+/* Dotted quad without leading zeros, same as inet_pton. */
+static bool
+nxIpv4Parse(const char *str, size_t len, unsigned char *addr)
+{
+   const char   *end = str + len;
+   unsigned int  val, digits;
+
+   for (int i = 0; i < 4; i++) {
+      if (i) {
+         if ((str == end) || (*str != '.')) return false;
+         str++;
+      }
+      val = digits = 0;
+      while ((str != end) && (*str >= '0') && (*str <= '9')) {
+         if (digits && !val) return false;
+         val = (val * 10) + (*str++ - '0');
+         if ((++digits > 3) || (val > 255)) return false;
+      }
+      if (!digits) return false;
+      addr[i] = (unsigned char)val;
+   }
+   return (str == end);
+}
+
+static size_t
+nxIpv4Format(const unsigned char *addr, char *buf)
+{
+   char *p = buf;
+
+   for (int i = 0; i < 4; i++) {
+      unsigned int val = addr[i];
+
+      if (i) *p++ = '.';
+      if (val >= 100) *p++ = '0' + (val / 100);
+      if (val >= 10)  *p++ = '0' + ((val / 10) % 10);
+      *p++ = '0' + (val % 10);
+   }
+   *p = '\0';
+   return (p - buf);
+}
+
+static bool
+nxIpAddrParse(const char *str, size_t len, NxIpAddr *ip)
+{
+   char buf[NX_IP_ADDR_STR_LEN];
+
+   memset(ip, 0, sizeof(*ip));
+   if (!memchr(str, ':', len)) {
+      ip->af = AF_IPV4;
+      return nxIpv4Parse(str, len, ip->addr);
+   }
+   if (len >= sizeof(buf)) return false;
+
+   memcpy(buf, str, len);
+   buf[len] = '\0';
+   ip->af = AF_IPV6;
+   return (inet_pton(AF_INET6, buf, ip->addr) == 1);
+}
+
+bool
+NxIpAddr::fromString(const char *str)
+{
+   return str && nxIpAddrParse(str, strlen(str), this);
+}
+
+bool
+NxIpAddr::fromString(const std::string &str)
+{
+   return nxIpAddrParse(str.data(), str.size(), this);
+}
+
+size_t
+NxIpAddr::toString(char *buf, size_t len) const
+{
+   char tmp[NX_IP_ADDR_STR_LEN];
+   size_t n;
+
+   if (af == AF_IPV4) {
+      n = nxIpv4Format(addr, tmp);
+   } else if ((af == AF_IPV6) && inet_ntop(AF_INET6, addr, tmp, sizeof(tmp))) {
+      n = strlen(tmp);
+   } else {
+      return 0;
+   }
+   if (n >= len) return 0;
+
+   memcpy(buf, tmp, n + 1);
+   return n;
+}
+
+std::string
+NxIpAddr::toString() const
+{
+   char buf[NX_IP_ADDR_STR_LEN];
+   size_t n = toString(buf, sizeof(buf));
+
+   return std::string(buf, n);
+}
+
+bool
+NxIpAddr::operator==(const NxIpAddr &ip) const
+{
+   return (af == ip.af) && !memcmp(addr, ip.addr, sizeof(addr));
+}
+
+bool
+NxIpAddr::operator<(const NxIpAddr &ip) const
+{
+   if (af != ip.af) return (af < ip.af);
+   return (memcmp(addr, ip.addr, sizeof(addr)) < 0);
+}
+
+bool
+NxPrefix::set(const NxIpAddr &addr, unsigned int len)
+{
+   unsigned int bits = addr.addrBits();
+
+   if (((addr.af != AF_IPV4) && (addr.af != AF_IPV6)) || (len > bits)) {
+      return false;
+   }
+
+   ip      = addr;
+   maskLen = len;
+   if (len % 8) ip.addr[len / 8] &= (uint8_t)(0xff << (8 - (len % 8)));
+   for (unsigned int i = (len + 7) / 8; i < bits / 8; i++) {
+      ip.addr[i] = 0;
+   }
+   return true;
+}
+
+static bool
+nxPrefixParse(const char *str, size_t len, NxPrefix *prefix)
+{
+   NxIpAddr     addr;
+   const char  *slash = (const char *)memchr(str, '/', len);
+   const char  *end   = str + len;
+   unsigned int maskLen = 0;
+
+   memset(prefix, 0, sizeof(*prefix));
+   if (!nxIpAddrParse(str, slash ? (size_t)(slash - str) : len, &addr)) {
+      return false;
+   }
+   if (!slash) return prefix->set(addr, addr.addrBits());
+
+   if ((slash + 1 == end) || (end - slash > 4)) return false;
+   for (const char *p = slash + 1; p != end; p++) {
+      if ((*p < '0') || (*p > '9')) return false;
+      maskLen = (maskLen * 10) + (*p - '0');
+   }
+   return prefix->set(addr, maskLen);
+}
+
+bool
+NxPrefix::fromString(const char *str)
+{
+   return str && nxPrefixParse(str, strlen(str), this);
+}
+
+bool
+NxPrefix::fromString(const std::string &str)
+{
+   return nxPrefixParse(str.data(), str.size(), this);
+}
+
+size_t
+NxPrefix::toString(char *buf, size_t len) const
+{
+   char   tmp[NX_IP_PREFIX_STR_LEN];
+   size_t n = ip.toString(tmp, NX_IP_ADDR_STR_LEN);
+
+   if (!n) return 0;
+
+   tmp[n++] = '/';
+   if (maskLen >= 100) tmp[n++] = '0' + (maskLen / 100);
+   if (maskLen >= 10)  tmp[n++] = '0' + ((maskLen / 10) % 10);
+   tmp[n++] = '0' + (maskLen % 10);
+   tmp[n]   = '\0';
+   if (n >= len) return 0;
+
+   memcpy(buf, tmp, n + 1);
+   return n;
+}
+
+std::string
+NxPrefix::toString() const
+{
+   char buf[NX_IP_PREFIX_STR_LEN];
+   size_t n = toString(buf, sizeof(buf));
+
+   return std::string(buf, n);
+}
+
+bool
+NxPrefix::contains(const NxIpAddr &addr) const
+{
+   unsigned int bytes = maskLen / 8, bits = maskLen % 8;
+
+   if ((addr.af != ip.af) || memcmp(addr.addr, ip.addr, bytes)) return false;
+   return !bits ||
+          !((addr.addr[bytes] ^ ip.addr[bytes]) & (uint8_t)(0xff << (8 - bits)));
+}
+
+bool
+NxPrefix::contains(const NxPrefix &prefix) const
+{
+   return (prefix.maskLen >= maskLen) && contains(prefix.ip);
+}
+
+bool
+NxPrefix::operator==(const NxPrefix &prefix) const
+{
+   return (maskLen == prefix.maskLen) && (ip == prefix.ip);
+}
+
+bool
+NxPrefix::operator<(const NxPrefix &prefix) const
+{
+   if (ip != prefix.ip) return (ip < prefix.ip);
+   return (maskLen < prefix.maskLen);
+}
+
+NxL3RouteFilter::NxL3RouteFilter()
+   : maxPreference(0xffffffff), maxMetric(0xffffffff)
+{
+
+}
+
+bool
+NxL3RouteFilter::addPrefixRange(const NxPrefix &prefix, unsigned int ge,
+                                unsigned int le)
+{
+   NxL3RoutePrefixRange range;
+   unsigned int         bits = prefix.ip.addrBits();
+
+   if (!ge && !le) {
+      ge = le = prefix.maskLen;
+   } else if (!le) {
+      le = bits;
+   } else if (!ge) {
+      ge = prefix.maskLen;
+   }
+   if ((ge < prefix.maskLen) || (ge > le) || (le > bits)) return false;
+
+   range.prefix = prefix;
+   range.ge     = ge;
+   range.le     = le;
+   prefixRanges.push_back(range);
+   return true;
+}
+
+bool
+NxL3RouteFilter::addPrefixRange(const std::string &prefix, unsigned int ge,
+                                unsigned int le)
+{
+   NxPrefix px;
+
+   return px.fromString(prefix) && addPrefixRange(px, ge, le);
+}
+
+bool
+NxL3RouteFilter::anyNextHop() const
+{
+   return nhIntfName.empty() && (maxPreference == 0xffffffff) &&
+          (maxMetric == 0xffffffff);
+}
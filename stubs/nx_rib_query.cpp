@@ -0,0 +1,103 @@
+/** **********************************************************************
+    * Prefix queries on the watched routes.
+    *
+    * The watched route table of a VRF is ordered by address then mask
+    * length, which is the pre-order of the prefix tree: the routes
+    * within a prefix are the contiguous run starting at the prefix
+    * itself. More-specific & range queries are a seek plus a walk,
+    * less-specific ones probe only the mask lengths in use.
+    *
+    * Copyright (c) 2017 by cisco Systems, Inc.
+    *
+    * All rights reserved.
+************************************************************************/
+#include "nx_rib_mgr_impl.h"
+
+using namespace std;
+using namespace nxos;
+
+unsigned int
+NxRibMgrImpl::forEachMoreSpecific(const nxos::NxPrefix& prefix, NxL3RouteVisitor* visitor, const std::string& vrfName, bool inclusive)
+{
+   NxL3RouteVrfTbl::iterator wit;
+   NxL3RouteTbl::iterator    rit;
+   NxPrefix                  start = prefix;
+   unsigned int              count = 0;
+
+   if (!visitor || (prefix.ip.af >= MAX_AF) ||
+       (prefix.maskLen > prefix.ip.addrBits())) {
+      return 0;
+   }
+   if ((wit = m_ribRoutes[prefix.ip.af].find(vrfName)) ==
+       m_ribRoutes[prefix.ip.af].end()) {
+      return 0;
+   }
+
+   if (!inclusive) start.maskLen++;
+   for (rit = wit->second.lower_bound(start);
+        (rit != wit->second.end()) && prefix.contains(rit->first); ++rit) {
+      count++;
+      if (!visitor->visit(rit->second)) break;
+   }
+   return count;
+}
+
+unsigned int
+NxRibMgrImpl::forEachLessSpecific(const nxos::NxPrefix& prefix, NxL3RouteVisitor* visitor, const std::string& vrfName, bool inclusive)
+{
+   NxL3RouteVrfTbl::iterator         wit;
+   NxL3RouteTbl::iterator            rit;
+   NxL3RouteStatsTbl::const_iterator sit;
+   NxPrefix                          probe;
+   unsigned int                      count = 0;
+
+   if (!visitor || (prefix.ip.af >= MAX_AF) ||
+       (prefix.maskLen > prefix.ip.addrBits())) {
+      return 0;
+   }
+   if ((wit = m_ribRoutes[prefix.ip.af].find(vrfName)) ==
+       m_ribRoutes[prefix.ip.af].end()) {
+      return 0;
+   }
+
+   // Mask lengths in use in the VRF, from the route statistics.
+   sit = m_routeStats[prefix.ip.af].find(make_pair(vrfName, string("all")));
+   if (sit == m_routeStats[prefix.ip.af].end()) return 0;
+
+   const uint32_t *maskLens = sit->second.stats.maskLens;
+
+   for (int len = inclusive ? prefix.maskLen : (int)prefix.maskLen - 1;
+        len >= 0; len--) {
+      if (!maskLens[len]) continue;
+
+      probe.set(prefix.ip, len);
+      if ((rit = wit->second.find(probe)) == wit->second.end()) continue;
+      count++;
+      if (!visitor->visit(rit->second)) break;
+   }
+   return count;
+}
+
+unsigned int
+NxRibMgrImpl::forEachInRange(const nxos::NxIpAddr& first, const nxos::NxIpAddr& last, NxL3RouteVisitor* visitor, const std::string& vrfName)
+{
+   NxL3RouteVrfTbl::iterator wit;
+   NxL3RouteTbl::iterator    rit;
+   NxPrefix                  start;
+   unsigned int              count = 0;
+
+   if (!visitor || (first.af >= MAX_AF) || (first.af != last.af)) return 0;
+   if ((wit = m_ribRoutes[first.af].find(vrfName)) ==
+       m_ribRoutes[first.af].end()) {
+      return 0;
+   }
+
+   start.ip      = first;
+   start.maskLen = 0;
+   for (rit = wit->second.lower_bound(start);
+        (rit != wit->second.end()) && !(last < rit->first.ip); ++rit) {
+      count++;
+      if (!visitor->visit(rit->second)) break;
+   }
+   return count;
+}
@@ -0,0 +1,309 @@
+/** **********************************************************************
+    * Recursive next-hop resolution of the App routes.
+    *
+    * Each recursive next-hop is resolved through the longest watched route
+    * covering it. The index keeps, per VRF & AF, the next-hops resolving
+    * through each watched prefix and the App routes using each next-hop,
+    * so a watched route change only re-resolves the next-hops under it &
+    * re-notifies the App routes depending on them.
+    *
+    * Copyright (c) 2017 by cisco Systems, Inc.
+    *
+    * All rights reserved.
+************************************************************************/
+#include <algorithm>
+#include <cstring>
+#include "nx_rib_mgr_impl.h"
+
+using namespace std;
+using namespace nxos;
+
+NxRibMgrImpl::NxL3RnhTbl*
+NxRibMgrImpl::getL3RnhTbl(nxos::af_e af, const std::string& vrfName,
+                          bool create)
+{
+   NxL3RnhVrfTbl::iterator   it = m_rnhs[af].find(vrfName);
+   NxL3RouteVrfTbl::iterator wit;
+   NxL3RnhTbl               *tbl;
+
+   if (it != m_rnhs[af].end()) return &it->second;
+   if (!create) return NULL;
+
+   tbl = &m_rnhs[af][vrfName];
+   memset(tbl->lenCount, 0, sizeof(tbl->lenCount));
+   wit = m_ribRoutes[af].find(vrfName);
+   if (wit != m_ribRoutes[af].end()) {
+      for (NxL3RouteTbl::iterator rit = wit->second.begin();
+           rit != wit->second.end(); ++rit) {
+         tbl->lenCount[rit->first.maskLen]++;
+      }
+   }
+   return tbl;
+}
+
+/*
+ * Longest watched route covering address. Only the mask lengths in use
+ * are tried.
+ */
+bool
+NxRibMgrImpl::resolveL3Rnh(const NxL3RnhTbl& tbl, nxos::af_e af,
+                           const std::string& vrfName,
+                           const NxIpAddr& address, NxPrefix* resolvedBy)
+{
+   NxL3RouteVrfTbl::iterator wit = m_ribRoutes[af].find(vrfName);
+
+   if (wit == m_ribRoutes[af].end()) return false;
+
+   for (int len = address.addrBits(); len >= 0; len--) {
+      if (!tbl.lenCount[len]) continue;
+
+      resolvedBy->set(address, len);
+      if (wit->second.count(*resolvedBy)) return true;
+   }
+   return false;
+}
+
+/*
+ * Move rnh to resolvedBy (NULL if unresolved) and queue its App routes
+ * to be notified.
+ */
+void
+NxRibMgrImpl::setL3RnhResolution(NxL3RnhTbl& tbl, const NxIpAddr& address,
+                                 NxL3Rnh& rnh, const NxPrefix* resolvedBy,
+                                 std::set<NxPrefix>* notify)
+{
+   std::map<NxPrefix, std::set<NxIpAddr> >::iterator dit;
+
+   if (rnh.resolved) {
+      dit = tbl.dependents.find(rnh.resolvedBy);
+      dit->second.erase(address);
+      if (dit->second.empty()) tbl.dependents.erase(dit);
+   }
+   rnh.resolved = (resolvedBy != NULL);
+   if (resolvedBy) {
+      rnh.resolvedBy = *resolvedBy;
+      tbl.dependents[*resolvedBy].insert(address);
+   }
+   if (notify) notify->insert(rnh.routes.begin(), rnh.routes.end());
+}
+
+/*
+ * Register (or) unregister the recursive next-hops of an App route once
+ * committed. New next-hops are resolved & the route notified.
+ */
+void
+NxRibMgrImpl::trackL3RouteRnhs(NxL3RouteImpl* route, bool add)
+{
+   const NxPrefix&        prefix = route->m_prefix;
+   af_e                   af     = (af_e)prefix.ip.af;
+   std::vector<NxIpAddr>  addrs, old;
+   std::set<NxPrefix>     notify;
+   NxL3RnhTbl            *tbl;
+   NxPrefix               resolvedBy;
+
+   if (af >= MAX_AF) return;
+
+   if (add) {
+      const std::vector<NxL3NextHopImpl *>& nextHops = route->l3NextHops();
+
+      for (size_t i = 0; i < nextHops.size(); i++) {
+         if ((nextHops[i]->m_type == NxL3NextHop::RECURSIVE) &&
+             (nextHops[i]->m_ip.af == af)) {
+            addrs.push_back(nextHops[i]->m_ip);
+         }
+      }
+      std::sort(addrs.begin(), addrs.end());
+      addrs.erase(std::unique(addrs.begin(), addrs.end()), addrs.end());
+   }
+
+   tbl = getL3RnhTbl(af, route->m_vrfName, !addrs.empty());
+   if (!tbl) return;
+
+   std::map<NxPrefix, std::vector<NxIpAddr> >::iterator rit =
+      tbl->routeRnhs.find(prefix);
+   if (rit != tbl->routeRnhs.end()) {
+      old.swap(rit->second);
+      tbl->routeRnhs.erase(rit);
+   }
+
+   for (size_t i = 0; i < old.size(); i++) {
+      if (std::binary_search(addrs.begin(), addrs.end(), old[i])) continue;
+
+      std::map<NxIpAddr, NxL3Rnh>::iterator it = tbl->rnhs.find(old[i]);
+      it->second.routes.erase(prefix);
+      if (it->second.routes.empty()) {
+         setL3RnhResolution(*tbl, old[i], it->second, NULL, NULL);
+         tbl->rnhs.erase(it);
+      }
+   }
+   for (size_t i = 0; i < addrs.size(); i++) {
+      std::map<NxIpAddr, NxL3Rnh>::iterator it = tbl->rnhs.find(addrs[i]);
+
+      if (it == tbl->rnhs.end()) {
+         it = tbl->rnhs.insert(std::make_pair(addrs[i], NxL3Rnh())).first;
+         it->second.resolved = false;
+         if (resolveL3Rnh(*tbl, af, route->m_vrfName, addrs[i], &resolvedBy)) {
+            setL3RnhResolution(*tbl, addrs[i], it->second, &resolvedBy, NULL);
+         }
+      }
+      it->second.routes.insert(prefix);
+   }
+   if (addrs.empty()) return;
+
+   tbl->routeRnhs[prefix].swap(addrs);
+   notify.insert(prefix);
+   notifyL3Rnhs(af, route->m_vrfName, *tbl, notify);
+}
+
+/*
+ * A watched route changed. ADD/UPDATE takes over the next-hops under it
+ * resolving through a shorter prefix, DELETE re-resolves the next-hops
+ * resolving through it. nhChanged re-notifies the routes resolving
+ * through it.
+ */
+void
+NxRibMgrImpl::updateL3RouteRnhs(const NxPrefix& prefix,
+                                const std::string& vrfName,
+                                nxos::event_type_e event, bool nhChanged)
+{
+   af_e                af = (af_e)prefix.ip.af;
+   NxL3RnhTbl         *tbl = getL3RnhTbl(af, vrfName, false);
+   std::set<NxPrefix>  notify;
+   NxPrefix            resolvedBy;
+
+   if (!tbl) return;
+
+   if (event == ADD) {
+      tbl->lenCount[prefix.maskLen]++;
+   } else if (event == DELETE) {
+      tbl->lenCount[prefix.maskLen]--;
+   }
+
+   if (event != DELETE) {
+      std::map<NxIpAddr, NxL3Rnh>::iterator it;
+
+      for (it = tbl->rnhs.lower_bound(prefix.ip);
+           (it != tbl->rnhs.end()) && prefix.contains(it->first); ++it) {
+         NxL3Rnh& rnh = it->second;
+
+         if (rnh.resolved && (rnh.resolvedBy == prefix)) {
+            if (nhChanged) notify.insert(rnh.routes.begin(), rnh.routes.end());
+         } else if (!rnh.resolved || (rnh.resolvedBy.maskLen < prefix.maskLen)) {
+            setL3RnhResolution(*tbl, it->first, rnh, &prefix, &notify);
+         }
+      }
+   } else {
+      std::map<NxPrefix, std::set<NxIpAddr> >::iterator dit =
+         tbl->dependents.find(prefix);
+
+      if (dit == tbl->dependents.end()) return;
+
+      // Copied, re-resolving edits the dependents.
+      std::set<NxIpAddr> addrs(dit->second);
+      for (std::set<NxIpAddr>::iterator ait = addrs.begin();
+           ait != addrs.end(); ++ait) {
+         NxL3Rnh& rnh = tbl->rnhs[*ait];
+         bool     found = resolveL3Rnh(*tbl, af, vrfName, *ait, &resolvedBy);
+
+         setL3RnhResolution(*tbl, *ait, rnh, found ? &resolvedBy : NULL,
+                            &notify);
+      }
+   }
+   notifyL3Rnhs(af, vrfName, *tbl, notify);
+}
+
+/*
+ * Next-hops of group changed in place, re-notify the routes resolving
+ * through the watched routes using it.
+ */
+void
+NxRibMgrImpl::updateL3GroupRnhs(NxL3NextHopGroupImpl* group)
+{
+   for (int af = AF_START; af < MAX_AF; af++) {
+      for (NxL3RnhVrfTbl::iterator vit = m_rnhs[af].begin();
+           vit != m_rnhs[af].end(); ++vit) {
+         NxL3RnhTbl&               tbl = vit->second;
+         NxL3RouteVrfTbl::iterator wit = m_ribRoutes[af].find(vit->first);
+         std::set<NxPrefix>        notify;
+
+         if (wit == m_ribRoutes[af].end()) continue;
+
+         for (std::map<NxPrefix, std::set<NxIpAddr> >::iterator dit =
+                 tbl.dependents.begin(); dit != tbl.dependents.end(); ++dit) {
+            NxL3RouteTbl::iterator rit = wit->second.find(dit->first);
+
+            if ((rit == wit->second.end()) || (rit->second->m_nhGroup != group)) {
+               continue;
+            }
+            for (std::set<NxIpAddr>::iterator ait = dit->second.begin();
+                 ait != dit->second.end(); ++ait) {
+               const NxL3Rnh& rnh = tbl.rnhs[*ait];
+               notify.insert(rnh.routes.begin(), rnh.routes.end());
+            }
+         }
+         notifyL3Rnhs((af_e)af, vit->first, tbl, notify);
+      }
+   }
+}
+
+/*
+ * Call postL3RecursiveNextHopCb once per App route, resolved if any of
+ * its recursive next-hops is.
+ */
+void
+NxRibMgrImpl::notifyL3Rnhs(nxos::af_e af, const std::string& vrfName,
+                           NxL3RnhTbl& tbl, const std::set<NxPrefix>& routes)
+{
+   NxMyL3RouteVrfTbl::iterator vit;
+   NxL3RouteTbl::iterator      rit;
+
+   if (!m_handler || routes.empty() ||
+       !m_handlerFilter.wants(NxRibMgrHandler::EVENT_L3_RECURSIVE_NEXT_HOP,
+                              routes.size())) {
+      return;
+   }
+
+   vit = m_myRoutes[af].find(vrfName);
+   if (vit == m_myRoutes[af].end()) return;
+
+   for (std::set<NxPrefix>::const_iterator it = routes.begin();
+        it != routes.end(); ++it) {
+      std::map<NxPrefix, std::vector<NxIpAddr> >::iterator ait;
+      bool                                                resolved = false;
+
+      rit = vit->second.routes.find(*it);
+      ait = tbl.routeRnhs.find(*it);
+      if ((rit == vit->second.routes.end()) || (ait == tbl.routeRnhs.end())) {
+         continue;
+      }
+      for (size_t i = 0; !resolved && (i < ait->second.size()); i++) {
+         resolved = tbl.rnhs[ait->second[i]].resolved;
+      }
+      m_handler->postL3RecursiveNextHopCb(rit->second, resolved);
+   }
+}
+
+unsigned int
+NxRibMgrImpl::getL3RecursiveNextHopRoutes(const nxos::NxPrefix& prefix, const std::string& vrfName, std::vector<nxos::NxPrefix>* routes)
+{
+   NxL3RnhTbl         *tbl;
+   std::set<NxPrefix>  deps;
+
+   if (routes) routes->clear();
+   if ((prefix.ip.af >= MAX_AF) ||
+       !(tbl = getL3RnhTbl((af_e)prefix.ip.af, vrfName, false))) {
+      return 0;
+   }
+
+   std::map<NxPrefix, std::set<NxIpAddr> >::iterator dit =
+      tbl->dependents.find(prefix);
+   if (dit == tbl->dependents.end()) return 0;
+
+   for (std::set<NxIpAddr>::iterator ait = dit->second.begin();
+        ait != dit->second.end(); ++ait) {
+      const NxL3Rnh& rnh = tbl->rnhs[*ait];
+      deps.insert(rnh.routes.begin(), rnh.routes.end());
+   }
+   if (routes) routes->assign(deps.begin(), deps.end());
+   return deps.size();
+}
\ No newline at end of file
@@ -0,0 +1,495 @@
+/** **********************************************************************
+    * Warm restart snapshot of the NxRibMgr routes. Refer to
+    * nx_rib_snapshot.h for the file format.
+    *
+    * Copyright (c) 2017 by cisco Systems, Inc.
+    *
+    * All rights reserved.
+************************************************************************/
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+#include "nx_rib_mgr_impl.h"
+#include "nx_rib_snapshot.h"
+#include "nx_intf_dict.h"
+
+using namespace std;
+using namespace nxos;
+
+#define NX_RIB_SNAP_HASH_SEED  0xcbf29ce484222325ULL
+
+static size_t
+nxRibSnapPad(size_t len)
+{
+   return (len + 3) & ~(size_t)3;
+}
+
+// Implementation for class NxRibSnapWriter
+NxRibSnapWriter::NxRibSnapWriter()
+{
+
+}
+
+uint32_t
+NxRibSnapWriter::addStr(const std::string& str)
+{
+   std::map<std::string, uint32_t>::iterator it = m_strIdx.find(str);
+   uint32_t                                  idx;
+
+   if (it != m_strIdx.end()) return it->second;
+
+   idx = m_strIdx.size();
+   m_strIdx.insert(std::make_pair(str, idx));
+   m_strings.append(str.c_str(), str.size() + 1);
+   return idx;
+}
+
+uint32_t
+NxRibSnapWriter::addNhSet(const std::vector<NxL3NextHopImpl *>& nextHops)
+{
+   NxRibSnapNhSet nhSet;
+
+   if (nextHops.empty()) return 0;
+
+   nhSet.first = m_nextHops.size();
+   nhSet.count = nextHops.size();
+   for (size_t i = 0; i < nextHops.size(); i++) {
+      const NxL3NextHopImpl *nh = nextHops[i];
+      NxRibSnapNh            rec;
+
+      memset(&rec, 0, sizeof(rec));
+      rec.ip         = nh->m_ip;
+      rec.type       = (uint8_t)nh->m_type;
+      rec.encapType  = (uint8_t)nh->m_encapType;
+      rec.preference = nh->m_preference;
+      rec.metric     = nh->m_metric;
+      rec.tag        = nh->m_tag;
+      rec.segmentId  = nh->m_segmentId;
+      rec.tunnelId   = nh->m_tunnelId;
+      rec.intfName   = addStr(NxIntfDict::get().name(nh->m_ifindex));
+      rec.vrfName    = addStr(nxRibName(nh->m_vrfId));
+      rec.owner      = addStr(nxRibName(nh->m_ownerId));
+      m_nextHops.push_back(rec);
+   }
+   m_nhSets.push_back(nhSet);
+   return m_nhSets.size();
+}
+
+void
+NxRibSnapWriter::addL3Route(NxL3RouteImpl* route, bool myRoute)
+{
+   NxRibSnapRoute rec;
+
+   memset(&rec, 0, sizeof(rec));
+   rec.prefix  = route->m_prefix;
+   rec.vrfName = addStr(route->m_vrfName);
+   if (route->m_nhGroup) {
+      // Routes sharing next-hops share the set in the file as well.
+      std::map<const void *, uint32_t>::iterator it =
+         m_groupNhSet.find(route->m_nhGroup);
+
+      if (it == m_groupNhSet.end()) {
+         it = m_groupNhSet.insert(std::make_pair(
+                 (const void *)route->m_nhGroup,
+                 addNhSet(route->l3NextHops()))).first;
+      }
+      rec.nhSet = it->second;
+   } else {
+      rec.nhSet = addNhSet(route->m_nextHops);
+   }
+   (myRoute ? m_myRoutes : m_routes).push_back(rec);
+}
+
+/*
+ * Write the file next to path & rename it over path, a reader never sees
+ * a partial snapshot.
+ */
+bool
+NxRibSnapWriter::write(const std::string& path)
+{
+   std::string   tmpPath = path + ".tmp";
+   size_t        strBytes = nxRibSnapPad(m_strings.size());
+   size_t        size, off;
+   int           fd;
+   char         *base;
+   NxRibSnapHdr *hdr;
+
+   size = sizeof(NxRibSnapHdr) + strBytes +
+          (m_nhSets.size() * sizeof(NxRibSnapNhSet)) +
+          (m_nextHops.size() * sizeof(NxRibSnapNh)) +
+          ((m_routes.size() + m_myRoutes.size()) * sizeof(NxRibSnapRoute));
+
+   fd = ::open(tmpPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+   if (fd < 0) return false;
+   if (ftruncate(fd, size) < 0) {
+      close(fd);
+      unlink(tmpPath.c_str());
+      return false;
+   }
+   base = (char *)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   close(fd);
+   if (base == MAP_FAILED) {
+      unlink(tmpPath.c_str());
+      return false;
+   }
+
+   // ftruncate zero filled the file, padding is left as is.
+   off = sizeof(NxRibSnapHdr);
+   if (!m_strings.empty()) memcpy(base + off, m_strings.data(), m_strings.size());
+   off += strBytes;
+   if (!m_nhSets.empty()) {
+      memcpy(base + off, &m_nhSets[0], m_nhSets.size() * sizeof(NxRibSnapNhSet));
+      off += m_nhSets.size() * sizeof(NxRibSnapNhSet);
+   }
+   if (!m_nextHops.empty()) {
+      memcpy(base + off, &m_nextHops[0], m_nextHops.size() * sizeof(NxRibSnapNh));
+      off += m_nextHops.size() * sizeof(NxRibSnapNh);
+   }
+   if (!m_routes.empty()) {
+      memcpy(base + off, &m_routes[0], m_routes.size() * sizeof(NxRibSnapRoute));
+      off += m_routes.size() * sizeof(NxRibSnapRoute);
+   }
+   if (!m_myRoutes.empty()) {
+      memcpy(base + off, &m_myRoutes[0],
+             m_myRoutes.size() * sizeof(NxRibSnapRoute));
+   }
+
+   hdr = (NxRibSnapHdr *)base;
+   memcpy(hdr->magic, NX_RIB_SNAP_MAGIC, sizeof(hdr->magic));
+   hdr->version      = NX_RIB_SNAP_VERSION;
+   hdr->strBytes     = strBytes;
+   hdr->strCount     = m_strIdx.size();
+   hdr->nhSetCount   = m_nhSets.size();
+   hdr->nhCount      = m_nextHops.size();
+   hdr->routeCount   = m_routes.size();
+   hdr->myRouteCount = m_myRoutes.size();
+   hdr->size         = size;
+   hdr->checksum     = nxRibHashBytes(NX_RIB_SNAP_HASH_SEED,
+                                      base + sizeof(NxRibSnapHdr),
+                                      size - sizeof(NxRibSnapHdr));
+   munmap(base, size);
+
+   if (rename(tmpPath.c_str(), path.c_str()) < 0) {
+      unlink(tmpPath.c_str());
+      return false;
+   }
+   return true;
+}
+
+// Implementation for class NxRibSnapReader
+NxRibSnapReader::NxRibSnapReader()
+   : m_base(NULL), m_size(0), m_hdr(NULL), m_nhSets(NULL), m_nextHops(NULL),
+     m_routes(NULL), m_myRoutes(NULL)
+{
+
+}
+
+NxRibSnapReader::~NxRibSnapReader()
+{
+   if (m_base) munmap(m_base, m_size);
+}
+
+bool
+NxRibSnapReader::open(const std::string& path)
+{
+   struct stat st;
+   int         fd = ::open(path.c_str(), O_RDONLY);
+
+   if (fd < 0) return false;
+   if ((fstat(fd, &st) < 0) || (st.st_size < (off_t)sizeof(NxRibSnapHdr))) {
+      close(fd);
+      return false;
+   }
+   m_size = st.st_size;
+   m_base = mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+   close(fd);
+   if (m_base == MAP_FAILED) {
+      m_base = NULL;
+      return false;
+   }
+   return validate();
+}
+
+static bool
+nxRibSnapRouteValid(const NxRibSnapRoute* route, const NxRibSnapHdr* hdr)
+{
+   return (route->prefix.ip.af < MAX_AF) &&
+          (route->prefix.maskLen <= route->prefix.ip.addrBits()) &&
+          (route->vrfName < hdr->strCount) &&
+          (route->nhSet <= hdr->nhSetCount);
+}
+
+bool
+NxRibSnapReader::validate()
+{
+   const char *base = (const char *)m_base;
+   const char *strs, *p, *end;
+   uint64_t    size;
+
+   m_hdr = (const NxRibSnapHdr *)base;
+   if (memcmp(m_hdr->magic, NX_RIB_SNAP_MAGIC, sizeof(m_hdr->magic)) ||
+       (m_hdr->version != NX_RIB_SNAP_VERSION) || (m_hdr->size != m_size) ||
+       (m_hdr->strBytes % 4)) {
+      return false;
+   }
+
+   size = sizeof(NxRibSnapHdr) + (uint64_t)m_hdr->strBytes +
+          ((uint64_t)m_hdr->nhSetCount * sizeof(NxRibSnapNhSet)) +
+          ((uint64_t)m_hdr->nhCount * sizeof(NxRibSnapNh)) +
+          (((uint64_t)m_hdr->routeCount + m_hdr->myRouteCount) *
+           sizeof(NxRibSnapRoute));
+   if ((size != m_size) ||
+       (m_hdr->checksum != nxRibHashBytes(NX_RIB_SNAP_HASH_SEED,
+                                          base + sizeof(NxRibSnapHdr),
+                                          m_size - sizeof(NxRibSnapHdr)))) {
+      return false;
+   }
+
+   strs       = base + sizeof(NxRibSnapHdr);
+   m_nhSets   = (const NxRibSnapNhSet *)(strs + m_hdr->strBytes);
+   m_nextHops = (const NxRibSnapNh *)(m_nhSets + m_hdr->nhSetCount);
+   m_routes   = (const NxRibSnapRoute *)(m_nextHops + m_hdr->nhCount);
+   m_myRoutes = m_routes + m_hdr->routeCount;
+
+   // Strings are NUL terminated, the padding is empty strings past strCount.
+   m_strs.reserve(m_hdr->strCount);
+   end = strs + m_hdr->strBytes;
+   for (p = strs; (p < end) && (m_strs.size() < m_hdr->strCount); p++) {
+      m_strs.push_back(p);
+      p = (const char *)memchr(p, '\0', end - p);
+      if (!p) return false;
+   }
+   if (m_strs.size() != m_hdr->strCount) return false;
+
+   for (uint32_t i = 0; i < m_hdr->nhSetCount; i++) {
+      if (((uint64_t)m_nhSets[i].first + m_nhSets[i].count) > m_hdr->nhCount) {
+         return false;
+      }
+   }
+   for (uint32_t i = 0; i < m_hdr->nhCount; i++) {
+      const NxRibSnapNh *nh = &m_nextHops[i];
+
+      if ((nh->ip.af >= MAX_AF) || (nh->intfName >= m_hdr->strCount) ||
+          (nh->vrfName >= m_hdr->strCount) || (nh->owner >= m_hdr->strCount)) {
+         return false;
+      }
+   }
+   for (uint32_t i = 0; i < m_hdr->routeCount; i++) {
+      if (!nxRibSnapRouteValid(&m_routes[i], m_hdr)) return false;
+   }
+   for (uint32_t i = 0; i < m_hdr->myRouteCount; i++) {
+      if (!nxRibSnapRouteValid(&m_myRoutes[i], m_hdr)) return false;
+   }
+   return true;
+}
+
+// Implementation of the NxRibMgrImpl snapshot APIs
+
+/*
+ * Add the next-hops of set nhSet of the snapshot to route.
+ */
+void
+NxRibMgrImpl::loadL3NextHops(const NxRibSnapReader& snap, uint32_t nhSet,
+                             NxL3RouteImpl* route)
+{
+   const NxRibSnapNhSet *set;
+
+   if (!nhSet) return;
+
+   set = snap.nhSet(nhSet - 1);
+   for (uint32_t i = 0; i < set->count; i++) {
+      const NxRibSnapNh *rec = snap.nextHop(set->first + i);
+      NxL3NextHopImpl   *nh;
+
+      nh = new NxL3NextHopImpl(rec->ip, snap.str(rec->intfName),
+                               snap.str(rec->vrfName), rec->preference,
+                               (NxL3NextHop::nh_types_e)rec->type);
+      nh->m_ownerId   = nxRibNameId(snap.str(rec->owner));
+      nh->m_metric    = rec->metric;
+      nh->m_tag       = rec->tag;
+      nh->m_segmentId = rec->segmentId;
+      nh->m_tunnelId  = rec->tunnelId;
+      nh->m_encapType = (encap_type_e)rec->encapType;
+      route->m_nextHops.push_back(nh);
+   }
+}
+
+/*
+ * Restore the routes of the snapshot at m_snapPath, if valid.
+ */
+bool
+NxRibMgrImpl::loadL3RouteSnapshot()
+{
+   NxRibSnapReader snap;
+   NxL3RouteImpl  *route;
+   uint32_t        repopulate;
+
+   if (!snap.open(m_snapPath)) return false;
+
+   for (uint32_t i = 0; i < snap.hdr()->routeCount; i++) {
+      const NxRibSnapRoute *rec = snap.route(i);
+      std::string           vrfName = snap.str(rec->vrfName);
+      NxL3RouteTbl&         tbl = m_ribRoutes[rec->prefix.ip.af][vrfName];
+
+      // Already sent by RIB, it is more recent.
+      if (tbl.count(rec->prefix)) continue;
+
+      route = new NxL3RouteImpl(vrfName, rec->prefix);
+      loadL3NextHops(snap, rec->nhSet, route);
+      route->setEvent(DOWNLOAD);
+      postL3RouteEvent(route);
+
+      NxL3RouteTbl::iterator rit = tbl.find(rec->prefix);
+      if (rit != tbl.end()) rit->second->m_stale = true;
+   }
+
+   for (uint32_t i = 0; i < snap.hdr()->myRouteCount; i++) {
+      const NxRibSnapRoute *rec = snap.myRoute(i);
+      std::string           vrfName = snap.str(rec->vrfName);
+      NxMyL3RouteTbl&       tbl = m_myRoutes[rec->prefix.ip.af][vrfName];
+
+      if (tbl.routes.count(rec->prefix)) continue;
+
+      route = new NxL3RouteImpl(vrfName, rec->prefix);
+      loadL3NextHops(snap, rec->nhSet, route);
+      route->m_stale = true;
+      tbl.routes.insert(std::make_pair(rec->prefix, route));
+   }
+
+   // The App may re-add routes from the callback, ask only once all loaded.
+   repopulate = snap.hdr()->myRouteCount;
+   if (!m_handler ||
+       !m_handlerFilter.wants(NxRibMgrHandler::EVENT_L3_ROUTE_REPOPULATE,
+                              repopulate)) {
+      repopulate = 0;
+   }
+   for (uint32_t i = 0; i < repopulate; i++) {
+      const NxRibSnapRoute *rec = snap.myRoute(i);
+
+      m_handler->postL3RouteRepopulateCb(snap.str(rec->vrfName),
+                                         rec->prefix.ip.toString(),
+                                         rec->prefix.maskLen);
+   }
+   flushL3RouteBatch();
+   m_snapDirty = false;
+   return true;
+}
+
+bool
+NxRibMgrImpl::enableL3RouteSnapshot(const std::string& path, unsigned int intervalSec, bool enable)
+{
+   bool load;
+
+   if (!enable) {
+      m_snapPath.clear();
+      return true;
+   }
+   if (path.empty()) return false;
+
+   load              = (path != m_snapPath);
+   m_snapPath        = path;
+   m_snapIntervalSec = intervalSec;
+   m_snapSavedMs     = nxRibNowMs();
+   if (load) loadL3RouteSnapshot();
+   return true;
+}
+
+bool
+NxRibMgrImpl::saveL3RouteSnapshot()
+{
+   NxRibSnapWriter writer;
+
+   if (m_snapPath.empty()) return false;
+
+   for (int af = AF_START; af < MAX_AF; af++) {
+      for (NxL3RouteVrfTbl::iterator wit = m_ribRoutes[af].begin();
+           wit != m_ribRoutes[af].end(); ++wit) {
+         for (NxL3RouteTbl::iterator rit = wit->second.begin();
+              rit != wit->second.end(); ++rit) {
+            writer.addL3Route(rit->second, false);
+         }
+      }
+      for (NxMyL3RouteVrfTbl::iterator vit = m_myRoutes[af].begin();
+           vit != m_myRoutes[af].end(); ++vit) {
+         for (NxL3RouteTbl::iterator rit = vit->second.routes.begin();
+              rit != vit->second.routes.end(); ++rit) {
+            writer.addL3Route(rit->second, true);
+         }
+      }
+   }
+   if (!writer.write(m_snapPath)) return false;
+
+   m_snapDirty   = false;
+   m_snapSavedMs = nxRibNowMs();
+   return true;
+}
+
+void
+NxRibMgrImpl::pollL3RouteSnapshot()
+{
+   if (m_snapPath.empty() || !m_snapDirty || !m_snapIntervalSec ||
+       (nxRibNowMs() - m_snapSavedMs < (uint64_t)m_snapIntervalSec * 1000)) {
+      return;
+   }
+   saveL3RouteSnapshot();
+}
+
+void
+NxRibMgrImpl::postL3RouteDownloadDone(nxos::af_e af, const std::string& vrfName)
+{
+   std::vector<NxL3RouteImpl *> stale;
+   NxL3RouteImpl               *route;
+   std::map<std::string, NxRibConvergence>            downloads;
+   std::map<std::string, NxRibConvergence>::iterator  it;
+   NxRibConvergence                                   timing;
+   uint64_t                                           now;
+
+   if (af >= MAX_AF) return;
+
+   for (NxL3RouteVrfTbl::iterator wit = m_ribRoutes[af].begin();
+        wit != m_ribRoutes[af].end(); ++wit) {
+      if ((vrfName != "all") && (wit->first != vrfName)) continue;
+      for (NxL3RouteTbl::iterator rit = wit->second.begin();
+           rit != wit->second.end(); ++rit) {
+         if (rit->second->m_stale) stale.push_back(rit->second);
+      }
+   }
+
+   // Not downloaded again, RIB no longer has them.
+   for (size_t i = 0; i < stale.size(); i++) {
+      route = new NxL3RouteImpl(stale[i]->m_vrfName, stale[i]->m_prefix);
+      route->setEvent(DELETE);
+      postL3RouteEvent(route);
+   }
+   flushL3RouteBatch();
+
+   /*
+    * The App has all the routes, report the pending downloads done. The
+    * watch of all the VRFs is reported by VRF, on its own if it got no
+    * route. Completed VRF by VRF, it is done with the last VRF pending,
+    * reported on its own if none got a route.
+    */
+   now = nxRibNowMs();
+   if (vrfName == "all") {
+      downloads.swap(m_downloads[af]);
+      if (downloads.size() > 1) downloads.erase("all");
+      for (it = downloads.begin(); it != downloads.end(); ++it) {
+         notifyRibConverged(af, it->first, it->second, now);
+      }
+   } else if ((it = m_downloads[af].find(vrfName)) != m_downloads[af].end()) {
+      timing = it->second;
+      m_downloads[af].erase(it);
+      if ((m_downloads[af].size() == 1) && m_downloads[af].count("all")) {
+         m_downloads[af].clear();
+      }
+      notifyRibConverged(af, vrfName, timing, now);
+   } else if ((m_downloads[af].size() == 1) &&
+              ((it = m_downloads[af].find("all")) != m_downloads[af].end())) {
+      timing = it->second;
+      m_downloads[af].clear();
+      notifyRibConverged(af, "all", timing, now);
+   }
+}
\ No newline at end of file
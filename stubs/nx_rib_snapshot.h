@@ -0,0 +1,133 @@
+/** **********************************************************************
+    * On disk format of the NxRibMgr warm restart snapshot.
+    *
+    * The file is written & read through mmap in one pass:
+    *
+    *    NxRibSnapHdr
+    *    strings     strBytes of NUL terminated strings, padded to 4
+    *    nhSets      NxRibSnapNhSet[nhSetCount]
+    *    nextHops    NxRibSnapNh[nhCount]
+    *    routes      NxRibSnapRoute[routeCount]     watched routes
+    *    myRoutes    NxRibSnapRoute[myRouteCount]   routes of the App
+    *
+    * Strings & next-hop sets are referred to by index. Next-hop set
+    * index 0 is an empty set, others are index + 1. All integers are in
+    * host byte order as the file is only read back on the same switch.
+    * Bump NX_RIB_SNAP_VERSION on any change, other versions are ignored.
+    *
+    * Copyright (c) 2017 by cisco Systems, Inc.
+    *
+    * All rights reserved.
+************************************************************************/
+#ifndef __nx_rib_snapshot_H__
+#define __nx_rib_snapshot_H__
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "types/nx_rib_mgr.h"
+
+namespace nxos {
+
+#define NX_RIB_SNAP_MAGIC    "NXRIBSNP"
+#define NX_RIB_SNAP_VERSION  1
+
+struct NxRibSnapHdr {
+    char      magic[8];
+    uint32_t  version;
+    uint32_t  strBytes;
+    uint32_t  strCount;
+    uint32_t  nhSetCount;
+    uint32_t  nhCount;
+    uint32_t  routeCount;
+    uint32_t  myRouteCount;
+    uint32_t  reserved;
+    uint64_t  size;      // whole file
+    uint64_t  checksum;  // FNV-1a of all that follows the header
+};
+
+struct NxRibSnapNhSet {
+    uint32_t  first;     // index in nextHops
+    uint32_t  count;
+};
+
+struct NxRibSnapNh {
+    NxIpAddr  ip;
+    uint8_t   type;
+    uint8_t   encapType;
+    uint8_t   pad;
+    uint32_t  preference;
+    uint32_t  metric;
+    uint32_t  tag;
+    uint32_t  segmentId;
+    uint32_t  tunnelId;
+    uint32_t  intfName;  // string index
+    uint32_t  vrfName;   // string index
+    uint32_t  owner;     // string index
+};
+
+struct NxRibSnapRoute {
+    NxPrefix  prefix;
+    uint16_t  pad;
+    uint32_t  vrfName;   // string index
+    uint32_t  nhSet;
+};
+
+class NxL3RouteImpl;
+class NxL3NextHopImpl;
+
+/*
+ * Collects the routes to save & writes the snapshot file.
+ */
+class NxRibSnapWriter {
+public:
+    NxRibSnapWriter();
+    void addL3Route(NxL3RouteImpl *route, bool myRoute);
+    bool write(const std::string &path);
+
+private:
+    uint32_t addStr(const std::string &str);
+    uint32_t addNhSet(const std::vector<NxL3NextHopImpl *> &nextHops);
+
+    std::map<std::string, uint32_t>  m_strIdx;
+    std::string                      m_strings;
+    std::map<const void *, uint32_t> m_groupNhSet;  // shared next-hops
+    std::vector<NxRibSnapNhSet>      m_nhSets;
+    std::vector<NxRibSnapNh>         m_nextHops;
+    std::vector<NxRibSnapRoute>      m_routes;
+    std::vector<NxRibSnapRoute>      m_myRoutes;
+};
+
+/*
+ * Read only view of a mapped snapshot. Every index is checked by open()
+ * so that the accessors can be used as is.
+ */
+class NxRibSnapReader {
+public:
+    NxRibSnapReader();
+    ~NxRibSnapReader();
+    bool open(const std::string &path);
+
+    const NxRibSnapHdr* hdr() const { return m_hdr; }
+    const char* str(uint32_t idx) const { return m_strs[idx]; }
+    const NxRibSnapNhSet* nhSet(uint32_t idx) const { return &m_nhSets[idx]; }
+    const NxRibSnapNh* nextHop(uint32_t idx) const { return &m_nextHops[idx]; }
+    const NxRibSnapRoute* route(uint32_t idx) const { return &m_routes[idx]; }
+    const NxRibSnapRoute* myRoute(uint32_t idx) const { return &m_myRoutes[idx]; }
+
+private:
+    bool validate();
+
+    void                     *m_base;
+    size_t                    m_size;
+    const NxRibSnapHdr       *m_hdr;
+    std::vector<const char *> m_strs;
+    const NxRibSnapNhSet     *m_nhSets;
+    const NxRibSnapNh        *m_nextHops;
+    const NxRibSnapRoute     *m_routes;
+    const NxRibSnapRoute     *m_myRoutes;
+};
+
+}
+#endif // __nx_rib_snapshot_H__
@@ -0,0 +1,180 @@
+/** **********************************************************************
+    * Route statistics of the watched routes.
+    *
+    * Kept per AF, VRF & owner (protocol-tag of the next-hops) as routes
+    * are added, updated & deleted in the watched route table, along with
+    * the aggregates of the VRF, of the owner & of the AF so any of them
+    * is read without walking the routes. Next-hop groups count the
+    * routes using them per entry, so an in-place change of the group
+    * moves them between next-hop buckets at once.
+    *
+    * Copyright (c) 2017 by cisco Systems, Inc.
+    *
+    * All rights reserved.
+************************************************************************/
+#include <cstdio>
+#include <cstring>
+#include "nx_rib_mgr_impl.h"
+
+using namespace std;
+using namespace nxos;
+
+static inline uint32_t
+nxL3StatsNhBucket(size_t nhCount)
+{
+   return (nhCount < NX_L3_ROUTE_STATS_MAX_NH) ? nhCount :
+                                                 NX_L3_ROUTE_STATS_MAX_NH;
+}
+
+/* Apply sign times count routes of maskLen & nhCount to entry & its aggregates. */
+static void
+nxL3StatsApply(NxL3RouteStatsEntry *entry, unsigned int maskLen,
+               size_t nhCount, int sign, uint32_t count = 1)
+{
+   NxL3RouteStats *stats;
+
+   for (int i = -1; i < 3; i++) {
+      stats = (i < 0) ? &entry->stats : &entry->up[i]->stats;
+      stats->routes                               += sign * (int)count;
+      stats->maskLens[maskLen]                    += sign * (int)count;
+      stats->nhCounts[nxL3StatsNhBucket(nhCount)] += sign * (int)count;
+      stats->nextHops += sign * (int64_t)(count * nhCount);
+   }
+}
+
+NxL3RouteStatsEntry *
+NxRibMgrImpl::getL3RouteStatsEntry(af_e af, const string &vrfName,
+                                   const string &owner)
+{
+   NxL3RouteStatsTbl   &tbl   = m_routeStats[af];
+   NxL3RouteStatsEntry *entry = &tbl[make_pair(vrfName, owner)];
+
+   if (!entry->up[0]) {
+      entry->up[0] = &tbl[make_pair(vrfName, string("all"))];
+      entry->up[1] = &tbl[make_pair(string("all"), owner)];
+      entry->up[2] = &tbl[make_pair(string("all"), string("all"))];
+   }
+   return entry;
+}
+
+/*
+ * Count route copied into the watched route table, old being the one it
+ * replaces. A route without next-hops keeps the owner of old.
+ */
+void
+NxRibMgrImpl::addL3RouteStats(NxL3RouteImpl *route, NxL3RouteImpl *old)
+{
+   const vector<NxL3NextHopImpl *> &nhs = route->l3NextHops();
+   af_e af = (af_e)route->m_prefix.ip.af;
+
+   if (af >= MAX_AF) return;
+   if (!nhs.empty()) {
+      route->m_stats = getL3RouteStatsEntry(af, route->m_vrfName,
+                                            nxRibName(nhs[0]->m_ownerId));
+   } else if (old && old->m_stats) {
+      route->m_stats = old->m_stats;
+   } else {
+      route->m_stats = getL3RouteStatsEntry(af, route->m_vrfName, "");
+   }
+   nxL3StatsApply(route->m_stats, route->m_prefix.maskLen, nhs.size(), 1);
+   if (route->m_nhGroup) route->m_nhGroup->m_statsRefs[route->m_stats]++;
+}
+
+void
+NxRibMgrImpl::delL3RouteStats(NxL3RouteImpl *route)
+{
+   map<NxL3RouteStatsEntry *, uint32_t>::iterator it;
+
+   if (!route->m_stats) return;
+
+   nxL3StatsApply(route->m_stats, route->m_prefix.maskLen,
+                  route->l3NextHops().size(), -1);
+   if (route->m_nhGroup) {
+      // Kept at 0 till the group goes, a route updated in place adds it
+      // back without allocating.
+      it = route->m_nhGroup->m_statsRefs.find(route->m_stats);
+      if (it != route->m_nhGroup->m_statsRefs.end()) it->second--;
+   }
+}
+
+/*
+ * The next-hops of group went from oldCount to its current count, move
+ * the watched routes using it. Their prefix length is unchanged so it is
+ * added back as it was removed.
+ */
+void
+NxRibMgrImpl::updateL3GroupStats(NxL3NextHopGroupImpl *group, size_t oldCount)
+{
+   map<NxL3RouteStatsEntry *, uint32_t>::iterator it;
+   size_t newCount = group->m_nextHops.size();
+
+   if (newCount == oldCount) return;
+
+   for (it = group->m_statsRefs.begin(); it != group->m_statsRefs.end(); ++it) {
+      nxL3StatsApply(it->first, 0, oldCount, -1, it->second);
+      nxL3StatsApply(it->first, 0, newCount, 1, it->second);
+   }
+}
+
+bool
+NxRibMgrImpl::getL3RouteStats(nxos::NxL3RouteStats* stats, nxos::af_e af, const std::string& vrfName, const std::string& owner)
+{
+   NxL3RouteStatsTbl::const_iterator it;
+
+   if (!stats) return false;
+
+   memset(stats, 0, sizeof(*stats));
+   if (af >= MAX_AF) return false;
+
+   it = m_routeStats[af].find(make_pair(vrfName, owner));
+   if ((it == m_routeStats[af].end()) || !it->second.stats.routes) {
+      return false;
+   }
+   *stats = it->second.stats;
+   return true;
+}
+
+string
+NxRibMgrImpl::showL3RouteStats()
+{
+   static const char *afNames[MAX_AF] = { "IPv4", "IPv6" };
+   NxL3RouteStatsTbl::const_iterator it;
+   string out;
+   char   line[160];
+
+   for (int af = 0; af < MAX_AF; af++) {
+      it = m_routeStats[af].find(make_pair(string("all"), string("all")));
+      if ((it == m_routeStats[af].end()) || !it->second.stats.routes) {
+         continue;
+      }
+      const NxL3RouteStats &all = it->second.stats;
+
+      snprintf(line, sizeof(line), "\n%s routes\n%-32s %-20s %10s %10s\n",
+               afNames[af], "VRF", "Owner", "Routes", "Next-hops");
+      out += line;
+      for (it = m_routeStats[af].begin(); it != m_routeStats[af].end(); ++it) {
+         if (!it->second.stats.routes) continue;
+         snprintf(line, sizeof(line), "%-32s %-20s %10u %10llu\n",
+                  it->first.first.c_str(), it->first.second.c_str(),
+                  it->second.stats.routes,
+                  (unsigned long long)it->second.stats.nextHops);
+         out += line;
+      }
+
+      out += "Prefix length    Routes\n";
+      for (int len = 0; len <= 128; len++) {
+         if (!all.maskLens[len]) continue;
+         snprintf(line, sizeof(line), "  /%-13d %10u\n", len,
+                  all.maskLens[len]);
+         out += line;
+      }
+      out += "Next-hops        Routes\n";
+      for (int n = 0; n <= NX_L3_ROUTE_STATS_MAX_NH; n++) {
+         if (!all.nhCounts[n]) continue;
+         snprintf(line, sizeof(line), "  %2d%-12s %10u\n", n,
+                  (n == NX_L3_ROUTE_STATS_MAX_NH) ? "+" : "", all.nhCounts[n]);
+         out += line;
+      }
+   }
+   return out.empty() ? string("No routes watched\n") : out;
+}
@@ -0,0 +1,145 @@
+/** **********************************************************************
+    * Compiled NxL3RouteFilter, refer to nx_route_filter.h.
+    *
+    * Copyright (c) 2017 by cisco Systems, Inc.
+    *
+    * All rights reserved.
+************************************************************************/
+#include <algorithm>
+#include <cstring>
+#include "nx_route_filter.h"
+
+using namespace std;
+using namespace nxos;
+
+/* Copy addr masked to maskLen into out. */
+static void
+nxMaskAddr(const unsigned char *addr, unsigned int maskLen, unsigned char *out)
+{
+   unsigned int bytes = maskLen / 8, bits = maskLen % 8;
+
+   memcpy(out, addr, bytes);
+   memset(out + bytes, 0, 16 - bytes);
+   if (bits) out[bytes] = addr[bytes] & (uint8_t)(0xff << (8 - bits));
+}
+
+/* The prefix range fits its address family & the length bitmap. */
+static bool
+nxPrefixRangeValid(const NxL3RoutePrefixRange& pr)
+{
+   unsigned int bits = pr.prefix.ip.addrBits();
+
+   return (pr.prefix.ip.af < MAX_AF) && (pr.prefix.maskLen <= bits) &&
+          (pr.ge >= pr.prefix.maskLen) && (pr.ge <= pr.le) && (pr.le <= bits);
+}
+
+bool
+NxL3RouteMatcher::valid(const NxL3RouteFilter& filter)
+{
+   for (size_t i = 0; i < filter.prefixRanges.size(); i++) {
+      if (!nxPrefixRangeValid(filter.prefixRanges[i])) return false;
+   }
+   return true;
+}
+
+NxL3RouteMatcher::NxL3RouteMatcher(const NxL3RouteFilter& filter)
+   : m_anyPrefix(filter.prefixRanges.empty()),
+     m_anyNextHop(filter.anyNextHop()), m_nhIntfName(filter.nhIntfName),
+     m_maxPreference(filter.maxPreference), m_maxMetric(filter.maxMetric)
+{
+   for (size_t i = 0; i < filter.prefixRanges.size(); i++) {
+      const NxL3RoutePrefixRange& pr = filter.prefixRanges[i];
+      unsigned int                af = pr.prefix.ip.af;
+      size_t                      g;
+      Range                       range;
+
+      if (!nxPrefixRangeValid(pr)) continue;
+
+      for (g = 0; g < m_groups[af].size(); g++) {
+         if (m_groups[af][g].maskLen >= pr.prefix.maskLen) break;
+      }
+      if ((g == m_groups[af].size()) ||
+          (m_groups[af][g].maskLen != pr.prefix.maskLen)) {
+         LenGroup group;
+
+         group.maskLen = pr.prefix.maskLen;
+         m_groups[af].insert(m_groups[af].begin() + g, group);
+      }
+
+      nxMaskAddr(pr.prefix.ip.addr, pr.prefix.maskLen, range.addr);
+      memset(range.lens, 0, sizeof(range.lens));
+      for (unsigned int len = pr.ge; len <= pr.le; len++) {
+         range.lens[len / 64] |= 1ULL << (len % 64);
+      }
+      m_groups[af][g].ranges.push_back(range);
+   }
+
+   // Sort, then merge the ranges of the same prefix.
+   for (int af = AF_START; af < MAX_AF; af++) {
+      for (size_t g = 0; g < m_groups[af].size(); g++) {
+         std::vector<Range>& ranges = m_groups[af][g].ranges;
+         size_t              n = 0;
+
+         std::sort(ranges.begin(), ranges.end());
+         for (size_t i = 0; i < ranges.size(); i++) {
+            if (n && !memcmp(ranges[n - 1].addr, ranges[i].addr,
+                             sizeof(ranges[i].addr))) {
+               for (int w = 0; w < 3; w++) ranges[n - 1].lens[w] |= ranges[i].lens[w];
+            } else {
+               ranges[n++] = ranges[i];
+            }
+         }
+         ranges.resize(n);
+      }
+   }
+}
+
+bool
+NxL3RouteMatcher::matchPrefix(const NxPrefix& prefix) const
+{
+   const std::vector<LenGroup>& groups = m_groups[prefix.ip.af];
+   uint64_t                     bit = 1ULL << (prefix.maskLen % 64);
+   unsigned int                 word = prefix.maskLen / 64;
+   Range                        key;
+
+   for (size_t g = 0; g < groups.size(); g++) {
+      const std::vector<Range>& ranges = groups[g].ranges;
+
+      if (groups[g].maskLen > prefix.maskLen) break;
+
+      nxMaskAddr(prefix.ip.addr, groups[g].maskLen, key.addr);
+      std::vector<Range>::const_iterator it =
+         std::lower_bound(ranges.begin(), ranges.end(), key);
+      if ((it != ranges.end()) &&
+          !memcmp(it->addr, key.addr, sizeof(key.addr)) &&
+          (it->lens[word] & bit)) {
+         return true;
+      }
+   }
+   return false;
+}
+
+bool
+NxL3RouteMatcher::matchNextHops(const NxL3RouteMsg& msg) const
+{
+   for (unsigned int i = 0; i < msg.nhCount; i++) {
+      const NxL3RouteMsgNh& nh = msg.nextHops[i];
+
+      if ((nh.preference <= m_maxPreference) && (nh.metric <= m_maxMetric) &&
+          (m_nhIntfName.empty() || (m_nhIntfName == nh.intfName))) {
+         return true;
+      }
+   }
+   return false;
+}
+
+bool
+NxL3RouteMatcher::match(const NxL3RouteMsg& msg) const
+{
+   if ((msg.prefix.ip.af >= MAX_AF) ||
+       (msg.prefix.maskLen > msg.prefix.ip.addrBits())) {
+      return false;
+   }
+   if (!m_anyPrefix && !matchPrefix(msg.prefix)) return false;
+   return m_anyNextHop || matchNextHops(msg);
+}
\ No newline at end of file
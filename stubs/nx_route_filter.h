@@ -0,0 +1,88 @@
+/** **********************************************************************
+    * Compiled NxL3RouteFilter applied to the raw route updates from RIB
+    * before an NxL3Route is built.
+    *
+    * Prefix ranges are grouped by the mask length of their prefix. Each
+    * group is a sorted array of the masked prefixes with a bitmap of the
+    * route mask lengths they accept, ranges of the same prefix are merged
+    * into one entry. A route is matched by masking it to each group length
+    * up to its own and doing a binary search, so the cost depends on the
+    * number of distinct lengths & not on the number of ranges.
+    *
+    * Copyright (c) 2017 by cisco Systems, Inc.
+    *
+    * All rights reserved.
+************************************************************************/
+#ifndef __nx_route_filter_H__
+#define __nx_route_filter_H__
+
+#include <stdint.h>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "nx_rib_mgr.h"
+
+namespace nxos {
+
+/*
+ * Next-hop of a raw route update from RIB.
+ */
+struct NxL3RouteMsgNh {
+    NxIpAddr                ip;
+    const char             *intfName;  // "" for recursive
+    uint32_t                preference;
+    uint32_t                metric;
+    NxL3NextHop::nh_types_e type;
+};
+
+/*
+ * Raw route update from RIB. Strings are owned by the message buffer.
+ */
+struct NxL3RouteMsg {
+    NxPrefix                prefix;
+    const char             *vrfName;
+    const char             *protocol;
+    const char             *tag;
+    event_type_e            event;
+    const NxL3RouteMsgNh   *nextHops;
+    unsigned int            nhCount;
+};
+
+class NxL3RouteMatcher {
+public:
+    explicit NxL3RouteMatcher(const NxL3RouteFilter &filter);
+
+    /* False if a prefix range of filter is out of the bounds of its
+     * address family, those are skipped when it is compiled. */
+    static bool valid(const NxL3RouteFilter &filter);
+
+    bool match(const NxL3RouteMsg &msg) const;
+
+private:
+    struct Range {
+        unsigned char addr[16];
+        uint64_t      lens[3];  // bit n set: routes of mask length n
+
+        bool operator<(const Range &range) const {
+            return memcmp(addr, range.addr, sizeof(addr)) < 0;
+        }
+    };
+
+    struct LenGroup {
+        unsigned int       maskLen;
+        std::vector<Range> ranges;  // sorted by addr
+    };
+
+    bool matchPrefix(const NxPrefix &prefix) const;
+    bool matchNextHops(const NxL3RouteMsg &msg) const;
+
+    bool                  m_anyPrefix;
+    std::vector<LenGroup> m_groups[MAX_AF];  // by ascending maskLen
+    bool                  m_anyNextHop;
+    std::string           m_nhIntfName;
+    uint32_t              m_maxPreference;
+    uint32_t              m_maxMetric;
+};
+
+}
+#endif // __nx_route_filter_H__